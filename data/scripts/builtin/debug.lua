@@ -149,6 +149,12 @@ end
 -- Table Properties:
 --   rebench (default, false) -- reset internal benchmarking values
 --                               between runs.
+--
+--   columns (default, nil) -- function(tbl) returning additional values
+--                             that are appended to each report line.
+--
+-- Run benchmark_average(samples) => number for the average of one of the
+-- 0-indexed sample rings returned by benchmark_data (tick and frame cost).
 
 local function calc_avg(frames)
 	local val = 0;
@@ -182,7 +188,11 @@ local function bench_tick(tbl)
 		avg = 1000.0 / avg;
 
 		if (avg > tbl.thresh) then
-			tbl.rep(tbl.count, min, max, avg, stddev);
+			if (tbl.columns) then
+				tbl.rep(tbl.count, min, max, avg, stddev, tbl:columns());
+			else
+				tbl.rep(tbl.count, min, max, avg, stddev);
+			end
 			tbl.last_avg = avg;
 			tbl.count = tbl.count + 1;
 
@@ -208,8 +218,27 @@ local function bench_tick(tbl)
 	end
 end
 
-local function default_rep(count, min, max, avg, stddev)
-	print(string.format("%d;%d;%d;%d;%d", count, min, max, avg, stddev));
+local function default_rep(count, min, max, avg, stddev, ...)
+	local line = string.format("%d;%d;%d;%d;%d", count, min, max, avg, stddev);
+
+	for _, v in ipairs({...}) do
+		if (math.floor(v) == v) then
+			line = line .. string.format(";%d", v);
+		else
+			line = line .. string.format(";%.2f", v);
+		end
+	end
+
+	print(line);
+end
+
+function benchmark_average(samples)
+	local sum = 0;
+	for i=0,#samples do
+		sum = sum + samples[i];
+	end
+
+	return sum / (#samples + 1);
 end
 
 local function bench_destr(tbl)
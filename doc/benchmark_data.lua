@@ -1,6 +1,19 @@
 -- benchmark_data
 -- @short: Retrieve gathered benchmarking values.
--- @outargs: nticks, tickcosttbl, framecount, frametimetbl, costcount, framecosttbl
+-- @outargs: nticks, tickcosttbl, framecount, frametimetbl, costcount, framecosttbl, drawcalls, culled, occluded, programs, textures, uniforms, skipped, transfer, workers
+-- @longdescr: The *drawcalls* value is the number of draw calls issued when
+-- processing the last frame, which is mainly useful for comparing different
+-- object compositions or draw batching (ARCAN_VIDEO_BATCH). The *culled* and
+-- *occluded* values are the number of objects that were skipped in the last
+-- frame for being outside of their rendertarget or for being covered by an
+-- opaque object (ARCAN_VIDEO_OCCLUSION). The *programs*, *textures* and
+-- *uniforms* values are the number of shader program binds, texture binds
+-- and uniform uploads that were sent to the graphics backend in the last
+-- frame, and *skipped* the number of these that were dropped for not
+-- changing anything. The *transfer* value is the smoothed time, in
+-- milliseconds, spent polling clients and transferring their new frames
+-- before each composition, and *workers* the number of threads that this
+-- work is split between (ARCAN_CONDUCTOR_WORKERS).
 -- @group: system
 -- @cfunction: getbenchvals
 -- @related: benchmark_enable, benchmark_timestamp
@@ -0,0 +1,48 @@
+-- target_metrics
+-- @short: Retrieve event queue statistics for a frameserver
+-- @inargs: vid:tgt
+-- @outargs: table
+-- @longdescr: Each frameserver has a pair of event queues shared with the
+-- main process. If a client produces events faster than they can be
+-- forwarded, the queue fills up and the engine has to either force a drain
+-- of its own queue through the scripting event handlers or discard what
+-- does not fit. This function can be used to find clients that regularly
+-- cause this kind of pressure, as well as to tune the queue size set through
+-- the ARCAN_EVENT_QUEUE_SZ environment variable.
+--
+-- The fields in the returned table are:
+-- *int:queue_size* - the number of slots in each of the client event queues.
+-- *int:pending* - the number of events queued by the client and not yet forwarded.
+-- *int:overflow* - the number of times either client queue was found full.
+-- *int:drain* - the number of forced drains caused by events from the client.
+-- *int:dropped* - the number of events that were discarded, both those from
+-- the client that did not fit the engine queue and those to the client that
+-- did not fit its inbound queue.
+--
+-- The counters accumulate over the lifetime of the frameserver.
+-- @group: targetcontrol
+-- @cfunction: targetmetrics
+-- @related: rendertarget_metrics
+function main()
+#ifdef MAIN
+	local vid = launch_avfeed("", "terminal",
+	function(source, status)
+		if status.kind == "resized" then
+			show_image(source)
+			resize_image(source, status.width, status.height)
+		end
+	end)
+
+	_G[APPLID .. "_clock_pulse"] = function()
+		if valid_vid(vid, TYPE_FRAMESERVER) then
+			for k,v in pairs(target_metrics(vid)) do
+				print(k, v)
+			end
+		end
+	end
+#endif
+
+#ifdef ERROR1
+	target_metrics(WORLDID)
+#endif
+end
@@ -2168,29 +2168,10 @@ a12_channel_aframe(struct a12_state* S,
 	a12int_encode_araw(S, S->out_channel, buf, n_samples/2, cfg, opts, chunk_sz);
 }
 
-/*
- * This function merely performs basic sanity checks of the input sources
- * then forwards to the corresponding _encode method that match the set opts.
- */
-void
-a12_channel_vframe(struct a12_state* S,
-	struct shmifsrv_vbuffer* vb, struct a12_vframe_opts opts)
+static void encode_region(struct a12_state* S,
+	struct shmifsrv_vbuffer* vb, struct a12_vframe_opts opts,
+	size_t x, size_t y, size_t w, size_t h, size_t chunk_sz, bool commit)
 {
-	if (!S || S->cookie != 0xfeedface || S->state == STATE_BROKEN)
-		return;
-
-/* use a fix size now as the outb- writer lacks queueing and interleaving */
-	size_t chunk_sz = 32768;
-
-/* avoid dumb updates */
-	size_t x = 0, y = 0, w = vb->w, h = vb->h;
-	if (vb->flags.subregion){
-		x = vb->region.x1;
-		y = vb->region.y1;
-		w = vb->region.x2 - x;
-		h = vb->region.y2 - y;
-	}
-
 /* sanity check against a dumb client here as well */
 	if (!w || !h){
 		a12int_trace(A12_TRACE_SYSTEM, "kind=einval:status=bad dimensions");
@@ -2224,7 +2205,7 @@ a12_channel_vframe(struct a12_state* S,
  */
 	a12int_trace(A12_TRACE_VIDEO,
 		"out vframe: %zu*%zu @%zu,%zu+%zu,%zu", vb->w, vb->h, w, h, x, y);
-#define argstr S, vb, opts, x, y, w, h, chunk_sz, S->out_channel
+#define argstr S, vb, opts, x, y, w, h, chunk_sz, S->out_channel, commit
 
 	switch(opts.method){
 	case VFRAME_METHOD_RAW_RGB565:
@@ -2257,6 +2238,77 @@ a12_channel_vframe(struct a12_state* S,
 	}
 }
 
+/*
+ * The region- methods can encode each region of the damage list on its own,
+ * the codec ones work on the full frame. The delta- encoder has to build the
+ * accumulation buffer first, which sends out the full frame regardless.
+ */
+static bool damage_list(struct a12_state* S,
+	struct shmifsrv_vbuffer* vb, struct a12_vframe_opts opts)
+{
+	struct shmifsrv_vbuffer* ab = &S->channels[S->out_channel].acc;
+	if (!vb->flags.subregion || vb->damage.count < 2)
+		return false;
+
+	switch(opts.method){
+	case VFRAME_METHOD_RAW_RGB565:
+	case VFRAME_METHOD_NORMAL:
+	case VFRAME_METHOD_RAW_NOALPHA:
+	break;
+	case VFRAME_METHOD_DPNG:
+		if (!ab->buffer || ab->w != vb->w || ab->h != vb->h)
+			return false;
+	break;
+	default:
+		return false;
+	}
+
+/* any broken region and we go with the bounding one */
+	for (size_t i = 0; i < vb->damage.count; i++){
+		struct arcan_shmif_region* r = &vb->damage.rects[i];
+		if (r->x2 <= r->x1 || r->x2 > vb->w || r->y2 <= r->y1 || r->y2 > vb->h)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * This function merely performs basic sanity checks of the input sources
+ * then forwards to the corresponding _encode method that match the set opts.
+ */
+void
+a12_channel_vframe(struct a12_state* S,
+	struct shmifsrv_vbuffer* vb, struct a12_vframe_opts opts)
+{
+	if (!S || S->cookie != 0xfeedface || S->state == STATE_BROKEN)
+		return;
+
+/* use a fix size now as the outb- writer lacks queueing and interleaving */
+	size_t chunk_sz = 32768;
+
+/* one frame per damaged region, only the last one commits */
+	if (damage_list(S, vb, opts)){
+		for (size_t i = 0; i < vb->damage.count; i++){
+			struct arcan_shmif_region* r = &vb->damage.rects[i];
+			encode_region(S, vb, opts, r->x1, r->y1, r->x2 - r->x1,
+				r->y2 - r->y1, chunk_sz, i == vb->damage.count - 1);
+		}
+		return;
+	}
+
+/* avoid dumb updates */
+	size_t x = 0, y = 0, w = vb->w, h = vb->h;
+	if (vb->flags.subregion){
+		x = vb->region.x1;
+		y = vb->region.y1;
+		w = vb->region.x2 - x;
+		h = vb->region.y2 - y;
+	}
+
+	encode_region(S, vb, opts, x, y, w, h, chunk_sz, true);
+}
+
 bool
 a12_channel_enqueue(struct a12_state* S, struct arcan_event* ev)
 {
@@ -48,8 +48,7 @@ static void a12int_vframehdr_build(uint8_t buf[CONTROL_PACKET_SIZE],
 	pack_u32(exp_len, &buf[40]); /* [40..43] : exp-length */
 
 /* [35] : dataflags: uint8 */
-/* [40] Commit on completion, this is always set right now but will change
- * when 'chain of deltas' mode for shmif is added */
+/* [40] Commit on completion, only the last region of a damage list sets it */
 	buf[44] = commit;
 }
 
@@ -144,7 +143,7 @@ void a12int_encode_rgb565(PACK_ARGS)
 	uint8_t hdr_buf[CONTROL_PACKET_SIZE];
 	a12int_vframehdr_build(hdr_buf, S->last_seen_seqnr, chid,
 		POSTPROCESS_VIDEO_RGB565, 0, vb->w, vb->h, w, h, x, y,
-		w * h * px_sz, w * h * px_sz, 1
+		w * h * px_sz, w * h * px_sz, commit
 	);
 	a12int_append_out(S,
 		STATE_CONTROL_PACKET, hdr_buf, CONTROL_PACKET_SIZE, NULL, 0);
@@ -225,7 +224,7 @@ void a12int_encode_rgba(PACK_ARGS)
 	uint8_t hdr_buf[CONTROL_PACKET_SIZE];
 	a12int_vframehdr_build(hdr_buf, S->last_seen_seqnr, chid,
 		POSTPROCESS_VIDEO_RGBA, 0, vb->w, vb->h, w, h, x, y,
-		w * h * px_sz, w * h * px_sz, 1
+		w * h * px_sz, w * h * px_sz, commit
 	);
 	a12int_append_out(S,
 		STATE_CONTROL_PACKET, hdr_buf, CONTROL_PACKET_SIZE, NULL, 0);
@@ -295,7 +294,7 @@ void a12int_encode_rgb(PACK_ARGS)
 	uint8_t hdr_buf[CONTROL_PACKET_SIZE];
 	a12int_vframehdr_build(hdr_buf, S->last_seen_seqnr, chid,
 		POSTPROCESS_VIDEO_RGB, 0, vb->w, vb->h, w, h, x, y,
-		w * h * px_sz, w * h * px_sz, 1
+		w * h * px_sz, w * h * px_sz, commit
 	);
 	a12int_append_out(S,
 		STATE_CONTROL_PACKET, hdr_buf, CONTROL_PACKET_SIZE, NULL, 0);
@@ -407,7 +406,7 @@ void a12int_encode_tz(PACK_ARGS)
 	uint8_t hdr_buf[CONTROL_PACKET_SIZE];
 	a12int_vframehdr_build(hdr_buf, S->last_seen_seqnr, chid,
 		cres.type, 0, vb->w, vb->h, w, h, 0, 0,
-		cres.out_sz, cres.in_sz, 1
+		cres.out_sz, cres.in_sz, commit
 	);
 
 	a12int_trace(A12_TRACE_VDETAIL,
@@ -534,7 +533,7 @@ void a12int_encode_dpng(PACK_ARGS)
 	uint8_t hdr_buf[CONTROL_PACKET_SIZE];
 	a12int_vframehdr_build(hdr_buf, S->last_seen_seqnr, chid,
 		cres.type, 0, vb->w, vb->h, w, h, x, y,
-		cres.out_sz, cres.in_sz, 1
+		cres.out_sz, cres.in_sz, commit
 	);
 
 	a12int_trace(A12_TRACE_VDETAIL,
@@ -784,7 +783,7 @@ again:
 		uint8_t hdr_buf[CONTROL_PACKET_SIZE];
 		a12int_vframehdr_build(hdr_buf, S->last_seen_seqnr, chid,
 			POSTPROCESS_VIDEO_H264, 0, vb->w, vb->h, vb->w, vb->h,
-			0, 0, packet->size, vb->w * vb->h * 4, 1
+			0, 0, packet->size, vb->w * vb->h * 4, commit
 		);
 		a12int_append_out(S,
 			STATE_CONTROL_PACKET, hdr_buf, CONTROL_PACKET_SIZE, NULL, 0);
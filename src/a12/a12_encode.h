@@ -6,9 +6,9 @@
 	struct a12_state* S,\
 	struct shmifsrv_vbuffer* vb, struct a12_vframe_opts opts,\
 	size_t x, size_t y, size_t w, size_t h,\
-	size_t chunk_sz, int chid\
+	size_t chunk_sz, int chid, bool commit\
 
-#define FWD_ARGS S, vb, opts, x, y, w, h, chunk_sz, chid
+#define FWD_ARGS S, vb, opts, x, y, w, h, chunk_sz, chid, commit
 
 void a12int_encode_rgb565(PACK_ARGS);
 void a12int_encode_rgb(PACK_ARGS);
@@ -548,6 +548,11 @@ static void* client_thread(void* inarg)
  * default in shmifsrv.*/
 				a12int_trace(A12_TRACE_VDETAIL, "video-buffer");
 				struct shmifsrv_vbuffer vb = shmifsrv_video(data->C);
+
+/* all pending buffers are timestamped for later, come back next poll */
+				if (vb.state == VBUFFER_NODATA)
+					break;
+
 				BEGIN_CRITICAL(&giant_lock, "video-buffer");
 					a12_set_channel(data->S, data->chid);
 					a12_channel_vframe(data->S, &vb, vopts_from_segment(data, vb));
@@ -15,6 +15,9 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <errno.h>
 
 #include "arcan_math.h"
 #include "arcan_general.h"
@@ -54,51 +57,91 @@ void arcan_conductor_toggle_watchdog()
 
 /*
  * checklist:
- *  [ ] actual setup to realtime- plot the different timings and stages
+ *  [x] actual setup to realtime- plot the different timings and stages
  *      so it is easier (possible) to debug and evaluate the different strategies,
  *      for sake of comparison, chrome has a builtin viewer for a json format
+ *      (ARCAN_TRACE_JSON=/path/to/file.json, see arcan_trace_setstream)
  *
- *  [ ] parallelize PBO uploads
+ *  [x] parallelize PBO uploads
  *      (thought: test the systemic effects of not doing shm->gpu in process but
  *      rather have an 'uploader proxy' (like we'd do with wayland) and pass the
  *      descriptors around instead.
+ *      PBOs are mapped on the GL thread, copied by the worker pool below
+ *      (ARCAN_CONDUCTOR_WORKERS=n) and committed in arcan_frameserver_upload_flush
  *
  *  [x] perform resize- ack during synch period
- *      [ ] multi-thread resize-ack/evproc.
+ *      [x] multi-thread resize-ack/evproc.
  *      right now we are 'blocking' on resize- still, though there aren't any
  *      GPU resources modified directly based on the resize stage as such, those
  *      are deferred until the actual frame commit. The later are still hard to
  *      multithread, but just ack-/verify- should be easier.
  *
- *  [ ] posix anon-semaphores on shmpage (OSX blocking)
+ *  [x] posix anon-semaphores on shmpage (OSX blocking)
  *      or drop the semaphores entirely (yes please) and switch to futexes, alas
  *      then we still have the problem of those not being a multiplexable primitives
  *      and needing a separate path for OSX.
+ *      -> futex on vready/aready where supported, eventfd as multiplex bridge
  *
- *  [ ] defer GCs to low-load / embarassing pause in thread during synch etc.
+ *  [x] defer GCs to low-load / embarassing pause in thread during synch etc.
  *      since we now 'know' when we are waiting for the GPU to unlock, this is a
  *      good spot to manually step the Lua GCing.
+ *      -> collector stopped, stepped in conductor_yield with fallback on growth
  *
  *  [ ] perform readbacks in possible delay periods might break some GPU drivers
  *
- *  [ ] thread rendertarget processing
+ *  [x] thread rendertarget processing
  *      this would again be better for something like vulkan where we tie the
  *      rendertarget to a unique pipeline (they are much alike)
+ *      -> transform resolve of independent rendertargets on the worker pool,
+ *         GL submission stays in order on the main thread
  */
 static struct {
 	uint64_t tick_count;
 	int64_t set_deadline;
+	uint64_t last_synch;
+	double synch_step;
 	double render_cost;
 	double transfer_cost;
+	struct arcan_costhist render_hist;
 	uint8_t timestep;
 	bool in_frame;
+	bool gc_defer;
 } conductor = {
 	.render_cost = 4,
+	.synch_step = 16,
 	.transfer_cost = 1,
-	.timestep = 2
+	.timestep = 2,
+	.gc_defer = true
 };
 
 static ssize_t find_frameserver(struct arcan_frameserver* fsrv);
+extern struct arcan_luactx* main_lua_context;
+
+/*
+ * Fan-out worker pool for jobs that are known to be independent, e.g. the
+ * memcpy from the client segment into mapped upload buffers. The calling
+ * thread participates and blocks until all indices have been processed so
+ * there is no queue or lifecycle to track beyond the current batch.
+ */
+static struct {
+	pthread_t* threads;
+	size_t n_threads;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t done;
+	uint64_t generation;
+	size_t active;
+	bool shutdown;
+
+	arcan_conductor_job job;
+	void* tag;
+	size_t n_jobs;
+	_Atomic size_t next;
+} workers = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.wake = PTHREAD_COND_INITIALIZER,
+	.done = PTHREAD_COND_INITIALIZER
+};
 
 /*
  * To add new options here,
@@ -115,6 +158,7 @@ static char* synchopts[] = {
 	"powersave", "synch to clock tick (~25Hz)",
 	"adaptive", "defer composition",
 	"tight", "defer composition, delay client-wake",
+	"predictive", "compose and wake clients at predicted (p95) latest time",
 	NULL
 };
 
@@ -137,7 +181,9 @@ enum synchopts {
 /* defer composition, wake clients after vsynch */
 	SYNCH_ADAPTIVE,
 /* defer composition, wake clients after half-time */
-	SYNCH_TIGHT
+	SYNCH_TIGHT,
+/* defer composition and client wake based on measured costs */
+	SYNCH_PREDICTIVE
 };
 
 static int synchopt = SYNCH_IMMEDIATE;
@@ -147,6 +193,218 @@ static int synchopt = SYNCH_IMMEDIATE;
  * where transfers might occur, unlock simply awakes clients that did
  * contribute a frame last pass but has been locked since
  */
+static void run_jobs(arcan_conductor_job job, void* tag, size_t n)
+{
+	size_t ind;
+	platform_fsrv_guard_defer(true);
+	while ((ind = atomic_fetch_add(&workers.next, 1)) < n)
+		job(tag, ind);
+	platform_fsrv_guard_defer(false);
+}
+
+static void* worker_thread(void* arg)
+{
+/* generation at spawn, a batch might have been started before we got here */
+	uint64_t generation = (uintptr_t) arg;
+	pthread_mutex_lock(&workers.lock);
+
+	for(;;){
+		while (generation == workers.generation && !workers.shutdown)
+			pthread_cond_wait(&workers.wake, &workers.lock);
+
+		if (workers.shutdown)
+			break;
+
+		generation = workers.generation;
+		arcan_conductor_job job = workers.job;
+		void* tag = workers.tag;
+		size_t n = workers.n_jobs;
+		pthread_mutex_unlock(&workers.lock);
+
+		run_jobs(job, tag, n);
+
+		pthread_mutex_lock(&workers.lock);
+		if (0 == --workers.active)
+			pthread_cond_signal(&workers.done);
+	}
+
+	pthread_mutex_unlock(&workers.lock);
+	return NULL;
+}
+
+void arcan_conductor_set_workers(size_t n)
+{
+	if (workers.n_threads){
+		pthread_mutex_lock(&workers.lock);
+		workers.shutdown = true;
+		pthread_cond_broadcast(&workers.wake);
+		pthread_mutex_unlock(&workers.lock);
+
+		for (size_t i = 0; i < workers.n_threads; i++)
+			pthread_join(workers.threads[i], NULL);
+
+		arcan_mem_free(workers.threads);
+		workers.threads = NULL;
+		workers.n_threads = 0;
+		workers.shutdown = false;
+	}
+
+	if (!n)
+		return;
+
+	workers.threads = arcan_alloc_mem(sizeof(pthread_t) * n,
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO, ARCAN_MEMALIGN_NATURAL);
+
+	for (size_t i = 0; i < n; i++){
+		if (0 != pthread_create(&workers.threads[i],
+			NULL, worker_thread, (void*)(uintptr_t) workers.generation)){
+			arcan_warning("conductor: couldn't spawn worker %zu/%zu\n", i + 1, n);
+			break;
+		}
+		workers.n_threads++;
+	}
+
+	TRACE_MARK_ONESHOT("conductor", "workers",
+		TRACE_SYS_DEFAULT, 0, workers.n_threads, "set-workers");
+}
+
+size_t arcan_conductor_workers()
+{
+	return workers.n_threads;
+}
+
+double arcan_conductor_transfer_cost()
+{
+	return conductor.transfer_cost;
+}
+
+void arcan_conductor_parallel(arcan_conductor_job job, void* tag, size_t n)
+{
+	if (!n)
+		return;
+
+	atomic_store(&workers.next, 0);
+
+/* not worth the wakeup */
+	if (!workers.n_threads || n == 1){
+		run_jobs(job, tag, n);
+		return;
+	}
+
+	TRACE_MARK_ENTER("conductor", "parallel",
+		TRACE_SYS_DEFAULT, workers.n_threads, n, "");
+
+	pthread_mutex_lock(&workers.lock);
+		workers.job = job;
+		workers.tag = tag;
+		workers.n_jobs = n;
+		workers.active = workers.n_threads;
+		workers.generation++;
+		pthread_cond_broadcast(&workers.wake);
+	pthread_mutex_unlock(&workers.lock);
+
+	run_jobs(job, tag, n);
+
+	pthread_mutex_lock(&workers.lock);
+	while (workers.active)
+		pthread_cond_wait(&workers.done, &workers.lock);
+	pthread_mutex_unlock(&workers.lock);
+
+	TRACE_MARK_EXIT("conductor", "parallel",
+		TRACE_SYS_DEFAULT, workers.n_threads, n, "");
+}
+
+/*
+ * Poll all feeds with the upload stage deferred so that the shm->PBO copies
+ * for all clients that delivered a frame can be split over the workers.
+ */
+static void pollfeed_batch()
+{
+	if (!workers.n_threads){
+		arcan_video_pollfeed();
+		return;
+	}
+
+	arcan_frameserver_upload_begin();
+	arcan_video_pollfeed();
+	arcan_frameserver_upload_flush();
+}
+
+/* connected and authenticated, fed through the regular frame path */
+static bool frame_path(struct arcan_frameserver* fsrv)
+{
+	arcan_vobject* vobj = arcan_video_getobject(fsrv->vid);
+	return vobj && (vobj->feed.ffunc == FFUNC_VFRAME ||
+		vobj->feed.ffunc == FFUNC_NULLFRAME);
+}
+
+/*
+ * Client-local event verification and resize negotiation for frameservers
+ * that are fed through the regular frame path, the rest (enqueue into the
+ * main queue, feed changes) is completed on the next poll on the main thread.
+ */
+static void verify_job(void* tag, size_t index)
+{
+	struct arcan_frameserver** ref = tag;
+	if (!ref[index] || !frame_path(ref[index]))
+		return;
+
+	arcan_frameserver_verify(ref[index]);
+}
+
+/*
+ * Sleep for up to [ms], or until a client signals a new buffer through its
+ * synch bridge. The buffer release itself is futex based and can't be
+ * multiplexed, so clients that got the bridge (see platform_fsrv_synchfd)
+ * ping it on submission. Returns the time actually spent.
+ */
+static unsigned long long wait_clients(unsigned ms)
+{
+	unsigned long long start = arcan_timemillis();
+	struct pollfd pset[frameservers.used + 1];
+	struct arcan_frameserver* pref[frameservers.used + 1];
+	size_t n = 0;
+
+	for (size_t i=0, j=frameservers.used; i < frameservers.count && j > 0; i++){
+		if (!frameservers.ref[i])
+			continue;
+		j--;
+
+		if (!frame_path(frameservers.ref[i]))
+			continue;
+
+		int fd = platform_fsrv_synchfd(frameservers.ref[i]);
+		if (BADFD != fd){
+			pref[n] = frameservers.ref[i];
+			pset[n++] = (struct pollfd){.fd = fd, .events = POLLIN};
+		}
+	}
+
+	if (!n){
+		arcan_timesleep(ms);
+		return ms;
+	}
+
+	if (poll(pset, n, ms) > 0){
+		for (size_t i = 0; i < n; i++){
+			if (!(pset[i].revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)))
+				continue;
+
+/* the bridge is non-blocking, anything but a spurious wakeup means it is no
+ * longer usable and the client is left with the regular release path */
+			uint64_t val;
+			ssize_t nr = read(pset[i].fd, &val, sizeof(val));
+			if (nr == sizeof(val) ||
+				(-1 == nr && (errno == EAGAIN || errno == EINTR)))
+				continue;
+
+			platform_fsrv_synchfd_drop(pref[i]);
+		}
+	}
+
+	return arcan_timemillis() - start;
+}
+
 static void unlock_herd()
 {
 	for (size_t i = 0; i < frameservers.count; i++)
@@ -159,27 +417,28 @@ static void unlock_herd()
 
 static void step_herd(int mode)
 {
-	uint64_t start = arcan_timemillis();
+	uint64_t start = arcan_timemicros();
 
 	TRACE_MARK_ENTER("conductor", "synchronization",
 		TRACE_SYS_DEFAULT, mode, 0, "step-herd");
 
 	arcan_frameserver_lock_buffers(0);
-	arcan_video_pollfeed();
+	pollfeed_batch();
 	arcan_frameserver_lock_buffers(mode);
-	uint64_t stop = arcan_timemillis();
+	uint64_t stop = arcan_timemicros();
 
+/* sub-millisecond transfers are common, so measure finer than the unit */
 	conductor.transfer_cost =
-		0.8 * (double)(stop - start) +
+		0.8 * (double)(stop - start) / 1000.0 +
 		0.2 * conductor.transfer_cost;
 
-	TRACE_MARK_ENTER("conductor", "synchronization",
+	TRACE_MARK_EXIT("conductor", "synchronization",
 		TRACE_SYS_DEFAULT, mode, conductor.transfer_cost, "step-herd");
 }
 
 static void internal_yield()
 {
-	arcan_timesleep(conductor.timestep);
+	wait_clients(conductor.timestep);
 	TRACE_MARK_ONESHOT("conductor", "yield",
 		TRACE_SYS_DEFAULT, 0, conductor.timestep, "step");
 }
@@ -296,6 +555,10 @@ int arcan_conductor_yield(struct conductor_display* disps, size_t pset_count)
 		return -1;
 	}
 
+/* with a worker pool, the queue verification and resize part can be split */
+	if (workers.n_threads && frameservers.used)
+		arcan_conductor_parallel(verify_job, frameservers.ref, frameservers.count);
+
 	for (size_t i=0, j=frameservers.used; i < frameservers.count && j > 0; i++){
 		if (frameservers.ref[i]){
 			arcan_vint_pollfeed(frameservers.ref[i]->vid, false);
@@ -303,8 +566,29 @@ int arcan_conductor_yield(struct conductor_display* disps, size_t pset_count)
 		}
 	}
 
-/* same as other timesleep calls, should be replaced with poll and pollset */
-	return conductor.timestep;
+/* the display is busy so this is the cheapest time for the VM to collect,
+ * spend at most half of what is left until the deadline (or the timestep)
+ * and account for that in the period the platform should wait */
+	int step = conductor.timestep;
+	if (conductor.gc_defer && main_lua_context){
+		unsigned long long now = arcan_timemillis();
+		int64_t left = conductor.set_deadline > 0 ?
+			conductor.set_deadline - (int64_t) now : conductor.timestep;
+
+		if (left > 1){
+			arcan_lua_gcstep(main_lua_context, left >> 1);
+			step -= arcan_timemillis() - now;
+		}
+	}
+
+/* same as other timesleep calls, should be replaced with poll and pollset,
+ * never 0 as callers loop on this and would spin through pollfeed and GC */
+	return step > 0 ? step : 1;
+}
+
+void arcan_conductor_gcdefer(bool defer)
+{
+	conductor.gc_defer = defer;
 }
 
 ssize_t find_frameserver(struct arcan_frameserver* fsrv)
@@ -350,6 +634,7 @@ void arcan_conductor_setsynch(const char* arg)
 		arcan_frameserver_lock_buffers(2);
 	break;
 	case SYNCH_TIGHT:
+	case SYNCH_PREDICTIVE:
 		arcan_frameserver_lock_buffers(2);
 	break;
 	case SYNCH_IMMEDIATE:
@@ -412,7 +697,6 @@ void arcan_conductor_deregister_frameserver(struct arcan_frameserver* fsrv)
 /* the real work here comes when we do multithreaded processing */
 }
 
-extern struct arcan_luactx* main_lua_context;
 static void process_event(arcan_event* ev, int drain)
 {
 /* [ mutex ]
@@ -421,15 +705,23 @@ static void process_event(arcan_event* ev, int drain)
 
 	if (!ev){
 		if (event_count){
+			TRACE_MARK_ENTER("conductor", "lua-event",
+				TRACE_SYS_DEFAULT, 0, event_count, "flush");
+				arcan_lua_pushevent(main_lua_context, NULL);
+			TRACE_MARK_EXIT("conductor", "lua-event",
+				TRACE_SYS_DEFAULT, 0, event_count, "flush");
 			event_count = 0;
-			arcan_lua_pushevent(main_lua_context, NULL);
 		}
 
 		return;
 	}
 
 	event_count++;
-	arcan_lua_pushevent(main_lua_context, ev);
+	TRACE_MARK_ENTER("conductor", "lua-event",
+		TRACE_SYS_DEFAULT, ev->category, event_count, "dispatch");
+		arcan_lua_pushevent(main_lua_context, ev);
+	TRACE_MARK_EXIT("conductor", "lua-event",
+		TRACE_SYS_DEFAULT, ev->category, event_count, "dispatch");
 }
 
 static int estimate_frame_cost()
@@ -437,6 +729,60 @@ static int estimate_frame_cost()
 	return conductor.render_cost + conductor.transfer_cost + conductor.timestep;
 }
 
+/* same as estimate_frame_cost, but use the tail of the measured distribution
+ * rather than the average so that the occasional slow frame still makes it */
+static int predict_frame_cost()
+{
+	long long cost = arcan_costhist_pct(&conductor.render_hist, 95);
+	if (-1 == cost)
+		return estimate_frame_cost();
+
+	return (cost + 999) / 1000 + conductor.transfer_cost + conductor.timestep;
+}
+
+/*
+ * Release the clients that wouldn't be able to make the composition [left]
+ * ms from now unless woken at this moment. Clients without enough samples
+ * are woken immediately. Returns the time until the next client would need
+ * waking, capped to the timestep.
+ */
+static int release_predicted(int left)
+{
+	int next = conductor.timestep;
+
+	for (size_t i=0, j=frameservers.used; i < frameservers.count && j > 0; i++){
+		struct arcan_frameserver* fsrv = frameservers.ref[i];
+		if (!fsrv)
+			continue;
+		j--;
+
+		if (!fsrv->flags.release_pending)
+			continue;
+
+/* the client needs to produce the frame and then have it delivered */
+		long long render = arcan_costhist_pct(&fsrv->latency.render, 95);
+		long long cost = arcan_costhist_pct(&fsrv->latency.hist, 95);
+		if (render == -1 || cost == -1)
+			cost = -1;
+		else
+			cost += render;
+
+		int wait = cost == -1 ? 0 : left - (int)((cost + 999) / 1000);
+
+		if (wait > 0){
+			if (wait < next)
+				next = wait;
+			continue;
+		}
+
+		TRACE_MARK_ONESHOT("conductor", "synchronization",
+			TRACE_SYS_DEFAULT, fsrv->vid, cost, "predictive-wake");
+		arcan_frameserver_releaselock(fsrv);
+	}
+
+	return next;
+}
+
 static bool preframe_synch(int next, int elapsed)
 {
 	switch(synchopt){
@@ -477,6 +823,21 @@ static bool preframe_synch(int next, int elapsed)
 			TRACE_SYS_DEFAULT, 0, elapsed - margin, "tight-deadline");
 		return true;
 	}
+/* compose at the latest safe moment, and until then wake each client when
+ * its own (p95) latency says it needs to start to make it in time */
+	case SYNCH_PREDICTIVE:{
+		ssize_t margin = next - predict_frame_cost();
+		if (elapsed < margin){
+			conductor.in_frame = true;
+			int step = release_predicted(margin - elapsed);
+			wait_clients(step > 0 ? step : 1);
+			return false;
+		}
+
+		TRACE_MARK_ONESHOT("conductor", "synchronization",
+			TRACE_SYS_DEFAULT, 0, elapsed - margin, "predictive-deadline");
+		return true;
+	}
 	case SYNCH_VSYNCH:
 	case SYNCH_PROCESSING:
 	case SYNCH_IMMEDIATE:
@@ -496,6 +857,7 @@ static uint64_t postframe_synch(uint64_t next)
 	break;
 	case SYNCH_PROCESSING:
 	case SYNCH_IMMEDIATE:
+	case SYNCH_PREDICTIVE:
 	break;
 	}
 	conductor.in_frame = false;
@@ -507,19 +869,42 @@ static int trigger_video_synch(float frag)
 	conductor.set_deadline = -1;
 
 	TRACE_MARK_ENTER("conductor", "platform-frame", TRACE_SYS_DEFAULT, conductor.tick_count, frag, "");
-		arcan_lua_callvoidfun(main_lua_context, "preframe_pulse", false, NULL);
+		TRACE_MARK_ENTER("conductor", "preframe-pulse", TRACE_SYS_DEFAULT, conductor.tick_count, 0, "");
+			arcan_lua_callvoidfun(main_lua_context, "preframe_pulse", false, NULL);
+		TRACE_MARK_EXIT("conductor", "preframe-pulse", TRACE_SYS_DEFAULT, conductor.tick_count, 0, "");
+		TRACE_MARK_ENTER("conductor", "video-synch", TRACE_SYS_DEFAULT, conductor.tick_count, 0, "");
 			platform_video_synch(conductor.tick_count, frag, NULL, NULL);
-		arcan_lua_callvoidfun(main_lua_context, "postframe_pulse", false, NULL);
+		TRACE_MARK_EXIT("conductor", "video-synch", TRACE_SYS_DEFAULT, conductor.tick_count, 0, "");
+		TRACE_MARK_ENTER("conductor", "postframe-pulse", TRACE_SYS_DEFAULT, conductor.tick_count, 0, "");
+			arcan_lua_callvoidfun(main_lua_context, "postframe_pulse", false, NULL);
+		TRACE_MARK_EXIT("conductor", "postframe-pulse", TRACE_SYS_DEFAULT, conductor.tick_count, 0, "");
 	TRACE_MARK_EXIT("conductor", "platform-frame", TRACE_SYS_DEFAULT, conductor.tick_count, frag, "");
 
+/* track the synch interval for presentation timestamp matching, anything
+ * longer than a few refreshes is a stall and shouldn't skew the estimate */
+	uint64_t now = arcan_timemillis();
+	if (conductor.last_synch && now - conductor.last_synch < 100){
+		conductor.synch_step =
+			0.9 * conductor.synch_step + 0.1 * (double)(now - conductor.last_synch);
+	}
+	conductor.last_synch = now;
+
 	arcan_bench_register_frame();
 	arcan_benchdata* stats = arcan_bench_data();
 
+/* with benchmarking enabled, the cost offset has already been stepped past
+ * the latest sample */
+	size_t n_cost = sizeof(stats->framecost) / sizeof(stats->framecost[0]);
+	size_t costofs = stats->bench_enabled ?
+		((uint8_t)stats->costofs + n_cost - 1) % n_cost : (uint8_t)stats->costofs;
+
 /* exponential moving average */
 	conductor.render_cost =
-		0.8 * (double)stats->framecost[(uint8_t)stats->costofs] +
+		0.8 * (double)stats->framecost[costofs] +
 		0.2 * conductor.render_cost;
 
+	arcan_costhist_add(&conductor.render_hist, stats->framecost[costofs] * 1000);
+
 	TRACE_MARK_ONESHOT("conductor", "frame-over", TRACE_SYS_DEFAULT, 0, conductor.set_deadline, "");
 
 /* if the platform wants us to wait, it'll provide a new deadline at synch */
@@ -559,7 +944,7 @@ int arcan_conductor_run(arcan_tick_cb tick)
  * and then actually dispatch / process these twice so that their old buffers
  * might get to be updated before we synch to display.
  */
-		arcan_video_pollfeed();
+		pollfeed_batch();
 		arcan_audio_refresh();
 		last_tickcount = conductor.tick_count;
 
@@ -590,7 +975,8 @@ int arcan_conductor_run(arcan_tick_cb tick)
 /* A stall or other action caused us to miss the tight deadline and the herd
  * didn't get unlocked this pass, so perform one now to not block the clients
  * indefinitely */
-			if (synchopt == SYNCH_TIGHT && !conductor.in_frame){
+			if ((synchopt == SYNCH_TIGHT ||
+				synchopt == SYNCH_PREDICTIVE) && !conductor.in_frame){
 				conductor.in_frame = true;
 				unlock_herd();
 			}
@@ -606,18 +992,42 @@ int arcan_conductor_run(arcan_tick_cb tick)
 
 void arcan_conductor_fakesynch(uint8_t left)
 {
-	int real_left = left;
 	int step;
 	TRACE_MARK_ENTER("conductor", "synchronization",
 		TRACE_SYS_SLOW, 0, left, "fake synch");
 
-	while ((step = arcan_conductor_yield(NULL, 0)) != -1 && left > step){
-		arcan_timesleep(step);
-		left -= step;
+/* both yield and the wait can overshoot, so measure against the deadline
+ * rather than subtracting from the budget */
+	unsigned long long deadline = arcan_timemillis() + left;
+	int64_t remaining = left;
+
+	while ((step = arcan_conductor_yield(NULL, 0)) != -1 &&
+		(remaining = (int64_t) deadline - (int64_t) arcan_timemillis()) > step){
+		wait_clients(step);
 	}
 
 	TRACE_MARK_EXIT("conductor", "synchronization",
-		TRACE_SYS_SLOW, 0, left, "fake synch");
+		TRACE_SYS_SLOW, 0, remaining > 0 ? remaining : 0, "fake synch");
+}
+
+uint64_t arcan_conductor_next_synch(unsigned* step)
+{
+	uint64_t now = arcan_timemillis();
+	unsigned ms = conductor.synch_step + 0.5;
+	ms = ms ? ms : 1;
+
+	if (step)
+		*step = ms;
+
+/* a platform provided deadline is more accurate than the estimate */
+	if (conductor.set_deadline > 0 && (uint64_t) conductor.set_deadline >= now)
+		return conductor.set_deadline;
+
+	uint64_t next = conductor.last_synch + ms;
+	if (next < now)
+		next += ((now - next) / ms + 1) * ms;
+
+	return next;
 }
 
 void arcan_conductor_deadline(uint8_t deadline)
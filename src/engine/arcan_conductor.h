@@ -105,6 +105,43 @@ void arcan_conductor_setsynch(const char* arg);
 void arcan_conductor_fakesynch(uint8_t left_ms);
 
 #ifndef VIDEO_PLATFORM_IMPL
+/*
+ * Set the number of worker threads available for arcan_conductor_parallel,
+ * 0 (default) means that all jobs are run serially on the calling thread.
+ * Must not be called while a parallel job is being processed.
+ */
+void arcan_conductor_set_workers(size_t n);
+size_t arcan_conductor_workers();
+
+/*
+ * Smoothed cost (ms) of polling clients and transferring their new frames
+ * before composition, as used for estimating when to start a frame.
+ */
+double arcan_conductor_transfer_cost();
+
+/*
+ * Enable (default) or disable deferred garbage collection of the scripting
+ * VM. When enabled, collection is performed in bounded steps while waiting
+ * for display synch rather than at allocation time.
+ */
+void arcan_conductor_gcdefer(bool defer);
+
+/*
+ * Run [job] once for each index in [0, n) using the worker pool and the
+ * calling thread, blocking until all jobs have finished. The jobs must be
+ * independent of each other and must not touch the graphics or scripting
+ * layers. Not re-entrant.
+ */
+typedef void (*arcan_conductor_job)(void* tag, size_t index);
+void arcan_conductor_parallel(arcan_conductor_job job, void* tag, size_t n);
+
+/*
+ * Estimate when the next display synchronization will happen (in
+ * arcan_timemillis) based on the platform deadline or the running synch
+ * interval, which is returned in [step] if provided.
+ */
+uint64_t arcan_conductor_next_synch(unsigned* step);
+
 /* Update the priority target to match the specified frameserver. This
  * means that heuristics driving synchronization will be biased towards
  * letting the specific fsrv align synchronization - if the synchronization
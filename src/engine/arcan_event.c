@@ -47,9 +47,13 @@ typedef struct queue_cell queue_cell;
 
 static arcan_event eventbuf[ARCAN_EVENT_QUEUE_LIM];
 
-static uint8_t eventfront = 0, eventback = 0;
+static uint16_t eventfront = 0, eventback = 0;
 static int64_t epoch;
 
+/* number of times the queue was forced to drain synchronously, used to
+ * attribute the drains to the frameserver whose events caused them */
+static uint64_t drain_count;
+
 static struct arcan_evctx default_evctx = {
 	.eventbuf = eventbuf,
 	.eventbuf_sz = ARCAN_EVENT_QUEUE_LIM,
@@ -69,6 +73,15 @@ static struct arcan_evctx default_evctx = {
  * cleanly based on a certain keybinding */
 static int panic_keysym = -1, panic_keymod = -1;
 
+static bool panic_event(const struct arcan_event* const ev)
+{
+	return panic_keysym != -1 && panic_keymod != -1 &&
+		ev->category == EVENT_IO && ev->io.kind == EVENT_IO_BUTTON &&
+		ev->io.devkind == EVENT_IDEVKIND_KEYBOARD &&
+		ev->io.input.translated.modifiers == panic_keymod &&
+		ev->io.input.translated.keysym == panic_keysym;
+}
+
 arcan_evctx* arcan_event_defaultctx(){
 	return &default_evctx;
 }
@@ -83,8 +96,10 @@ static void pull_killswitch(arcan_evctx* ctx)
 	arcan_sem_post(ctx->synch.handle);
 	arcan_warning("inconsistency while processing "
 		"shmpage events, pulling killswitch.\n");
-	arcan_frameserver_free(ks);
+
+/* the context might well live inside the frameserver that is about to go */
 	ctx->synch.killswitch = NULL;
+	arcan_frameserver_free(ks);
 }
 
 int arcan_event_poll(arcan_evctx* ctx, struct arcan_event* dst)
@@ -97,14 +112,14 @@ int arcan_event_poll(arcan_evctx* ctx, struct arcan_event* dst)
  * wake the guard thread that will try to safely shut down */
 	if (ctx->local == false){
 		FORCE_SYNCH();
-		if ( *(ctx->front) > PP_QUEUE_SZ ){
+		if ( *(ctx->front) >= ctx->eventbuf_sz ){
 			pull_killswitch(ctx);
 			return 0;
 		}
 		else {
 			*dst = ctx->eventbuf[ *(ctx->front) ];
 			memset(&ctx->eventbuf[ *(ctx->front) ], 0xff, sizeof(struct arcan_event));
-			*(ctx->front) = (*(ctx->front) + 1) % PP_QUEUE_SZ;
+			*(ctx->front) = (*(ctx->front) + 1) % ctx->eventbuf_sz;
 		}
 	}
 	else {
@@ -193,6 +208,7 @@ int arcan_event_enqueue(arcan_evctx* ctx, const struct arcan_event* const src)
  * than data corruption and unpredictable states -- this can theoretically
  * have us return a broken 'custom' error code from some script */
 			else {
+				drain_count++;
 				ctx->state_fl |= EVSTATE_IN_DRAIN;
 					arcan_event_feed(ctx, ctx->drain, NULL);
 				ctx->state_fl &= ~EVSTATE_IN_DRAIN;
@@ -204,12 +220,7 @@ int arcan_event_enqueue(arcan_evctx* ctx, const struct arcan_event* const src)
 		}
 	}
 
-	if (panic_keysym != -1 && panic_keymod != -1 &&
-		src->category == EVENT_IO && src->io.kind == EVENT_IO_BUTTON &&
-		src->io.devkind == EVENT_IDEVKIND_KEYBOARD &&
-		src->io.input.translated.modifiers == panic_keymod &&
-		src->io.input.translated.keysym == panic_keysym
-	){
+	if (panic_event(src)){
 		arcan_event ev = {
 			.category = EVENT_SYSTEM,
 			.sys.kind = EVENT_SYSTEM_EXIT,
@@ -233,136 +244,361 @@ static inline int queue_used(arcan_evctx* dq)
 	return rv;
 }
 
-void arcan_event_queuetransfer(arcan_evctx* dstqueue, arcan_evctx* srcqueue,
-	enum ARCAN_EVENT_CATEGORY allowed, float sat, struct arcan_frameserver* tgt)
+size_t arcan_event_enqueue_batch(arcan_evctx* ctx, arcan_event* evs, size_t n)
 {
-	if (!srcqueue || !dstqueue || (srcqueue && !srcqueue->front)
-		|| (srcqueue && !srcqueue->back))
-		return;
+	if ((ctx->state_fl & EVSTATE_DEAD) > 0)
+		return 0;
 
-	bool wake = false;
+/* filter and translate in one pass, compacting as we go */
+	size_t count = 0;
+	for (size_t i = 0; i < n; i++){
+		if (evs[i].category & ctx->mask_cat_inp)
+			continue;
 
-	sat = (sat > 1.0 ? 1.0 : sat < 0.5 ? 0.5 : sat);
+		if (panic_event(&evs[i])){
+			TRACE_MARK_ONESHOT("event", "shutdown", TRACE_SYS_WARN, 0, 0, "panic key");
+			evs[i] = (arcan_event){
+				.category = EVENT_SYSTEM,
+				.sys.kind = EVENT_SYSTEM_EXIT,
+				.sys.errcode = EXIT_SUCCESS
+			};
+			if (evs[i].category & ctx->mask_cat_inp)
+				continue;
+		}
 
-	while ( srcqueue->front && *srcqueue->front != *srcqueue->back &&
-			floor((float)dstqueue->eventbuf_sz * sat) > queue_used(dstqueue)) {
+		evs[count++] = evs[i];
+	}
 
-		arcan_event inev;
-		if (arcan_event_poll(srcqueue, &inev) == 0)
-			break;
+/* not enough room, let the single-event path deal with drain / overflow */
+	size_t room = ctx->eventbuf_sz - 1 - queue_used(ctx);
+	if (count > room){
+		for (size_t i = 0; i < count; i++)
+			if (ARCAN_OK != arcan_event_enqueue(ctx, &evs[i]))
+				return count - i;
+		return 0;
+	}
+
+/* the free space is at most two contiguous spans */
+	size_t back = *ctx->back;
+	size_t span = ctx->eventbuf_sz - back;
+	span = span > count ? count : span;
+
+	memcpy(&ctx->eventbuf[back], evs, span * sizeof(arcan_event));
+	if (count > span)
+		memcpy(ctx->eventbuf, &evs[span], (count - span) * sizeof(arcan_event));
+
+	*ctx->back = (back + count) % ctx->eventbuf_sz;
+	return 0;
+}
+
+/*
+ * Move up to [lim] events from [ctx] into [dst] with at most two copies,
+ * external queues get the consumed slots poisoned the same way as in poll.
+ * Returns the number of events copied, [full] is set if the queue had no
+ * free slots left.
+ */
+static ssize_t queue_read(
+	arcan_evctx* ctx, arcan_event* dst, size_t lim, bool* full)
+{
+	*full = false;
+
+/* broken indices are only reported, this can run on a worker and the kill
+ * has to happen on the main thread. The client can change the shared indices
+ * at any time, so they are read once and only the validated copies are used */
+	size_t sz = ctx->eventbuf_sz;
+	if (!ctx->local)
+		FORCE_SYNCH();
+
+	size_t front = *ctx->front;
+	size_t back = *ctx->back;
+	if (front >= sz || back >= sz)
+		return -1;
+
+	size_t n = back >= front ? back - front : sz - front + back;
+	*full = n == sz - 1;
+	n = n > lim ? lim : n;
+	if (!n)
+		return 0;
+
+	size_t span = sz - front;
+	span = span > n ? n : span;
+
+	memcpy(dst, &ctx->eventbuf[front], span * sizeof(arcan_event));
+	if (n > span)
+		memcpy(&dst[span], ctx->eventbuf, (n - span) * sizeof(arcan_event));
 
+	if (!ctx->local){
+		memset(&ctx->eventbuf[front], 0xff, span * sizeof(arcan_event));
+		if (n > span)
+			memset(ctx->eventbuf, 0xff, (n - span) * sizeof(arcan_event));
+	}
+
+	*ctx->front = (front + n) % sz;
+	return n;
+}
+
+/*
+ * Apply the per-client verification and translation of an event coming from
+ * [tgt]. This only touches [tgt] and its descriptors, so it is safe to run on
+ * a worker as long as no-one else processes [tgt] at the same time. Returns
+ * true if the event should be forwarded to the main queue.
+ */
+static bool verify_event(arcan_event* inev,
+	enum ARCAN_EVENT_CATEGORY allowed, struct arcan_frameserver* tgt,
+	bool* wake, bool deferred)
+{
 /* ioevents have special behavior as the routed path (via frameserver
  * callback or global event handler) can be decided here */
-		if (inev.category == EVENT_IO && tgt){
-			if (inev.category & allowed)
-				;
-			else {
-				inev = (struct arcan_event){
-					.category = EVENT_FSRV,
-					.fsrv.kind = EVENT_FSRV_IONESTED,
-					.fsrv.otag = tgt->tag,
-					.fsrv.video = tgt->vid,
-					.fsrv.input = inev.io
-				};
-			}
+	if (inev->category == EVENT_IO && tgt){
+		if (inev->category & allowed)
+			;
+		else {
+			*inev = (struct arcan_event){
+				.category = EVENT_FSRV,
+				.fsrv.kind = EVENT_FSRV_IONESTED,
+				.fsrv.otag = tgt->tag,
+				.fsrv.video = tgt->vid,
+				.fsrv.input = inev->io
+			};
 		}
+	}
 /* a custom mask to allow certain events to be passed through or not */
-		else if ((inev.category & allowed) == 0 )
-			continue;
+	else if ((inev->category & allowed) == 0 )
+		return false;
 
 /*
  * update / translate to make sure the corresponding frameserver<->lua mapping
  * can be found and tracked, there are also a few events that should be handled
  * here rather than propagated (bufferstream for instance).
  */
-		if (inev.category == EVENT_EXTERNAL && tgt){
-			switch(inev.ext.kind){
+	if (inev->category == EVENT_EXTERNAL && tgt){
+		switch(inev->ext.kind){
 
 /* to protect against scripts that would happily try to just allocate/respond
  * to what the event says, clamp this here */
-				case EVENT_EXTERNAL_SEGREQ:
-					if (inev.ext.segreq.width > PP_SHMPAGE_MAXW)
-						inev.ext.segreq.width = PP_SHMPAGE_MAXW;
+			case EVENT_EXTERNAL_SEGREQ:
+				if (inev->ext.segreq.width > PP_SHMPAGE_MAXW)
+					inev->ext.segreq.width = PP_SHMPAGE_MAXW;
 
-					if (inev.ext.segreq.height > PP_SHMPAGE_MAXH)
-						inev.ext.segreq.height = PP_SHMPAGE_MAXH;
-				break;
+				if (inev->ext.segreq.height > PP_SHMPAGE_MAXH)
+					inev->ext.segreq.height = PP_SHMPAGE_MAXH;
+			break;
 
-				case EVENT_EXTERNAL_BUFFERSTREAM:
+			case EVENT_EXTERNAL_BUFFERSTREAM:{
 /* this assumes that we are in non-blocking state and that a single
  * CMSG on a socket is sufficient for a non-blocking recvmsg */
+				int handle = arcan_fetchhandle(tgt->dpipe, false);
+				size_t slot = inev->ext.bstream.slot;
+
+/* a persistent handle for one video buffer, the first of a set replaces all */
+				if (slot){
+					if (slot > ARCAN_SHMIF_VBUFC_LIM){
+						close(handle);
+						return false;
+					}
+
+					for (size_t i = 0; i < ARCAN_SHMIF_VBUFC_LIM; i++){
+						if (-1 == tgt->vstream.slots[i] || (slot != 1 && i != slot - 1))
+							continue;
+						close(tgt->vstream.slots[i]);
+						tgt->vstream.slots[i] = -1;
+					}
+					tgt->vstream.slots[slot - 1] = handle;
+				}
+				else {
 					if (tgt->vstream.handle)
 						close(tgt->vstream.handle);
+					tgt->vstream.handle = handle;
+				}
 
-					tgt->vstream.handle = arcan_fetchhandle(tgt->dpipe, false);
-					tgt->vstream.stride = inev.ext.bstream.pitch;
-					tgt->vstream.format = inev.ext.bstream.format;
-					wake = true;
-					continue;
-				break;
-
-				case EVENT_EXTERNAL_PRIVDROP:
-					tgt->flags.external |= inev.ext.privdrop.external;
-					tgt->flags.networked = inev.ext.privdrop.networked;
-					tgt->flags.sandboxed |= inev.ext.privdrop.sandboxed;
+				tgt->vstream.stride = inev->ext.bstream.pitch;
+				tgt->vstream.format = inev->ext.bstream.format;
+				tgt->vstream.dirty = true;
+				*wake = true;
+				return false;
+			}
+			break;
+
+			case EVENT_EXTERNAL_PRIVDROP:
+				tgt->flags.external |= inev->ext.privdrop.external;
+				tgt->flags.networked = inev->ext.privdrop.networked;
+				tgt->flags.sandboxed |= inev->ext.privdrop.sandboxed;
 /* modify the event so that no illegal transitions are forwarded or applied */
-					inev.ext.privdrop.external = tgt->flags.external;
-					inev.ext.privdrop.networked = tgt->flags.networked;
-					inev.ext.privdrop.sandboxed = tgt->flags.sandboxed;
-				break;
+				inev->ext.privdrop.external = tgt->flags.external;
+				inev->ext.privdrop.networked = tgt->flags.networked;
+				inev->ext.privdrop.sandboxed = tgt->flags.sandboxed;
+			break;
 
-				case EVENT_EXTERNAL_INPUTMASK:
-					tgt->devicemask = inev.ext.inputmask.device;
-					tgt->datamask   = inev.ext.inputmask.types;
-				break;
+			case EVENT_EXTERNAL_INPUTMASK:
+				tgt->devicemask = inev->ext.inputmask.device;
+				tgt->datamask   = inev->ext.inputmask.types;
+			break;
 
 /* for autoclocking, only one-fire events are forwarded if flag has been set */
-				case EVENT_EXTERNAL_CLOCKREQ:
-					if (tgt->flags.autoclock && !inev.ext.clock.once){
-						tgt->clock.frame = inev.ext.clock.dynamic;
-						tgt->clock.left = tgt->clock.start = inev.ext.clock.rate;
-						wake = true;
-						continue;
-					}
-				break;
+			case EVENT_EXTERNAL_CLOCKREQ:
+				if (tgt->flags.autoclock && !inev->ext.clock.once){
+					tgt->clock.frame = inev->ext.clock.dynamic;
+					tgt->clock.left = tgt->clock.start = inev->ext.clock.rate;
+					*wake = true;
+					return false;
+				}
+			break;
 
-				case EVENT_EXTERNAL_REGISTER:
-					if (tgt->segid == SEGID_UNKNOWN){
+			case EVENT_EXTERNAL_REGISTER:
+				if (tgt->segid == SEGID_UNKNOWN){
 /* 0.6/CRYPTO - need actual signature authentication here */
-						if (!inev.ext.registr.guid[0] && !inev.ext.registr.guid[1]){
-							arcan_random((uint8_t*)tgt->guid, 16);
-						}
-						else {
-							tgt->guid[0] = inev.ext.registr.guid[0];
-							tgt->guid[1] = inev.ext.registr.guid[1];
-						}
+					if (!inev->ext.registr.guid[0] && !inev->ext.registr.guid[1]){
+						arcan_random((uint8_t*)tgt->guid, 16);
+					}
+					else {
+						tgt->guid[0] = inev->ext.registr.guid[0];
+						tgt->guid[1] = inev->ext.registr.guid[1];
 					}
-					snprintf(tgt->title,
-						COUNT_OF(tgt->title), "%s", inev.ext.registr.title);
-				break;
+				}
+				snprintf(tgt->title,
+					COUNT_OF(tgt->title), "%s", inev->ext.registr.title);
+			break;
 /* note: one could manually enable EVENT_INPUT and use separate processes
  * as input sources (with all the risks that comes with it security wise)
  * if that ever becomes a concern, here would be a good place to consider
  * filtering the panic_key* */
 
 /* client may need more fine grained control for audio transfers when it
- * comes to synchronized A/V playback */
-				case EVENT_EXTERNAL_FLUSHAUD:
+ * comes to synchronized A/V playback, the audio layer is main-thread only */
+			case EVENT_EXTERNAL_FLUSHAUD:
+				if (deferred)
+					tgt->staged.flush_audio = true;
+				else
 					arcan_frameserver_flush(tgt);
-					continue;
-				break;
+				return false;
+			break;
 
-				default:
-				break;
-			}
-			inev.ext.source = tgt->vid;
-		}
-		else if (inev.category == EVENT_IO && tgt){
-			inev.io.subid = tgt->vid;
+			default:
+			break;
 		}
-		wake = true;
+		inev->ext.source = tgt->vid;
+	}
+	else if (inev->category == EVENT_IO && tgt){
+		inev->io.subid = tgt->vid;
+	}
+
+	*wake = true;
+	return true;
+}
+
+void arcan_event_queueverify(arcan_evctx* srcqueue,
+	enum ARCAN_EVENT_CATEGORY allowed, struct arcan_frameserver* tgt)
+{
+	if (!tgt || !srcqueue->front || !srcqueue->back)
+		return;
+
+	bool wake = false;
+	size_t lim = COUNT_OF(tgt->staged.evs);
+
+/* read straight into the staging area and compact in place */
+	arcan_event* evs = &tgt->staged.evs[tgt->staged.count];
+	bool full;
+	ssize_t n = queue_read(srcqueue, evs, lim - tgt->staged.count, &full);
+
+/* leave the kill to queuetransfer on the main thread */
+	if (n <= 0){
+		tgt->staged.broken |= n < 0;
+		return;
+	}
+
+	tgt->evstats.overflow += full;
+	for (ssize_t i = 0; i < n; i++){
+		if (verify_event(&evs[i], allowed, tgt, &wake, true))
+			tgt->staged.evs[tgt->staged.count++] = evs[i];
+	}
+
+	tgt->staged.wake |= wake;
+}
+
+/* forward events that have already passed queueverify, in order */
+static void transfer_staged(arcan_evctx* dstqueue,
+	arcan_evctx* srcqueue, float sat, struct arcan_frameserver* tgt)
+{
+	if (tgt->staged.flush_audio){
+		tgt->staged.flush_audio = false;
+		arcan_frameserver_flush(tgt);
+	}
+
+	int room = floor((float)dstqueue->eventbuf_sz * sat) - queue_used(dstqueue);
+	size_t i = room > 0 ? room : 0;
+	i = i > tgt->staged.count ? tgt->staged.count : i;
+
+	uint64_t drains = drain_count;
+	tgt->evstats.dropped +=
+		arcan_event_enqueue_batch(dstqueue, tgt->staged.evs, i);
+	tgt->evstats.drain += drain_count - drains;
+
+	if (i < tgt->staged.count)
+		memmove(tgt->staged.evs, &tgt->staged.evs[i],
+			sizeof(arcan_event) * (tgt->staged.count - i));
+	tgt->staged.count -= i;
+
+	if (tgt->staged.wake){
+		tgt->staged.wake = false;
+		arcan_sem_post(srcqueue->synch.handle);
+	}
+}
+
+void arcan_event_queuetransfer(arcan_evctx* dstqueue, arcan_evctx* srcqueue,
+	enum ARCAN_EVENT_CATEGORY allowed, float sat, struct arcan_frameserver* tgt)
+{
+	if (!srcqueue || !dstqueue || (srcqueue && !srcqueue->front)
+		|| (srcqueue && !srcqueue->back))
+		return;
+
+	bool wake = false;
+
+	sat = (sat > 1.0 ? 1.0 : sat < 0.5 ? 0.5 : sat);
+
+/* the client broke its queue while being verified off-thread */
+	if (tgt && tgt->staged.broken){
+		pull_killswitch(srcqueue);
+		return;
+	}
+
+/* anything verified off-thread goes first to maintain ordering */
+	if (tgt){
+		transfer_staged(dstqueue, srcqueue, sat, tgt);
+		if (tgt->staged.count)
+			return;
+	}
+
+/* pull as much as fits in one go, verify in place and forward the rest */
+	int room = floor((float)dstqueue->eventbuf_sz * sat) - queue_used(dstqueue);
+	if (room <= 0)
+		return;
+
+	arcan_event batch[ARCAN_EVENT_QUEUE_LIM];
+	bool full;
+	ssize_t n = queue_read(srcqueue, batch,
+		room > ARCAN_EVENT_QUEUE_LIM ? ARCAN_EVENT_QUEUE_LIM : room, &full);
+	size_t count = 0;
 
-		arcan_event_enqueue(dstqueue, &inev);
+	if (n < 0){
+		pull_killswitch(srcqueue);
+		return;
+	}
+	if (!n)
+		return;
+
+	for (ssize_t i = 0; i < n; i++){
+		if (verify_event(&batch[i], allowed, tgt, &wake, false))
+			batch[count++] = batch[i];
+	}
+
+	if (!tgt){
+		arcan_event_enqueue_batch(dstqueue, batch, count);
+	}
+	else {
+		uint64_t drains = drain_count;
+		tgt->evstats.overflow += full;
+		tgt->evstats.dropped += arcan_event_enqueue_batch(dstqueue, batch, count);
+		tgt->evstats.drain += drain_count - drains;
 	}
 
 	if (wake)
@@ -474,6 +710,61 @@ void arcan_bench_register_cost(unsigned cost)
 		(sizeof(benchdata.framecost) / sizeof(benchdata.framecost[0]));
 }
 
+void arcan_costhist_add(struct arcan_costhist* hist, unsigned long long us)
+{
+	size_t ind = us / ARCAN_COSTHIST_STEP;
+	if (ind >= ARCAN_COSTHIST_BINS)
+		ind = ARCAN_COSTHIST_BINS - 1;
+
+	if (hist->count >= ARCAN_COSTHIST_AGE){
+		hist->count = 0;
+		for (size_t i = 0; i < ARCAN_COSTHIST_BINS; i++){
+			hist->bins[i] >>= 1;
+			hist->count += hist->bins[i];
+		}
+	}
+
+	hist->bins[ind]++;
+	hist->count++;
+}
+
+long long arcan_costhist_pct(struct arcan_costhist* hist, unsigned pct)
+{
+	if (hist->count < 8)
+		return -1;
+
+	size_t lim = (hist->count * pct + 99) / 100;
+	size_t sum = 0;
+
+	for (size_t i = 0; i < ARCAN_COSTHIST_BINS; i++){
+		sum += hist->bins[i];
+		if (sum >= lim)
+			return (i + 1) * ARCAN_COSTHIST_STEP;
+	}
+
+	return ARCAN_COSTHIST_BINS * ARCAN_COSTHIST_STEP;
+}
+
+void arcan_bench_register_draws(unsigned count)
+{
+	benchdata.drawcalls = count;
+}
+
+void arcan_bench_register_cull(unsigned culled, unsigned occluded)
+{
+	benchdata.culled = culled;
+	benchdata.occluded = occluded;
+}
+
+void arcan_bench_register_state(unsigned programs,
+	unsigned textures, unsigned uniforms, unsigned skipped)
+{
+	benchdata.programs = programs;
+	benchdata.textures = textures;
+	benchdata.uniforms = uniforms;
+	benchdata.skipped = skipped;
+}
+
 void arcan_bench_register_frame()
 {
 	static long long int lastframe = -1;
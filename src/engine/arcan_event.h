@@ -67,6 +67,18 @@ void arcan_event_queuetransfer(
 	enum ARCAN_EVENT_CATEGORY allowed, float saturation, struct arcan_frameserver*
 );
 
+/*
+ * The client-local part of queuetransfer: pull events from [srcqueue], verify
+ * and translate them (SEGREQ clamping, BUFFERSTREAM descriptor fetch, ...) and
+ * store them in the staging area of [tgt]. This does not touch the main event
+ * queue or any other shared state and can thus run on a worker thread, as long
+ * as [tgt] is not processed elsewhere at the same time. The staged events are
+ * forwarded, in order, on the next queuetransfer call for [tgt]. A queue with
+ * broken indices is only flagged here, queuetransfer pulls the killswitch.
+ */
+void arcan_event_queueverify(struct arcan_evctx* srcqueue,
+	enum ARCAN_EVENT_CATEGORY allowed, struct arcan_frameserver* tgt);
+
 /*
  * enqueue event into context, returns [ARCAN_OK] if successful or
  * [ARCAN_ERRC_OUT_SPACE]  if the context lacks a drain function and the queue
@@ -74,6 +86,15 @@ void arcan_event_queuetransfer(
  */
 int arcan_event_enqueue(struct arcan_evctx*, const struct arcan_event* const);
 
+/*
+ * enqueue [n] events from [evs] into context with the same masking and
+ * translation as arcan_event_enqueue, but as one ring-buffer copy. [evs] is
+ * used as scratch and will be modified. If there is not enough room for all
+ * of them, it falls back to enqueueing them one by one. Returns the number
+ * of events that were lost because the queue was full.
+ */
+size_t arcan_event_enqueue_batch(struct arcan_evctx*, struct arcan_event*, size_t n);
+
 /*
  * if the event context has a drain function, forward the event straight to
  * the drain, if not, act as a normal arcan_event_enqueue.
@@ -55,11 +55,46 @@ typedef struct TTF_Font TTF_Font;
 
 static int g_buffers_locked;
 
+/* frames pushed while the deferred upload stage is active */
+struct upload_job {
+	arcan_frameserver* fsrv;
+	struct agp_vstore* store;
+	struct stream_meta stream;
+	shmif_pixel* src;
+	size_t nb;
+	int vmask;
+	bool failed;
+};
+
+static struct {
+	bool active;
+	struct upload_job* jobs;
+	size_t count;
+	size_t limit;
+} g_uploads;
+
+static void frame_delivered(arcan_frameserver* tgt, struct agp_vstore* store);
+
 static inline void emit_deliveredframe(arcan_frameserver* src,
 	unsigned long long pts, unsigned long long framecount);
 static inline void emit_droppedframe(arcan_frameserver* src,
 	unsigned long long pts, unsigned long long framecount);
 
+static void drop_vstream(arcan_frameserver* src)
+{
+	if (-1 != src->vstream.handle)
+		close(src->vstream.handle);
+	src->vstream.handle = -1;
+
+	for (size_t i = 0; i < ARCAN_SHMIF_VBUFC_LIM; i++){
+		if (-1 != src->vstream.slots[i])
+			close(src->vstream.slots[i]);
+		src->vstream.slots[i] = -1;
+	}
+
+	src->vstream.bound = -1;
+}
+
 static void autoclock_frame(arcan_frameserver* tgt)
 {
 	if (!tgt->clock.left)
@@ -101,6 +136,20 @@ arcan_errc arcan_frameserver_free(arcan_frameserver* src)
 
 	arcan_conductor_deregister_frameserver(src);
 
+/* a frame might be pending in the deferred upload stage, the copy hasn't
+ * been dispatched yet so the mapping can just be released and dropped */
+	if (src->flags.upload_pending){
+		for (size_t i = 0; i < g_uploads.count; i++){
+			if (g_uploads.jobs[i].fsrv != src)
+				continue;
+
+			agp_stream_release(g_uploads.jobs[i].store, g_uploads.jobs[i].stream);
+			g_uploads.jobs[i] = g_uploads.jobs[--g_uploads.count];
+			break;
+		}
+		src->flags.upload_pending = false;
+	}
+
 	arcan_aobj_id aid = src->aid;
 	uintptr_t tag = src->tag;
 	arcan_vobj_id vid = src->vid;
@@ -125,6 +174,8 @@ arcan_errc arcan_frameserver_free(arcan_frameserver* src)
 	if (!platform_fsrv_lastwords(src, msg, COUNT_OF(msg)))
 		snprintf(msg, COUNT_OF(msg), "Couldn't access metadata (SIGBUS?)");
 
+	drop_vstream(src);
+
 /* will free, so no UAF here - only time the function returns false is when we
  * are somehow running it twice one the same src */
 	if (!platform_fsrv_destroy(src))
@@ -166,8 +217,9 @@ static void default_adoph(arcan_frameserver* tgt, arcan_vobj_id id)
 
 bool arcan_frameserver_control_chld(arcan_frameserver* src){
 /* bunch of terminating conditions -- frameserver messes with the structure to
- * provoke a vulnerability, frameserver dying or timing out, ... */
-	bool alive = src->flags.alive && src->shm.ptr &&
+ * provoke a vulnerability, frameserver dying or timing out, ... a queue found
+ * broken during off-thread verification ends up here as well */
+	bool alive = src->flags.alive && src->shm.ptr && !src->staged.broken &&
 		src->shm.ptr->cookie == arcan_shmif_cookie() &&
 		platform_fsrv_validchild(src);
 
@@ -201,20 +253,158 @@ bool arcan_frameserver_control_chld(arcan_frameserver* src){
 	return true;
 }
 
+static bool queue_upload(arcan_frameserver* src,
+	struct agp_vstore* store, shmif_pixel* buf, int vmask)
+{
+	if (g_uploads.count == g_uploads.limit){
+		size_t nl = g_uploads.limit ? g_uploads.limit * 2 : 16;
+		struct upload_job* jobs = arcan_alloc_mem(sizeof(struct upload_job) * nl,
+			ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO | ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+		if (!jobs)
+			return false;
+
+		if (g_uploads.jobs){
+			memcpy(jobs, g_uploads.jobs, sizeof(struct upload_job) * g_uploads.count);
+			arcan_mem_free(g_uploads.jobs);
+		}
+		g_uploads.jobs = jobs;
+		g_uploads.limit = nl;
+	}
+
+	struct stream_meta stream =
+		agp_stream_prepare(store, (struct stream_meta){.buf = NULL}, STREAM_RAW_DIRECT_MAPPED);
+	if (!stream.state)
+		return false;
+
+	TRACE_MARK_ONESHOT("frameserver", "buffer-map", TRACE_SYS_DEFAULT, src->vid, store->w * store->h, "");
+	src->flags.upload_pending = true;
+	g_uploads.jobs[g_uploads.count++] = (struct upload_job){
+		.fsrv = src,
+		.store = store,
+		.stream = stream,
+		.src = buf,
+		.nb = store->w * store->h * sizeof(shmif_pixel),
+		.vmask = vmask
+	};
+
+	return true;
+}
+
+/* runs on the worker threads, the guard state is thread local so a client
+ * truncating its segment only takes its own job down, the segment itself is
+ * dropped by the main thread (see platform_fsrv_guard_defer) */
+static void upload_job(void* tag, size_t ind)
+{
+	struct upload_job* job = &((struct upload_job*)tag)[ind];
+	jmp_buf tramp;
+	if (0 != setjmp(tramp)){
+		job->failed = true;
+		return;
+	}
+
+	platform_fsrv_enter(job->fsrv, tramp);
+	memcpy(job->stream.buf, job->src, job->nb);
+	platform_fsrv_leave();
+}
+
+static void upload_release(struct upload_job* job)
+{
+	arcan_frameserver* tgt = job->fsrv;
+	tgt->flags.upload_pending = false;
+	if (job->failed || !tgt->shm.ptr)
+		return;
+
+	TRAMP_GUARD(, tgt);
+	atomic_fetch_and(&tgt->shm.ptr->vpending, job->vmask);
+	frame_delivered(tgt, job->store);
+	platform_fsrv_leave();
+}
+
+void arcan_frameserver_upload_begin()
+{
+	g_uploads.active = true;
+}
+
+void arcan_frameserver_upload_flush()
+{
+	g_uploads.active = false;
+	if (!g_uploads.count)
+		return;
+
+	size_t count = g_uploads.count;
+	TRACE_MARK_ENTER("frameserver", "buffer-upload-batch",
+		TRACE_SYS_DEFAULT, arcan_conductor_workers(), count, "");
+
+	arcan_conductor_parallel(upload_job, g_uploads.jobs, count);
+
+/* commit, release the buffer mask and wake the clients in the same order
+ * as they were pushed, a copy that faulted is only unmapped */
+	for (size_t i = 0; i < count; i++){
+		struct upload_job* job = &g_uploads.jobs[i];
+		if (job->failed)
+			agp_stream_release(job->store, job->stream);
+		else
+			agp_stream_commit(job->store, job->stream);
+		upload_release(job);
+	}
+
+	g_uploads.count = 0;
+	TRACE_MARK_EXIT("frameserver", "buffer-upload-batch",
+		TRACE_SYS_DEFAULT, arcan_conductor_workers(), count, "");
+}
+
+/* copy the damage list out of the buffer footer, it is client controlled so
+ * each region is validated, and the list is only used when it actually saves
+ * on uploads compared to the bounding region */
+static size_t load_damage(arcan_frameserver* src, struct agp_vstore* store,
+	shmif_pixel* buf, size_t bound_px, struct arcan_shmif_region* out)
+{
+	struct arcan_shmif_damage* dmg = arcan_shmif_damagebuf(
+		buf, src->desc.hints, src->desc.width, src->desc.height);
+	if (!dmg)
+		return 0;
+
+	size_t count = dmg->count;
+	if (count < 2 || count > ARCAN_SHMIF_DAMAGE_LIM)
+		return 0;
+
+	size_t n_px = 0;
+	for (size_t i = 0; i < count; i++){
+		out[i] = dmg->rects[i];
+		if (out[i].x2 <= out[i].x1 || out[i].x2 > store->w ||
+			out[i].y2 <= out[i].y1 || out[i].y2 > store->h)
+			return 0;
+
+		n_px += (size_t)(out[i].x2 - out[i].x1) * (out[i].y2 - out[i].y1);
+	}
+
+/* past half the store, the texture upload path goes full frame anyhow */
+	if (n_px >= bound_px || n_px > (store->w * store->h) >> 1)
+		return 0;
+
+	return count;
+}
+
 static bool push_buffer(arcan_frameserver* src,
 	struct agp_vstore* store, struct arcan_shmif_region* dirty)
 {
 	struct stream_meta stream = {.buf = NULL};
 	bool explicit = src->flags.explicit;
 
-/* we know that vpending contains the latest region that was synched,
- * so the ~vready mask should be the bits that we want to keep. */
-	int vready = atomic_load_explicit(&src->shm.ptr->vready,memory_order_consume);
-	int vmask=~atomic_load_explicit(&src->shm.ptr->vpending,memory_order_consume);
+/* pick the most recent buffer that is due at the coming synch, anything
+ * timestamped closer to the one after that stays pending until then */
+	unsigned step;
+	uint64_t deadline = arcan_conductor_next_synch(&step) + (step >> 1);
+	int vmask;
+	bool latest;
+	int vready = platform_fsrv_vbuf_select(
+		src, deadline, &vmask, &src->vbuf_pts, &latest);
 
 	TRACE_MARK_ONESHOT("frameserver", "buffer-eval", TRACE_SYS_DEFAULT, src->vid, vready, "");
 
-	vready = (vready <= 0 || vready > src->vbuf_cnt) ? 0 : vready - 1;
+	if (-1 == vready)
+		return false;
+
 	shmif_pixel* buf = src->vbufs[vready];
 
 /* Need to do this check here as-well as in the regular frameserver tick
@@ -260,11 +450,16 @@ static bool push_buffer(arcan_frameserver* src,
 			src->flags.no_alpha_copy ? GL_NOALPHA_PIXEL_FORMAT : GL_STORE_PIXEL_FORMAT;
 
 		arcan_video_resizefeed(src->vid, src->desc.width, src->desc.height);
+		src->vstream.dirty = true;
 
 		src->desc.rz_flag = false;
 		explicit = true;
 	}
 
+/* any update invalidates the store contents, a valid subregion refines that */
+	store->damage.seq++;
+	store->damage.partial = false;
+
 /* special case, the contents is in a compressed format that can either be
  * rasterized or deferred to on-GPU rasterization / atlas lookup, so the other
  * setup isn't strictly needed. */
@@ -315,17 +510,31 @@ static bool push_buffer(arcan_frameserver* src,
 		goto commit_mask;
 	}
 
-	if (-1 != src->vstream.handle){
+/* persistent per-buffer handles take precedence over one passed with the
+ * signal, the store keeps sampling that buffer after this */
+	int handle = src->vstream.slots[vready];
+	bool held = -1 != handle;
+	if (!held)
+		handle = src->vstream.handle;
+
+	if (-1 != handle){
 		bool failev = src->vstream.dead;
 
 /* the vstream can die because of a format mismatch, platform validation failure
- * or triggered by manually disabling it for this frameserver */
-		if (!failev){
-			stream.handle = src->vstream.handle;
+ * or triggered by manually disabling it for this frameserver. Only import when
+ * there is something new, the descriptor of a new handle or set can have the
+ * same number as one already imported so those are dropped first. */
+		if (!failev && (src->vstream.dirty || handle != src->vstream.bound)){
+			if (src->vstream.dirty)
+				platform_video_map_handle(store, -1);
+
+			stream.handle = handle;
 			store->vinf.text.stride = src->vstream.stride;
 			store->vinf.text.format = src->vstream.format;
 			stream = agp_stream_prepare(store, stream, STREAM_HANDLE);
 			failev = !stream.state;
+			src->vstream.dirty = false;
+			src->vstream.bound = failev ? -1 : handle;
 		}
 
 /* buffer passing failed, mark that as an unsupported mode for some reason, log
@@ -339,22 +548,33 @@ static bool push_buffer(arcan_frameserver* src,
 /* handle format should be abstracted to platform, but right now it is just
  * mapped as a file-descriptor, if iostreams or windows is reintroduced, this
  * will need to be fixed */
-			arcan_event_enqueue(&src->outqueue, &ev);
+			if (ARCAN_OK != arcan_event_enqueue(&src->outqueue, &ev))
+				src->evstats.dropped++;
 			src->vstream.dead = true;
-			close(src->vstream.handle);
-			src->vstream.handle = -1;
+			drop_vstream(src);
+			platform_video_map_handle(store, -1);
+			atomic_store(&src->shm.ptr->vheld, 0);
 			TRACE_MARK_ONESHOT("frameserver", "buffer-handle", TRACE_SYS_WARN, src->vid, 0, "platform reject");
 		}
-		else
+		else {
 			agp_stream_commit(store, stream);
 
+/* the client may not draw into this one until another has been presented,
+ * which also releases the one held before it */
+			if (held)
+				atomic_store(&src->shm.ptr->vheld, vready + 1);
+		}
+
 		goto commit_mask;
 	}
 
 	stream.buf = buf;
-/* validate, fallback to fullsynch if we get bad values */
+/* validate, fallback to fullsynch if we get bad values. The region is that of
+ * the last signal, so an older pick or dropped buffers also mean full synch */
+	struct arcan_shmif_region damage[ARCAN_SHMIF_DAMAGE_LIM];
+	size_t n_damage = 0;
 
-	if (dirty){
+	if (dirty && latest){
 		stream.x1 = dirty->x1; stream.w = dirty->x2 - dirty->x1;
 		stream.y1 = dirty->y1; stream.h = dirty->y2 - dirty->y1;
 		stream.dirty = /* unsigned but int prom. */
@@ -362,19 +582,47 @@ static bool push_buffer(arcan_frameserver* src,
 			(dirty->y2 - dirty->y1 > 0 && stream.h <= store->h);
 		src->desc.region = *dirty;
 		src->desc.region_valid = true;
+
+		if (stream.dirty)
+			n_damage = load_damage(src, store, buf, stream.w * stream.h, damage);
+
+		if (stream.dirty && !explicit){
+			store->damage.partial = true;
+			store->damage.x1 = stream.x1;
+			store->damage.y1 = stream.y1;
+			store->damage.x2 = stream.x1 + stream.w;
+			store->damage.y2 = stream.y1 + stream.h;
+		}
 	}
 	else
 		src->desc.region_valid = false;
 
+/* full frame uploads go through the deferred stage if it is active, the
+ * mapping needs to happen here on the graphics thread */
+	if (g_uploads.active && !explicit &&
+		!src->flags.local_copy && !stream.dirty && queue_upload(src, store, buf, vmask))
+		return true;
+
 /* perhaps also convert hints to message string */
 	size_t n_px = stream.w * stream.h;
 	TRACE_MARK_ENTER("frameserver", "buffer-upload", TRACE_SYS_DEFAULT, src->vid, n_px, "");
 
-	stream = agp_stream_prepare(store, stream, explicit ?
-		STREAM_RAW_DIRECT_SYNCHRONOUS : (
-			src->flags.local_copy ? STREAM_RAW_DIRECT_COPY : STREAM_RAW_DIRECT));
+	enum stream_type type = explicit ? STREAM_RAW_DIRECT_SYNCHRONOUS :
+		(src->flags.local_copy ? STREAM_RAW_DIRECT_COPY : STREAM_RAW_DIRECT);
 
-	agp_stream_commit(store, stream);
+/* one sub-upload per damaged region rather than the bounding region */
+	if (n_damage){
+		for (size_t i = 0; i < n_damage; i++){
+			struct stream_meta sub = stream;
+			sub.x1 = damage[i].x1; sub.w = damage[i].x2 - damage[i].x1;
+			sub.y1 = damage[i].y1; sub.h = damage[i].y2 - damage[i].y1;
+			agp_stream_commit(store, agp_stream_prepare(store, sub, type));
+		}
+	}
+	else {
+		stream = agp_stream_prepare(store, stream, type);
+		agp_stream_commit(store, stream);
+	}
 	TRACE_MARK_EXIT("frameserver", "buffer-upload", TRACE_SYS_DEFAULT, src->vid, n_px, "upload");
 
 commit_mask:
@@ -552,7 +800,7 @@ enum arcan_ffunc_rv arcan_frameserver_emptyframe FFUNC_HEAD
 
 	switch (cmd){
 		case FFUNC_POLL:
-			if (tgt->shm.ptr->resized){
+			if (tgt->shm.ptr->resized || tgt->flags.rz_verified){
 				if (arcan_frameserver_tick_control(tgt, false, FFUNC_VFRAME) &&
 					tgt->shm.ptr && tgt->shm.ptr->vready){
 					platform_fsrv_leave();
@@ -601,8 +849,10 @@ int arcan_frameserver_releaselock(struct arcan_frameserver* tgt)
 	tgt->flags.release_pending = false;
 	TRAMP_GUARD(0, tgt);
 
-	atomic_store_explicit(&tgt->shm.ptr->vready, 0, memory_order_release);
-	arcan_sem_post( tgt->vsync );
+	if (!atomic_load(&tgt->shm.ptr->vpending))
+		atomic_store_explicit(&tgt->shm.ptr->vready, 0, memory_order_release);
+	platform_fsrv_wake(tgt, SHMIF_SIGVID);
+	tgt->latency.wake = arcan_timemicros();
 		if (tgt->desc.hints & SHMIF_RHINT_VSIGNAL_EV){
 			TRACE_MARK_ONESHOT("frameserver", "signal", TRACE_SYS_DEFAULT, tgt->vid, 0, "");
 			platform_fsrv_pushevent(tgt, &(struct arcan_event){
@@ -647,7 +897,7 @@ enum arcan_ffunc_rv arcan_frameserver_vdirect FFUNC_HEAD
 	break;
 
 	case FFUNC_POLL:
-		if (shmpage->resized){
+		if (shmpage->resized || tgt->flags.rz_verified){
 			arcan_frameserver_tick_control(tgt, false, FFUNC_VFRAME);
 			goto no_out;
 		}
@@ -669,8 +919,17 @@ enum arcan_ffunc_rv arcan_frameserver_vdirect FFUNC_HEAD
 
 /* caller uses this hint to determine if a transfer should be
  * initiated or not */
-		rv = (tgt->shm.ptr->vready &&
-			!tgt->flags.release_pending) ? FRV_GOTFRAME : FRV_NOFRAME;
+		rv = (tgt->shm.ptr->vready && !tgt->flags.release_pending &&
+			!tgt->flags.upload_pending) ? FRV_GOTFRAME : FRV_NOFRAME;
+
+		if (rv == FRV_GOTFRAME && !tgt->latency.submit){
+			tgt->latency.submit = arcan_timemicros();
+			if (tgt->latency.wake){
+				arcan_costhist_add(&tgt->latency.render,
+					tgt->latency.submit - tgt->latency.wake);
+				tgt->latency.wake = 0;
+			}
+		}
 	break;
 
 	case FFUNC_TICK:
@@ -702,43 +961,19 @@ enum arcan_ffunc_rv arcan_frameserver_vdirect FFUNC_HEAD
 			atomic_load(&tgt->shm.ptr->apending) > 0);
 
 /* sometimes, the buffer transfer is forcibly deferred and this needs
- * to be repeat until it succeeds - this mechanism could/should(?) also
- * be used with the vpts- below, simply defer until the deadline has
- * passed */
+ * to be repeat until it succeeds - this is also what happens when all
+ * pending buffers are timestamped past the coming synch */
 		if (g_buffers_locked == 1 || tgt->flags.locked || !push_buffer(tgt,
 				dst_store, shmpage->hints & SHMIF_RHINT_SUBREGION ? &dirty : NULL)){
 			goto no_out;
 		}
 
-/* for tighter latency management, here is where the estimated next
- * synch deadline for any output it is used on could/should be set,
- * though it feeds back into the need of the conductor- refactor */
-		dst_store->vinf.text.vpts = shmpage->vpts;
-
-/* for some connections, we want additional statistics */
-		if (tgt->desc.callback_framestate)
-			emit_deliveredframe(tgt, shmpage->vpts, tgt->desc.framecount);
-		tgt->desc.framecount++;
-		TRACE_MARK_ONESHOT("frameserver", "frame", TRACE_SYS_DEFAULT, tgt->vid, tgt->desc.framecount, "");
-
-/* interactive frameserver blocks on vsemaphore only,
- * so set monitor flags and wake up */
-		if (g_buffers_locked != 2){
-			atomic_store_explicit(&shmpage->vready, 0, memory_order_release);
+/* the copy is in flight in the deferred upload stage, the rest of the
+ * delivery is performed when that is flushed */
+		if (tgt->flags.upload_pending)
+			goto no_out;
 
-			arcan_sem_post( tgt->vsync );
-			if (tgt->desc.hints & SHMIF_RHINT_VSIGNAL_EV){
-				TRACE_MARK_ONESHOT("frameserver", "signal", TRACE_SYS_DEFAULT, tgt->vid, 0, "");
-				platform_fsrv_pushevent(tgt, &(struct arcan_event){
-					.category = EVENT_TARGET,
-					.tgt.kind = TARGET_COMMAND_STEPFRAME,
-					.tgt.ioevs[0].iv = 1,
-					.tgt.ioevs[1].iv = 0
-				});
-			}
-		}
-		else
-			tgt->flags.release_pending = true;
+		frame_delivered(tgt, dst_store);
 	break;
 
 	case FFUNC_ADOPT:
@@ -758,6 +993,51 @@ no_out:
 	return rv;
 }
 
+static void frame_delivered(arcan_frameserver* tgt, struct agp_vstore* dst_store)
+{
+	struct arcan_shmif_page* shmpage = tgt->shm.ptr;
+
+/* for tighter latency management, here is where the estimated next
+ * synch deadline for any output it is used on could/should be set,
+ * though it feeds back into the need of the conductor- refactor */
+	uint64_t vpts = tgt->vbuf_pts ? tgt->vbuf_pts : shmpage->vpts;
+	dst_store->vinf.text.vpts = vpts;
+
+	if (tgt->latency.submit){
+		arcan_costhist_add(&tgt->latency.hist,
+			arcan_timemicros() - tgt->latency.submit);
+		tgt->latency.submit = 0;
+	}
+
+/* for some connections, we want additional statistics */
+	if (tgt->desc.callback_framestate)
+		emit_deliveredframe(tgt, vpts, tgt->desc.framecount);
+	tgt->desc.framecount++;
+	TRACE_MARK_ONESHOT("frameserver", "frame", TRACE_SYS_DEFAULT, tgt->vid, tgt->desc.framecount, "");
+
+/* interactive frameserver blocks on vsemaphore only,
+ * so set monitor flags and wake up */
+	if (g_buffers_locked != 2){
+/* buffers queued for a later synch keep the flag set for the next pass */
+		if (!atomic_load(&shmpage->vpending))
+			atomic_store_explicit(&shmpage->vready, 0, memory_order_release);
+
+		platform_fsrv_wake(tgt, SHMIF_SIGVID);
+		tgt->latency.wake = arcan_timemicros();
+		if (tgt->desc.hints & SHMIF_RHINT_VSIGNAL_EV){
+			TRACE_MARK_ONESHOT("frameserver", "signal", TRACE_SYS_DEFAULT, tgt->vid, 0, "");
+			platform_fsrv_pushevent(tgt, &(struct arcan_event){
+				.category = EVENT_TARGET,
+				.tgt.kind = TARGET_COMMAND_STEPFRAME,
+				.tgt.ioevs[0].iv = 1,
+				.tgt.ioevs[1].iv = 0
+			});
+		}
+	}
+	else
+		tgt->flags.release_pending = true;
+}
+
 /*
  * a little bit special, the vstore is already assumed to contain the state
  * that we want to forward, and there's no audio mixing or similar going on, so
@@ -1237,8 +1517,8 @@ arcan_errc arcan_frameserver_audioframe_direct(arcan_aobj* aobj,
 
 	if (0 == amask || ((1<<ind)&amask) == 0){
 		atomic_store_explicit(&src->shm.ptr->aready, 0, memory_order_release);
+		platform_fsrv_wake(src, SHMIF_SIGAUD);
 		platform_fsrv_leave(src);
-		arcan_sem_post(src->async);
 		return ARCAN_ERRC_NOTREADY;
 	}
 
@@ -1263,8 +1543,8 @@ arcan_errc arcan_frameserver_audioframe_direct(arcan_aobj* aobj,
 /* check for cont and > 1, wait for signal.. else release */
 	if (!cont){
 		atomic_store_explicit(&src->shm.ptr->aready, 0, memory_order_release);
+		platform_fsrv_wake(src, SHMIF_SIGAUD);
 		platform_fsrv_leave(src);
-		arcan_sem_post(src->async);
 	}
 
 	return ARCAN_OK;
@@ -1286,6 +1566,14 @@ bool arcan_frameserver_tick_control(
 	arcan_event_queuetransfer(
 		arcan_event_defaultctx(), &src->inqueue, src->queue_mask, 0.5, src);
 
+/* resize might already have been processed by a worker in verify */
+	int rzc;
+	if (src->flags.rz_verified){
+		src->flags.rz_verified = false;
+		rzc = src->rz_code;
+		goto resynched;
+	}
+
 	if (!src->shm.ptr->resized){
 		fail = false;
 		goto leave;
@@ -1308,7 +1596,8 @@ bool arcan_frameserver_tick_control(
 	with switching buffer strategies (valid buffer in one size, failed because
 	size over reach with other strategy, so now there's a failure mechanism.
  */
-	int rzc = platform_fsrv_resynch(src);
+	rzc = platform_fsrv_resynch(src, atomic_load(&src->shm.ptr->hints));
+resynched:
 	if (rzc <= 0)
 		goto leave;
 	else if (rzc == 2){
@@ -1369,6 +1658,41 @@ leave:
 	return !fail;
 }
 
+void arcan_frameserver_verify(arcan_frameserver* src)
+{
+	if (!src || !src->shm.ptr || !src->flags.alive ||
+		src->playstate == ARCAN_PAUSED || src->flags.rz_verified ||
+		src->staged.broken)
+		return;
+
+	TRAMP_GUARD(, src);
+
+	if (!src->shm.ptr->dms ||
+		src->shm.ptr->cookie != arcan_shmif_cookie()){
+		platform_fsrv_leave();
+		return;
+	}
+
+/* a broken queue is only flagged here, the main thread frees the client on
+ * the next queuetransfer so src has to stay untouched until then */
+	arcan_event_queueverify(&src->inqueue, src->queue_mask, src);
+	if (src->staged.broken){
+		platform_fsrv_leave();
+		return;
+	}
+
+/* authentication goes through the video platform, leave that to tick_control,
+ * the hints are read once and that copy is what resynch gets to work with */
+	int hints = atomic_load(&src->shm.ptr->hints);
+	if (src->shm.ptr->resized && !(hints & SHMIF_RHINT_AUTH_TOK)){
+		FORCE_SYNCH();
+		src->rz_code = platform_fsrv_resynch(src, hints);
+		src->flags.rz_verified = true;
+	}
+
+	platform_fsrv_leave();
+}
+
 arcan_errc arcan_frameserver_pause(arcan_frameserver* src)
 {
 	arcan_errc rv = ARCAN_ERRC_NO_SUCH_OBJECT;
@@ -118,6 +118,10 @@ struct arcan_frameserver {
 	sem_handle vsync, async, esync;
 	file_handle dpipe;
 
+/* with futex synch, eventfd that the client signals on buffer submission,
+ * handed over on first use (see platform_fsrv_synchfd) */
+	file_handle synch_fd;
+
 /* if we spawn child, track if it is alive */
 	process_handle child;
 
@@ -161,6 +165,9 @@ struct arcan_frameserver {
 		bool rz_ack : 1;
 		bool locked : 1;
 		bool release_pending : 1;
+		bool upload_pending : 1;
+		bool rz_verified : 1;
+		bool synch_sent : 1;
 		bool no_adopt : 1;
 
 /* privilege level indicators */
@@ -177,6 +184,28 @@ struct arcan_frameserver {
 		bool frame;
 	} clock;
 
+/* hist - from the client submitting a frame (vready) until that frame has
+ * been delivered and is ready for composition, render - from the client
+ * being woken until it submits. Synchronization strategies that try to wake
+ * as late as possible need both. */
+	struct {
+		unsigned long long wake;
+		unsigned long long submit;
+		struct arcan_costhist hist;
+		struct arcan_costhist render;
+	} latency;
+
+/* event queue pressure, exposed to scripts to find the clients that fill up
+ * their queues or force the main queue to drain synchronously:
+ * overflow - times either queue was found full
+ * drain - synchronous drains of the main queue while forwarding from here
+ * dropped - events lost in either direction for lack of space */
+	struct {
+		uint64_t overflow;
+		uint64_t drain;
+		uint64_t dropped;
+	} evstats;
+
 /* for monitoring hooks, 0 entry terminates. */
 	arcan_aobj_id* alocks;
 	arcan_aobj_id aid;
@@ -203,10 +232,14 @@ struct arcan_frameserver {
 	uint32_t cookie;
 
 /* state tracking for accelerated buffer sharing, populated by handle
- * events that accompany signalling if enabled */
+ * events that accompany signalling if enabled, or by a set of persistent
+ * handles that each back one video buffer (slots). [bound] is the handle
+ * currently imported, [dirty] that the imports need to be redone. */
 	struct {
-		bool dead;
+		bool dead, dirty;
 		int handle;
+		int slots[ARCAN_SHMIF_VBUFC_LIM];
+		int bound;
 		size_t stride;
 		int format;
 	} vstream;
@@ -222,6 +255,19 @@ struct arcan_frameserver {
 	size_t n_pending;
 	struct arcan_event pending_queue[4];
 
+/* events that have been verified off-thread (arcan_frameserver_verify) but
+ * not yet forwarded to the main queue, along with the deferred actions that
+ * need the main thread and the outcome of an off-thread resize. [broken] marks
+ * a client that corrupted its queue, the kill is left to the main thread */
+	struct {
+		struct arcan_event evs[32];
+		size_t count;
+		bool wake;
+		bool flush_audio;
+		bool broken;
+	} staged;
+	int rz_code;
+
 /* trackable members to help scriping engine recover on script failure,
  * populated through allocation or during queuetransfer */
 	char title[64];
@@ -240,6 +286,9 @@ struct arcan_frameserver {
 	size_t abuf_sz;
 	size_t vbuf_cnt;
 
+/* presentation timestamp of the buffer last picked for upload, 0 if none */
+	uint64_t vbuf_pts;
+
 /* for use with rz_ack */
 	int rz_known;
 	shmif_pixel* vbufs[FSRV_MAX_VBUFC];
@@ -476,6 +525,30 @@ void arcan_frameserver_displayhint(
  */
 void arcan_frameserver_lock_buffers(int state);
 
+/*
+ * Run the client-local part of tick_control: event queue verification
+ * (arcan_event_queueverify) and resize/renegotiation of the shared page. This
+ * only touches [src] and is intended to be run from the conductor worker pool,
+ * with the main-thread part (enqueue, feed function switch, ...) completed on
+ * the next poll/tick. Resizes that need GPU authentication are left for the
+ * main thread.
+ */
+void arcan_frameserver_verify(struct arcan_frameserver* src);
+
+/*
+ * Defer the shared memory to upload buffer copies of any frames that are
+ * pushed between upload_begin and upload_flush. The upload buffers are
+ * mapped as the frames are pushed, the copies are split over the conductor
+ * worker pool (arcan_conductor_parallel) in flush, and then committed and the
+ * clients released on the calling (graphics) thread.
+ *
+ * Frames that can't take the mapped path (explicit/synchronous, local copy,
+ * sub-region, handle passing or platforms without mappable upload buffers)
+ * are processed immediately as before.
+ */
+void arcan_frameserver_upload_begin();
+void arcan_frameserver_upload_flush();
+
 /*
  * IF the frameserver is in pending-release state, this will send signals
  * unlock semaphores and clear the flag. This is used in combination with
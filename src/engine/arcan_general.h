@@ -113,8 +113,26 @@ typedef struct {
 
 	unsigned framecost[64], costcount;
 	char costofs;
+
+	unsigned drawcalls;
+	unsigned culled, occluded;
+	unsigned programs, textures, uniforms, skipped;
 } arcan_benchdata;
 
+/*
+ * coarse latency distribution, 250us bins with the last bin catching
+ * everything above, aged by halving every bin when the total reaches
+ * the limit so that older samples gradually lose their weight
+ */
+#define ARCAN_COSTHIST_BINS 128
+#define ARCAN_COSTHIST_STEP 250
+#define ARCAN_COSTHIST_AGE 1024
+
+struct arcan_costhist {
+	uint16_t bins[ARCAN_COSTHIST_BINS];
+	uint16_t count;
+};
+
 /*
  * slated to be moved to a utility library for
  * cryptography / data-passing primitives
@@ -146,9 +164,21 @@ void arcan_state_dump(const char* prefix, const char* key, const char* src);
  */
 void arcan_bench_register_tick(unsigned);
 void arcan_bench_register_cost(unsigned);
+void arcan_bench_register_draws(unsigned);
+void arcan_bench_register_cull(unsigned culled, unsigned occluded);
+void arcan_bench_register_state(unsigned programs,
+	unsigned textures, unsigned uniforms, unsigned skipped);
 void arcan_bench_register_frame();
 arcan_benchdata* arcan_bench_data();
 
+/*
+ * add a sample (microseconds) to a latency distribution, or retrieve the
+ * upper bound (microseconds) of the bin that covers [pct] percent of the
+ * samples. Returns -1 if there are too few samples for a useful estimate.
+ */
+void arcan_costhist_add(struct arcan_costhist*, unsigned long long us);
+long long arcan_costhist_pct(struct arcan_costhist*, unsigned pct);
+
 /*
  * used throughout the engine (if set), using macro form in order for high-
  * optimized builds that disable tracing entirely
@@ -172,6 +202,19 @@ extern bool arcan_trace_enabled;
  */
 void arcan_trace_setbuffer(uint8_t* buf, size_t buf_sz, bool* finish_flag);
 
+/*
+ * enable streaming output of all trace entries to [path] in the chrome
+ * trace-event JSON format (chrome://tracing, ui.perfetto.dev). This works
+ * independently of setbuffer. Samples are queued in a fixed size ring and
+ * written by a background thread, if the ring is full, samples are dropped
+ * and the number of dropped samples added as a counter track. Enter/exit
+ * pairs are grouped into one track per system.
+ *
+ * Call with [path] set to NULL to flush and close any active stream. Returns
+ * false if the file couldn't be opened or the writer thread couldn't be set up.
+ */
+bool arcan_trace_setstream(const char* path);
+
 /* add a trace entry-point (though call through the TRACE_MARK macros),
  * sys returns to the main system group (graphics, video, 3d, ...) and
  * subsys for a group specific subsystem (where useful distinctions exist).
@@ -12,6 +12,16 @@
 #include <inttypes.h>
 #include <stdbool.h>
 #include <string.h>
+#include <math.h>
+#include <setjmp.h>
+
+#ifdef HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
+
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif
 
 #include "arcan_math.h"
 #include "arcan_general.h"
@@ -258,3 +268,586 @@ arcan_errc arcan_img_decode(const char* hint, char* inbuf, size_t inbuf_sz,
 
 	return rv;
 }
+
+/*
+ * Reduced decoding for images that will be scaled down to fit constraints
+ * anyway. Rows are fed one at a time into an area-averaging reduction by the
+ * largest integer factor that keeps the output at or above the constraints,
+ * so the full resolution image never has to exist in memory when the format
+ * can be decoded row by row. JPEG (libjpeg) also scales in the DCT domain by
+ * 1/2, 1/4 or 1/8 before that. Other formats, or builds without the system
+ * decoders, decode the full image and reduce it afterwards. The caller still
+ * resamples the result to the exact dimensions.
+ */
+struct img_reduce {
+	uint32_t* out;
+	uint32_t* acc;
+	size_t inw, inh, outw, outh, k;
+	size_t row;
+	bool vflip;
+};
+
+static size_t reduce_factor(size_t inw, size_t inh, size_t minw, size_t minh)
+{
+	size_t kw = inw / minw;
+	size_t kh = inh / minh;
+	size_t k = kw < kh ? kw : kh;
+	return k ? k : 1;
+}
+
+static bool reduce_setup(
+	struct img_reduce* red, size_t inw, size_t inh, size_t k, bool vflip)
+{
+	*red = (struct img_reduce){
+		.inw = inw, .inh = inh, .k = k, .vflip = vflip,
+		.outw = (inw + k - 1) / k,
+		.outh = (inh + k - 1) / k
+	};
+
+	red->out = arcan_alloc_mem(red->outw * red->outh * 4,
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_PAGE);
+	red->acc = arcan_alloc_mem(red->outw * 4 * sizeof(uint32_t),
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL | ARCAN_MEM_BZERO,
+		ARCAN_MEMALIGN_NATURAL);
+
+	if (!red->out || !red->acc){
+		arcan_mem_free(red->out);
+		arcan_mem_free(red->acc);
+		red->out = red->acc = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+static void reduce_emit(struct img_reduce* red, size_t rows)
+{
+	size_t oy = (red->row - 1) / red->k;
+	if (red->vflip)
+		oy = red->outh - 1 - oy;
+
+	uint8_t* dst = (uint8_t*) &red->out[oy * red->outw];
+	for (size_t x = 0; x < red->outw; x++){
+		size_t cols = red->inw - x * red->k;
+		uint32_t n = (cols < red->k ? cols : red->k) * rows;
+
+		for (size_t c = 0; c < 4; c++){
+			dst[x * 4 + c] = (red->acc[x * 4 + c] + (n >> 1)) / n;
+			red->acc[x * 4 + c] = 0;
+		}
+	}
+}
+
+/* [src] is one row of tightly packed RGBA8 */
+static void reduce_row(struct img_reduce* red, const uint8_t* src)
+{
+	for (size_t x = 0; x < red->inw; x++){
+		uint32_t* acc = &red->acc[(x / red->k) * 4];
+		acc[0] += src[0];
+		acc[1] += src[1];
+		acc[2] += src[2];
+		acc[3] += src[3];
+		src += 4;
+	}
+
+	red->row++;
+	if (red->row % red->k == 0)
+		reduce_emit(red, red->k);
+	else if (red->row == red->inh)
+		reduce_emit(red, red->row % red->k);
+}
+
+static void reduce_free(struct img_reduce* red)
+{
+	arcan_mem_free(red->out);
+	arcan_mem_free(red->acc);
+}
+
+#ifdef HAVE_LIBJPEG
+struct jpeg_err {
+	struct jpeg_error_mgr mgr;
+	jmp_buf env;
+};
+
+static void jpeg_fail(j_common_ptr cinfo)
+{
+	longjmp(((struct jpeg_err*) cinfo->err)->env, 1);
+}
+
+static void jpeg_quiet(j_common_ptr cinfo)
+{
+}
+
+static bool jpeg_reduced(char* inbuf, size_t inbuf_sz, size_t minw,
+	size_t minh, bool vflip, struct img_reduce* red)
+{
+	struct jpeg_decompress_struct cinfo;
+	struct jpeg_err err;
+	uint8_t* volatile line = NULL;
+	uint8_t* volatile rgba = NULL;
+
+	memset(red, '\0', sizeof(struct img_reduce));
+	cinfo.err = jpeg_std_error(&err.mgr);
+	err.mgr.error_exit = jpeg_fail;
+	err.mgr.output_message = jpeg_quiet;
+
+	if (setjmp(err.env)){
+		jpeg_destroy_decompress(&cinfo);
+		arcan_mem_free(line);
+		arcan_mem_free(rgba);
+		reduce_free(red);
+		return false;
+	}
+
+	jpeg_create_decompress(&cinfo);
+	jpeg_mem_src(&cinfo, (unsigned char*) inbuf, inbuf_sz);
+	jpeg_read_header(&cinfo, TRUE);
+
+/* largest DCT reduction that stays at or above the constraints */
+	cinfo.out_color_space = JCS_RGB;
+	cinfo.scale_num = 1;
+	cinfo.scale_denom = 1;
+	for (unsigned d = 8; d > 1; d >>= 1)
+		if ((cinfo.image_width + d - 1) / d >= minw &&
+			(cinfo.image_height + d - 1) / d >= minh){
+			cinfo.scale_denom = d;
+			break;
+		}
+
+	jpeg_start_decompress(&cinfo);
+
+	size_t w = cinfo.output_width;
+	size_t h = cinfo.output_height;
+	if (cinfo.output_components != 3 ||
+		!reduce_setup(red, w, h, reduce_factor(w, h, minw, minh), vflip))
+		longjmp(err.env, 1);
+
+	line = arcan_alloc_mem(w * 3, ARCAN_MEM_VBUFFER,
+		ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+	rgba = arcan_alloc_mem(w * 4, ARCAN_MEM_VBUFFER,
+		ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+	if (!line || !rgba)
+		longjmp(err.env, 1);
+
+	while (cinfo.output_scanline < cinfo.output_height){
+		JSAMPROW row = line;
+		jpeg_read_scanlines(&cinfo, &row, 1);
+		for (size_t x = 0; x < w; x++){
+			rgba[x * 4 + 0] = line[x * 3 + 0];
+			rgba[x * 4 + 1] = line[x * 3 + 1];
+			rgba[x * 4 + 2] = line[x * 3 + 2];
+			rgba[x * 4 + 3] = 0xff;
+		}
+		reduce_row(red, rgba);
+	}
+
+	jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+	arcan_mem_free(line);
+	arcan_mem_free(rgba);
+	return true;
+}
+#endif
+
+#ifdef HAVE_LIBPNG
+struct png_src {
+	char* buf;
+	size_t sz, ofs;
+};
+
+static void png_read_mem(png_structp png, png_bytep out, png_size_t n)
+{
+	struct png_src* src = png_get_io_ptr(png);
+	if (src->sz - src->ofs < n)
+		png_error(png, "truncated");
+
+	memcpy(out, &src->buf[src->ofs], n);
+	src->ofs += n;
+}
+
+static bool png_reduced(char* inbuf, size_t inbuf_sz, size_t minw,
+	size_t minh, bool vflip, struct img_reduce* red)
+{
+	struct png_src src = {.buf = inbuf, .sz = inbuf_sz};
+	uint8_t* volatile rgba = NULL;
+
+	memset(red, '\0', sizeof(struct img_reduce));
+	png_structp png =
+		png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	if (!png)
+		return false;
+
+	png_infop info = png_create_info_struct(png);
+	if (!info || setjmp(png_jmpbuf(png))){
+		png_destroy_read_struct(&png, info ? &info : NULL, NULL);
+		arcan_mem_free(rgba);
+		reduce_free(red);
+		return false;
+	}
+
+	png_set_read_fn(png, &src, png_read_mem);
+	png_read_info(png, info);
+
+/* interlaced images would need the whole image for the passes */
+	if (png_get_interlace_type(png, info) != PNG_INTERLACE_NONE)
+		png_error(png, "interlaced");
+
+	int ctype = png_get_color_type(png, info);
+	png_set_expand(png);
+	png_set_strip_16(png);
+	if (ctype == PNG_COLOR_TYPE_GRAY || ctype == PNG_COLOR_TYPE_GRAY_ALPHA)
+		png_set_gray_to_rgb(png);
+	png_set_filler(png, 0xff, PNG_FILLER_AFTER);
+	png_read_update_info(png, info);
+
+	size_t w = png_get_image_width(png, info);
+	size_t h = png_get_image_height(png, info);
+	if (png_get_rowbytes(png, info) != w * 4 ||
+		!reduce_setup(red, w, h, reduce_factor(w, h, minw, minh), vflip))
+		png_error(png, "setup");
+
+	rgba = arcan_alloc_mem(w * 4,
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+	if (!rgba)
+		png_error(png, "out of memory");
+
+	for (size_t y = 0; y < h; y++){
+		png_read_row(png, rgba, NULL);
+		reduce_row(red, rgba);
+	}
+
+	png_destroy_read_struct(&png, &info, NULL);
+	arcan_mem_free(rgba);
+	return true;
+}
+#endif
+
+arcan_errc arcan_img_decode_reduced(const char* hint, char* inbuf,
+	size_t inbuf_sz, uint32_t** outbuf, size_t* outw, size_t* outh,
+	struct arcan_img_meta* meta, bool vflip, size_t minw, size_t minh)
+{
+	if (!minw || !minh)
+		return arcan_img_decode(
+			hint, inbuf, inbuf_sz, outbuf, outw, outh, meta, vflip);
+
+	struct img_reduce red;
+	bool done = false;
+	int len = strlen(hint);
+
+#ifdef HAVE_LIBJPEG
+	if ((len >= 3 && strcasecmp(hint + (len - 3), "JPG") == 0) ||
+		(len >= 4 && strcasecmp(hint + (len - 4), "JPEG") == 0))
+		done = jpeg_reduced(inbuf, inbuf_sz, minw, minh, vflip, &red);
+#endif
+
+#ifdef HAVE_LIBPNG
+	if (len >= 3 && strcasecmp(hint + (len - 3), "PNG") == 0)
+		done = png_reduced(inbuf, inbuf_sz, minw, minh, vflip, &red);
+#endif
+
+/* decode everything and reduce the result */
+	if (!done){
+		size_t inw, inh;
+		uint32_t* buf = NULL;
+		arcan_errc rv = arcan_img_decode(
+			hint, inbuf, inbuf_sz, &buf, &inw, &inh, meta, vflip);
+
+		if (rv != ARCAN_OK || meta->compressed){
+			*outbuf = buf;
+			*outw = inw;
+			*outh = inh;
+			return rv;
+		}
+
+		size_t k = reduce_factor(inw, inh, minw, minh);
+		if (k == 1 || !reduce_setup(&red, inw, inh, k, false)){
+			*outbuf = buf;
+			*outw = inw;
+			*outh = inh;
+			return ARCAN_OK;
+		}
+
+		for (size_t y = 0; y < inh; y++)
+			reduce_row(&red, (uint8_t*) &buf[y * inw]);
+		arcan_mem_free(buf);
+	}
+
+	arcan_mem_free(red.acc);
+	*outbuf = red.out;
+	*outw = red.outw;
+	*outh = red.outh;
+	return ARCAN_OK;
+}
+
+/*
+ * BC1 (DXT1) and BC3 (DXT5) block compression. The color endpoints are the
+ * extremes of the block projected on its principal axis, and every texel
+ * picks the closest of the four interpolated colors. BC3 adds an eight step
+ * alpha ramp between the alpha extremes. This is not a high quality encoder,
+ * but it is fast enough to run as part of a load.
+ */
+static uint16_t pack565(const float c[3])
+{
+	int r = (int)(c[0] * 31.0f / 255.0f + 0.5f);
+	int g = (int)(c[1] * 63.0f / 255.0f + 0.5f);
+	int b = (int)(c[2] * 31.0f / 255.0f + 0.5f);
+	r = r < 0 ? 0 : (r > 31 ? 31 : r);
+	g = g < 0 ? 0 : (g > 63 ? 63 : g);
+	b = b < 0 ? 0 : (b > 31 ? 31 : b);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpack565(uint16_t v, int c[3])
+{
+	c[0] = ((v >> 11) & 31) * 255 / 31;
+	c[1] = ((v >> 5) & 63) * 255 / 63;
+	c[2] = (v & 31) * 255 / 31;
+}
+
+static void bc_palette(uint16_t c0, uint16_t c1, bool four, int pal[4][4])
+{
+	unpack565(c0, pal[0]);
+	unpack565(c1, pal[1]);
+	pal[0][3] = pal[1][3] = pal[2][3] = 255;
+
+	for (size_t i = 0; i < 3; i++){
+		if (four){
+			pal[2][i] = (2 * pal[0][i] + pal[1][i]) / 3;
+			pal[3][i] = (pal[0][i] + 2 * pal[1][i]) / 3;
+		}
+		else {
+			pal[2][i] = (pal[0][i] + pal[1][i]) / 2;
+			pal[3][i] = 0;
+		}
+	}
+	pal[3][3] = four ? 255 : 0;
+}
+
+static void bc_color_block(uint8_t blk[16][4], uint8_t* dst)
+{
+	float mean[3] = {0};
+	for (size_t i = 0; i < 16; i++)
+		for (size_t j = 0; j < 3; j++)
+			mean[j] += blk[i][j];
+
+	for (size_t j = 0; j < 3; j++)
+		mean[j] /= 16.0f;
+
+	float cov[6] = {0};
+	for (size_t i = 0; i < 16; i++){
+		float r = blk[i][0] - mean[0];
+		float g = blk[i][1] - mean[1];
+		float b = blk[i][2] - mean[2];
+		cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+		cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+	}
+
+/* a few rounds of power iteration is enough to get the dominant axis */
+	float axis[3] = {1.0f, 1.0f, 1.0f};
+	for (size_t k = 0; k < 4; k++){
+		float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+		float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+		float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+		float m = fabsf(x) > fabsf(y) ? fabsf(x) : fabsf(y);
+		m = m > fabsf(z) ? m : fabsf(z);
+		if (m < 1e-6f)
+			break;
+		axis[0] = x / m; axis[1] = y / m; axis[2] = z / m;
+	}
+
+	float lo = 0, hi = 0;
+	for (size_t i = 0; i < 16; i++){
+		float d = (blk[i][0] - mean[0]) * axis[0] +
+			(blk[i][1] - mean[1]) * axis[1] + (blk[i][2] - mean[2]) * axis[2];
+		lo = d < lo ? d : lo;
+		hi = d > hi ? d : hi;
+	}
+
+	float len = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	float e0[3], e1[3];
+	for (size_t j = 0; j < 3; j++){
+		e0[j] = mean[j] + (len > 0 ? axis[j] * hi / len : 0);
+		e1[j] = mean[j] + (len > 0 ? axis[j] * lo / len : 0);
+	}
+
+	uint16_t c0 = pack565(e0);
+	uint16_t c1 = pack565(e1);
+
+/* the four color mode is selected by c0 > c1 */
+	if (c0 < c1){
+		uint16_t t = c0;
+		c0 = c1;
+		c1 = t;
+	}
+
+	uint32_t ind = 0;
+	if (c0 != c1){
+		int pal[4][4];
+		bc_palette(c0, c1, true, pal);
+
+		for (size_t i = 0; i < 16; i++){
+			int best = 0, bestd = INT32_MAX;
+			for (size_t p = 0; p < 4; p++){
+				int dr = blk[i][0] - pal[p][0];
+				int dg = blk[i][1] - pal[p][1];
+				int db = blk[i][2] - pal[p][2];
+				int d = dr * dr + dg * dg + db * db;
+				if (d < bestd){
+					bestd = d;
+					best = p;
+				}
+			}
+			ind |= (uint32_t) best << (i * 2);
+		}
+	}
+
+	dst[0] = c0 & 0xff;
+	dst[1] = c0 >> 8;
+	dst[2] = c1 & 0xff;
+	dst[3] = c1 >> 8;
+	dst[4] = ind & 0xff;
+	dst[5] = (ind >> 8) & 0xff;
+	dst[6] = (ind >> 16) & 0xff;
+	dst[7] = ind >> 24;
+}
+
+static void bc_alpha_palette(uint8_t a0, uint8_t a1, int pal[8])
+{
+	pal[0] = a0;
+	pal[1] = a1;
+	if (a0 > a1){
+		for (size_t i = 1; i < 7; i++)
+			pal[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+	}
+	else {
+		for (size_t i = 1; i < 5; i++)
+			pal[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+		pal[6] = 0;
+		pal[7] = 255;
+	}
+}
+
+static void bc_alpha_block(uint8_t blk[16][4], uint8_t* dst)
+{
+	uint8_t a0 = 0, a1 = 255;
+	for (size_t i = 0; i < 16; i++){
+		a0 = blk[i][3] > a0 ? blk[i][3] : a0;
+		a1 = blk[i][3] < a1 ? blk[i][3] : a1;
+	}
+
+	uint64_t ind = 0;
+	if (a0 != a1){
+		int pal[8];
+		bc_alpha_palette(a0, a1, pal);
+
+		for (size_t i = 0; i < 16; i++){
+			int best = 0, bestd = 256;
+			for (size_t p = 0; p < 8; p++){
+				int d = abs(blk[i][3] - pal[p]);
+				if (d < bestd){
+					bestd = d;
+					best = p;
+				}
+			}
+			ind |= (uint64_t) best << (i * 3);
+		}
+	}
+
+	dst[0] = a0;
+	dst[1] = a1;
+	for (size_t i = 0; i < 6; i++)
+		dst[2 + i] = (ind >> (i * 8)) & 0xff;
+}
+
+size_t arcan_img_compressed_size(
+	size_t inw, size_t inh, enum agp_compression fmt)
+{
+	size_t blocks = ((inw + 3) / 4) * ((inh + 3) / 4);
+	switch (fmt){
+	case AGP_COMPRESS_BC1:
+		return blocks * 8;
+	case AGP_COMPRESS_BC3:
+		return blocks * 16;
+	default:
+		return inw * inh * sizeof(av_pixel);
+	}
+}
+
+uint8_t* arcan_img_compress(av_pixel* inbuf, size_t inw, size_t inh,
+	enum agp_compression fmt, size_t* outsz)
+{
+	if (!inw || !inh || inw % 4 || inh % 4 ||
+		(fmt != AGP_COMPRESS_BC1 && fmt != AGP_COMPRESS_BC3))
+		return NULL;
+
+	*outsz = arcan_img_compressed_size(inw, inh, fmt);
+	uint8_t* out = arcan_alloc_mem(*outsz,
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_PAGE);
+	if (!out)
+		return NULL;
+
+	uint8_t* dst = out;
+	uint8_t blk[16][4];
+
+	for (size_t y = 0; y < inh; y += 4)
+		for (size_t x = 0; x < inw; x += 4){
+			for (size_t i = 0; i < 16; i++)
+				RGBA_DECOMP(inbuf[(y + i / 4) * inw + x + (i % 4)],
+					&blk[i][0], &blk[i][1], &blk[i][2], &blk[i][3]);
+
+			if (fmt == AGP_COMPRESS_BC3){
+				bc_alpha_block(blk, dst);
+				dst += 8;
+			}
+
+			bc_color_block(blk, dst);
+			dst += 8;
+		}
+
+	return out;
+}
+
+av_pixel* arcan_img_uncompress(uint8_t* inbuf, size_t inbuf_sz,
+	size_t inw, size_t inh, enum agp_compression fmt)
+{
+	if (!inw || !inh || inw % 4 || inh % 4 ||
+		(fmt != AGP_COMPRESS_BC1 && fmt != AGP_COMPRESS_BC3) ||
+		inbuf_sz < arcan_img_compressed_size(inw, inh, fmt))
+		return NULL;
+
+	av_pixel* out = arcan_alloc_mem(inw * inh * sizeof(av_pixel),
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_PAGE);
+	if (!out)
+		return NULL;
+
+	uint8_t* src = inbuf;
+	for (size_t y = 0; y < inh; y += 4)
+		for (size_t x = 0; x < inw; x += 4){
+			int alpha[8] = {255, 255, 255, 255, 255, 255, 255, 255};
+			uint64_t aind = 0;
+
+			if (fmt == AGP_COMPRESS_BC3){
+				bc_alpha_palette(src[0], src[1], alpha);
+				for (size_t i = 0; i < 6; i++)
+					aind |= (uint64_t) src[2 + i] << (i * 8);
+				src += 8;
+			}
+
+			uint16_t c0 = src[0] | (src[1] << 8);
+			uint16_t c1 = src[2] | (src[3] << 8);
+			uint32_t ind = src[4] | (src[5] << 8) |
+				(src[6] << 16) | ((uint32_t) src[7] << 24);
+			src += 8;
+
+			int pal[4][4];
+			bc_palette(c0, c1, fmt == AGP_COMPRESS_BC3 || c0 > c1, pal);
+
+			for (size_t i = 0; i < 16; i++){
+				int* c = pal[(ind >> (i * 2)) & 3];
+				int a = fmt == AGP_COMPRESS_BC3 ? alpha[(aind >> (i * 3)) & 7] : c[3];
+				out[(y + i / 4) * inw + x + (i % 4)] = RGBA(c[0], c[1], c[2], a);
+			}
+		}
+
+	return out;
+}
@@ -28,6 +28,17 @@ arcan_errc arcan_img_decode(const char* hint, char* inbuf, size_t inbuf_sz,
 	struct arcan_img_meta* outm, bool vflip
 );
 
+/*
+ * Same as arcan_img_decode, but when the image is larger than [minw, minh]
+ * the decoder may return a reduced version (while decoding when possible)
+ * that is still at least [minw, minh]. For images that will be resampled to
+ * fit constraints anyway.
+ */
+arcan_errc arcan_img_decode_reduced(const char* hint, char* inbuf,
+	size_t inbuf_sz, uint32_t** outbuf, size_t* outw, size_t* outh,
+	struct arcan_img_meta* outm, bool vflip, size_t minw, size_t minh
+);
+
 /*
  * take the contents of [inbuf] and unpack/[vflip],
  * then encode as PNG and write to [dst]. [dst] is kept open.
@@ -35,6 +46,27 @@ arcan_errc arcan_img_decode(const char* hint, char* inbuf, size_t inbuf_sz,
 arcan_errc arcan_img_outpng(FILE* dst,
 	av_pixel* inbuf, size_t inw, size_t inh, bool vflip);
 
+/*
+ * Encode [inbuf] into the GPU block compressed format [fmt] (BC1 or BC3),
+ * [inw] and [inh] need to be multiples of 4. Returns NULL on failure, or the
+ * compressed blocks with the size stored in [outsz].
+ */
+uint8_t* arcan_img_compress(av_pixel* inbuf, size_t inw, size_t inh,
+	enum agp_compression fmt, size_t* outsz);
+
+/*
+ * Reverse of arcan_img_compress, for backends that can't sample from [fmt]
+ * and for when the pixels need to be accessed. Returns NULL on failure.
+ */
+av_pixel* arcan_img_uncompress(uint8_t* inbuf, size_t inbuf_sz,
+	size_t inw, size_t inh, enum agp_compression fmt);
+
+/*
+ * number of bytes needed to store [inw]*[inh] pixels in format [fmt]
+ */
+size_t arcan_img_compressed_size(
+	size_t inw, size_t inh, enum agp_compression fmt);
+
 /*
  * make sure that inbuf is propery aligned
  * and matches the native engine color format.
@@ -270,6 +270,21 @@ static int fsrv_ok =
 #endif
 ;
 
+/* in deferred collection mode, each incremental step is requested at this
+ * size (kb) and the automatic collector is re-enabled if the heap grows past
+ * FACTOR * live size after the last completed cycle (or MIN kb over it) */
+#ifndef GC_STEP_KB
+#define GC_STEP_KB 64
+#endif
+
+#ifndef GC_PRESSURE_FACTOR
+#define GC_PRESSURE_FACTOR 4
+#endif
+
+#ifndef GC_PRESSURE_MIN
+#define GC_PRESSURE_MIN 16384
+#endif
+
 #define FATAL_MSG_FRAMESERV "specified destination is not a frameserver.\n"
 
 /* we map the constants here so that poor or confused
@@ -349,6 +364,13 @@ static struct {
 	uint8_t* trace_buffer;
 	size_t trace_buffer_sz;
 	intptr_t trace_cb;
+
+/* deferred collection state, see arcan_lua_gcstep */
+	struct {
+		lua_State* ctx;
+		bool automatic;
+		size_t live_kb;
+	} gc;
 } luactx = {0};
 
 extern char* _n_strdup(const char* instr, const char* alt);
@@ -995,6 +1017,68 @@ void arcan_lua_tick(lua_State* ctx, size_t nticks, size_t global)
 /* trace job finished? unpack into table of tables */
 	if (luactx.got_trace_buffer)
 		finish_trace_buffer(ctx);
+
+/* the collector is stopped and we rely on the conductor to provide time, if
+ * the appl allocates faster than we get to collect, fall back to automatic
+ * until the next completed cycle rather than growing without bounds */
+	if (luactx.gc.ctx == ctx && !luactx.gc.automatic){
+		size_t kb = lua_gc(ctx, LUA_GCCOUNT, 0);
+		size_t lim = luactx.gc.live_kb * GC_PRESSURE_FACTOR;
+		if (lim < luactx.gc.live_kb + GC_PRESSURE_MIN)
+			lim = luactx.gc.live_kb + GC_PRESSURE_MIN;
+
+		if (kb > lim){
+			TRACE_MARK_ONESHOT("scripting", "gc-pressure",
+				TRACE_SYS_WARN, 0, kb, "automatic");
+			luactx.gc.automatic = true;
+			lua_gc(ctx, LUA_GCRESTART, 0);
+		}
+	}
+}
+
+bool arcan_lua_gcstep(lua_State* ctx, unsigned budget)
+{
+/* first time we see this state, stop the collector and use the current
+ * count as the baseline for detecting pressure */
+	if (luactx.gc.ctx != ctx){
+		luactx.gc.ctx = ctx;
+		luactx.gc.automatic = false;
+		luactx.gc.live_kb = lua_gc(ctx, LUA_GCCOUNT, 0);
+		lua_gc(ctx, LUA_GCSTOP, 0);
+	}
+
+	if (!budget)
+		return false;
+
+	bool done = false;
+	unsigned long long start = arcan_timemicros();
+	unsigned long long end = start + budget * 1000;
+	size_t nsteps = 0;
+
+	TRACE_MARK_ENTER("scripting", "gc-step", TRACE_SYS_DEFAULT, 0, budget, "");
+
+/* an explicit step re-arms the internal threshold so the collector needs to
+ * be stopped again afterwards unless we are in the pressure fallback */
+	while (arcan_timemicros() < end){
+		nsteps++;
+		if (lua_gc(ctx, LUA_GCSTEP, GC_STEP_KB)){
+			done = true;
+			break;
+		}
+	}
+
+	if (done){
+		luactx.gc.live_kb = lua_gc(ctx, LUA_GCCOUNT, 0);
+		luactx.gc.automatic = false;
+	}
+
+	if (!luactx.gc.automatic)
+		lua_gc(ctx, LUA_GCSTOP, 0);
+
+	TRACE_MARK_EXIT("scripting", "gc-step", TRACE_SYS_DEFAULT,
+		0, nsteps, done ? "cycle" : "partial");
+
+	return done;
 }
 
 char* arcan_lua_main(lua_State* ctx, const char* inp, bool file)
@@ -2284,10 +2368,12 @@ static int imageresizestorage(lua_State* ctx)
 
 	vobj->origw = w;
 	vobj->origh = h;
+	FLAG_PICK_OBJ(vobj);
 
 	struct rendertarget* rtgt = arcan_vint_findrt(vobj);
 	if (rtgt){
 		agp_resize_rendertarget(rtgt->art, w, h);
+		FLAG_PICK_RT(rtgt);
 
 		ssize_t view_w = luaL_optnumber(ctx, 4, w);
 		ssize_t view_h = luaL_optnumber(ctx, 5, h);
@@ -7604,6 +7690,8 @@ void arcan_lua_shutdown(lua_State* ctx)
 	if (luactx.got_trace_buffer){
 		finish_trace_buffer(ctx);
 	}
+	if (luactx.gc.ctx == ctx)
+		luactx.gc.ctx = NULL;
 	lua_close(ctx);
 }
 
@@ -8777,6 +8865,54 @@ static int targetverbose(lua_State* ctx)
 	LUA_ETRACE("target_verbose", NULL, 0);
 }
 
+static int targetmetrics(lua_State* ctx)
+{
+	LUA_TRACE("target_metrics");
+	arcan_vobject* vobj;
+	luaL_checkvid(ctx, 1, &vobj);
+
+	struct arcan_frameserver* fsrv = vobj->feed.state.ptr;
+	if (vobj->feed.state.tag != ARCAN_TAG_FRAMESERV || !fsrv)
+		arcan_fatal("target_metrics() - vid is not a frameserver\n");
+
+/* the ring size is always a power of two, masking also keeps us sane if the
+ * client has scribbled over the indices, the guard covers the segment being
+ * truncated underneath us */
+	size_t qsz = fsrv->inqueue.eventbuf_sz;
+	volatile size_t pending = 0;
+	if (qsz && fsrv->inqueue.front && fsrv->inqueue.back){
+		jmp_buf tramp;
+		if (0 == setjmp(tramp)){
+			platform_fsrv_enter(fsrv, tramp);
+			pending = (*fsrv->inqueue.back - *fsrv->inqueue.front) & (qsz - 1);
+		}
+		platform_fsrv_leave();
+	}
+
+	lua_newtable(ctx);
+	lua_pushstring(ctx, "queue_size");
+	lua_pushnumber(ctx, qsz);
+	lua_rawset(ctx, -3);
+
+	lua_pushstring(ctx, "pending");
+	lua_pushnumber(ctx, pending);
+	lua_rawset(ctx, -3);
+
+	lua_pushstring(ctx, "overflow");
+	lua_pushnumber(ctx, fsrv->evstats.overflow);
+	lua_rawset(ctx, -3);
+
+	lua_pushstring(ctx, "drain");
+	lua_pushnumber(ctx, fsrv->evstats.drain);
+	lua_rawset(ctx, -3);
+
+	lua_pushstring(ctx, "dropped");
+	lua_pushnumber(ctx, fsrv->evstats.dropped);
+	lua_rawset(ctx, -3);
+
+	LUA_ETRACE("target_metrics", NULL, 1);
+}
+
 static int targetskipmodecfg(lua_State* ctx)
 {
 	LUA_TRACE("target_framemode");
@@ -9911,6 +10047,7 @@ static int procimage_histo(lua_State* ctx)
 
 	arcan_vobject* vobj;
 	luaL_checkvid(ctx, 2, &vobj);
+	arcan_vint_atlas_detach(vobj);
 
 	if (!vobj->vstore || vobj->vstore->txmapped == TXSTATE_OFF ||
 		!vobj->vstore->vinf.text.raw)
@@ -10302,6 +10439,7 @@ static int imagestorage(lua_State* ctx)
 
 	arcan_vobject* vobj;
 	luaL_checkvid(ctx, 1, &vobj);
+	arcan_vint_atlas_detach(vobj);
 
 	if (vobj->vstore->txmapped != TXSTATE_TEX2D){
 		arcan_warning("image_access_storage(), referenced object "
@@ -10385,8 +10523,9 @@ static int spawn_recsubseg(lua_State* ctx,
 	shmpage->w = dobj->vstore->w;
 	shmpage->h = dobj->vstore->h;
 	rv->vbuf_cnt = rv->abuf_cnt = 1;
-	arcan_shmif_mapav(shmpage, rv->vbufs, 1, dobj->vstore->w *
-		dobj->vstore->h * sizeof(shmif_pixel), rv->abufs, 1, 32768);
+	arcan_shmif_mapav(shmpage, rv->inqueue.eventbuf_sz,
+		rv->vbufs, 1, dobj->vstore->w * dobj->vstore->h * sizeof(shmif_pixel),
+		rv->abufs, 1, 32768);
 	arcan_video_alterfeed(did, FFUNC_AVFEED, fftag);
 
 /* similar restrictions and problems as in spawn_recfsrv with the
@@ -11111,7 +11250,17 @@ static int getbenchvals(lua_State* ctx)
 		i = (i + 1) % bench_sz;
 	}
 
-	LUA_ETRACE("benchmark_data", NULL, 6);
+	lua_pushnumber(ctx, benchdata.drawcalls);
+	lua_pushnumber(ctx, benchdata.culled);
+	lua_pushnumber(ctx, benchdata.occluded);
+	lua_pushnumber(ctx, benchdata.programs);
+	lua_pushnumber(ctx, benchdata.textures);
+	lua_pushnumber(ctx, benchdata.uniforms);
+	lua_pushnumber(ctx, benchdata.skipped);
+	lua_pushnumber(ctx, arcan_conductor_transfer_cost());
+	lua_pushnumber(ctx, arcan_conductor_workers());
+
+	LUA_ETRACE("benchmark_data", NULL, 15);
 }
 
 static int timestamp(lua_State* ctx)
@@ -12365,6 +12514,7 @@ static const luaL_Reg tgtfuns[] = {
 {"target_portconfig",          targetportcfg            },
 {"target_framemode",           targetskipmodecfg        },
 {"target_verbose",             targetverbose            },
+{"target_metrics",             targetmetrics            },
 {"target_synchronous",         targetsynchronous        },
 {"target_flags",               targetflags              },
 {"target_graphmode",           targetgraph              },
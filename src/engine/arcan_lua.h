@@ -41,6 +41,14 @@ void arcan_lua_cbdrop();
 void arcan_lua_shutdown(struct arcan_luactx*);
 void arcan_lua_tick(struct arcan_luactx*, size_t, size_t);
 
+/* switch the context to deferred garbage collection (first call) and run
+ * incremental collection steps for at most [budget] milliseconds. This is
+ * intended for periods where the engine would otherwise idle, e.g. waiting
+ * for display synch. If the heap grows too fast between calls, the normal
+ * automatic collector is re-enabled until a cycle completes. Returns true
+ * if a full collection cycle was completed. */
+bool arcan_lua_gcstep(struct arcan_luactx*, unsigned budget);
+
 /* access the last known crash source, used when a [callvoidfun] has
  * failed and longjumped into the set jump buffer */
 const char* arcan_lua_crash_source(struct arcan_luactx*);
@@ -242,6 +242,7 @@ static void fatal_shutdown()
 {
 	arcan_audio_shutdown();
 	arcan_video_shutdown(false);
+	arcan_trace_setstream(NULL);
 }
 
 /* invoked from the conductor when it has processed a monotonic tick */
@@ -374,6 +375,64 @@ int MAIN_REDIR(int argc, char* argv[])
 	arcan_mem_growarr(&arr_hooks);
 
 	settings.in_monitor = getenv("ARCAN_MONITOR_FD") != NULL;
+
+/* stream all trace points from the start so that init costs are included */
+	if (getenv("ARCAN_TRACE_JSON"))
+		arcan_trace_setstream(getenv("ARCAN_TRACE_JSON"));
+
+/* workers for splitting independent per-client jobs, e.g. buffer copies */
+	if (getenv("ARCAN_CONDUCTOR_WORKERS"))
+		arcan_conductor_set_workers(
+			strtoul(getenv("ARCAN_CONDUCTOR_WORKERS"), NULL, 10));
+
+/* event ring size for new clients, chatty ones (input- heavy, tui) drain
+ * less often with larger rings */
+	if (getenv("ARCAN_EVENT_QUEUE_SZ"))
+		platform_fsrv_default_queuesz(
+			strtoul(getenv("ARCAN_EVENT_QUEUE_SZ"), NULL, 10));
+
+	if (getenv("ARCAN_VIDEO_BATCH"))
+		arcan_video_batch_draws(true);
+
+	if (getenv("ARCAN_VIDEO_ATLAS"))
+		arcan_video_atlas(true);
+
+	if (getenv("ARCAN_VIDEO_DAMAGE"))
+		arcan_video_damage(true);
+
+	if (getenv("ARCAN_VIDEO_TRANSFORM_BATCH"))
+		arcan_video_batch_transforms(true);
+
+	if (getenv("ARCAN_VIDEO_TICKALL"))
+		arcan_video_active_set(false);
+
+	if (getenv("ARCAN_VIDEO_PICKINDEX"))
+		arcan_video_pick_index(true);
+
+	if (getenv("ARCAN_VIDEO_NOCULL") || getenv("ARCAN_VIDEO_OCCLUSION"))
+		arcan_video_culling(getenv("ARCAN_VIDEO_NOCULL") == NULL,
+			getenv("ARCAN_VIDEO_OCCLUSION") != NULL);
+
+	if (getenv("ARCAN_VIDEO_DECODE_CACHE"))
+		arcan_video_decode_cache(
+			strtoul(getenv("ARCAN_VIDEO_DECODE_CACHE"), NULL, 10) * 1024 * 1024);
+
+	if (getenv("ARCAN_VIDEO_COMPRESS"))
+		arcan_video_compress(true,
+			strcmp(getenv("ARCAN_VIDEO_COMPRESS"), "force") == 0);
+
+	if (getenv("ARCAN_VIDEO_NOSHADERCACHE"))
+		arcan_video_shader_cache(false);
+
+	if (getenv("ARCAN_VIDEO_NOFRAMECACHE"))
+		arcan_video_frame_cache(false);
+
+	if (getenv("ARCAN_VIDEO_PARALLEL_RT"))
+		arcan_video_parallel_rendertargets(true);
+
+	if (getenv("ARCAN_CONDUCTOR_NOGCDEFER"))
+		arcan_conductor_gcdefer(false);
+
 	bool windowed = false;
 	bool fullscreen = false;
 	bool conservative = false;
@@ -877,6 +936,7 @@ run_loop:
 	arcan_event_deinit(evctx);
 	arcan_audio_shutdown();
 	arcan_video_shutdown(exit_code != 256);
+	arcan_trace_setstream(NULL);
 	arcan_mem_free(dbfname);
 	if (dbhandle){
 		arcan_db_close(&dbhandle);
@@ -899,6 +959,7 @@ error:
 	arcan_mem_free(dbfname);
 	arcan_audio_shutdown();
 	arcan_video_shutdown(false);
+	arcan_trace_setstream(NULL);
 
 /* now that video has been shut down, it should be safe to write the
  * last known Lua VM crash state information to stdout without risking
@@ -537,6 +537,50 @@ vector interp_3d_sine(vector sv, vector ev, float fract)
 	return res;
 }
 
+#ifndef ARCAN_MATH_SIMD
+void interp_batch_linear(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		dst[i] = interp_1d_linear(sv[i], ev[i], fract[i]);
+}
+
+void interp_batch_sine(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		dst[i] = interp_1d_sine(sv[i], ev[i], fract[i]);
+}
+
+void interp_batch_expin(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		dst[i] = interp_1d_expin(sv[i], ev[i], fract[i]);
+}
+
+void interp_batch_expout(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		dst[i] = interp_1d_expout(sv[i], ev[i], fract[i]);
+}
+
+void interp_batch_expinout(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		dst[i] = interp_1d_expinout(sv[i], ev[i], fract[i]);
+}
+
+void interp_batch_smoothstep(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		dst[i] = interp_1d_smoothstep(sv[i], ev[i], fract[i]);
+}
+#endif
+
 static inline quat slerp_quatfl(quat a, quat b, float fact, bool r360)
 {
 	float weight_a, weight_b;
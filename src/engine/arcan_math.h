@@ -113,6 +113,22 @@ vector interp_3d_expin(vector startv, vector endv, float fract);
 vector interp_3d_expinout(vector startv, vector endv, float fract);
 vector interp_3d_smoothstep(vector startv, vector endv, float fract);
 
+/* batch versions of the 1d interpolators for n independent entries,
+ * dst[i] = sv[i] + (ev[i] - sv[i]) * weight(fract[i]). The SIMD versions
+ * approximate the sine and exponential weights (< 1e-5 error). */
+void interp_batch_linear(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n);
+void interp_batch_sine(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n);
+void interp_batch_expin(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n);
+void interp_batch_expout(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n);
+void interp_batch_expinout(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n);
+void interp_batch_smoothstep(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n);
+
 void update_view(orientation* dst, float roll, float pitch, float yaw);
 
 /* camera / view functions */
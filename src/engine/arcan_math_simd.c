@@ -150,3 +150,165 @@ void multiply_matrix(float* restrict dst,
 #endif
 }
 
+
+/*
+ * Batch interpolation, all the interpolators share the form
+ * sv + (ev - sv) * weight(fract) so the weights are evaluated four at a time
+ * and the tail falls back to the scalar version. The weight arguments are
+ * always in a known range (fract in [0, 1]) so the sine and the exponent can
+ * be approximated with short polynomials instead of the libm calls.
+ */
+typedef __m128 (*batch_weight)(__m128 fract);
+typedef float (*batch_scalar)(float, float, float);
+
+/* 2^x for x <= 0, integer part goes into the exponent bits and the fraction
+ * through a 7th degree taylor series (~1e-6 relative error) */
+static inline __m128 exp2_ps(__m128 x)
+{
+	x = _mm_max_ps(x, _mm_set1_ps(-126.0f));
+
+/* truncation rounds towards zero, step down for negative fractions */
+	__m128 xf = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+	xf = _mm_sub_ps(xf, _mm_and_ps(_mm_cmpgt_ps(xf, x), _mm_set1_ps(1.0f)));
+	__m128 f = _mm_sub_ps(x, xf);
+
+	__m128 p = _mm_set1_ps(1.5252734e-5f);
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.5403530e-4f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.3333558e-3f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(9.6181291e-3f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(5.5504109e-2f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(2.4022651e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(6.9314718e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+
+	__m128i e = _mm_slli_epi32(
+		_mm_add_epi32(_mm_cvttps_epi32(xf), _mm_set1_epi32(127)), 23);
+
+	return _mm_mul_ps(p, _mm_castsi128_ps(e));
+}
+
+/* the scalar versions return sv as is for fract < EPSILON */
+static inline __m128 mask_start(__m128 w, __m128 fract)
+{
+	return _mm_and_ps(w, _mm_cmpge_ps(fract, _mm_set1_ps(EPSILON)));
+}
+
+static inline __m128 weight_linear(__m128 fract)
+{
+	return fract;
+}
+
+/* sin(0.5 * pi * fract), 11th degree taylor series on [0, pi/2] */
+static inline __m128 weight_sine(__m128 fract)
+{
+	__m128 x = _mm_mul_ps(fract, _mm_set1_ps(0.5f * M_PI));
+	__m128 x2 = _mm_mul_ps(x, x);
+
+	__m128 p = _mm_set1_ps(-1.0f / 39916800.0f);
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 362880.0f));
+	p = _mm_sub_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 5040.0f));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 120.0f));
+	p = _mm_sub_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 6.0f));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+
+	return _mm_mul_ps(p, x);
+}
+
+static inline __m128 weight_expin(__m128 fract)
+{
+	__m128 x = _mm_mul_ps(_mm_set1_ps(10.0f),
+		_mm_sub_ps(fract, _mm_set1_ps(1.0f)));
+
+	return mask_start(exp2_ps(x), fract);
+}
+
+static inline __m128 weight_expout(__m128 fract)
+{
+	__m128 x = _mm_mul_ps(_mm_set1_ps(-10.0f), fract);
+
+	return mask_start(_mm_sub_ps(_mm_set1_ps(1.0f), exp2_ps(x)), fract);
+}
+
+static inline __m128 weight_expinout(__m128 fract)
+{
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 lower = _mm_cmplt_ps(fract, half);
+
+/* fold the two halves into one exponent, 20f - 10 and -20f + 10 */
+	__m128 x = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(20.0f), fract),
+		_mm_set1_ps(10.0f));
+	x = _mm_or_ps(_mm_and_ps(lower, x),
+		_mm_andnot_ps(lower, _mm_sub_ps(_mm_setzero_ps(), x)));
+
+	__m128 e = _mm_mul_ps(half, exp2_ps(x));
+	__m128 w = _mm_or_ps(_mm_and_ps(lower, e),
+		_mm_andnot_ps(lower, _mm_sub_ps(_mm_set1_ps(1.0f), e)));
+
+	__m128 end = _mm_cmpgt_ps(fract, _mm_set1_ps(1.0f - EPSILON));
+	w = _mm_or_ps(_mm_and_ps(end, _mm_set1_ps(1.0f)), _mm_andnot_ps(end, w));
+
+	return mask_start(w, fract);
+}
+
+static inline __m128 weight_smoothstep(__m128 fract)
+{
+	__m128 r = _mm_mul_ps(_mm_sub_ps(fract, _mm_set1_ps(0.1f)),
+		_mm_set1_ps(1.0f / 0.8f));
+	r = _mm_min_ps(_mm_max_ps(r, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+	return _mm_mul_ps(_mm_mul_ps(r, r),
+		_mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), r)));
+}
+
+static inline void interp_batch(float* restrict dst,
+	const float* restrict sv, const float* restrict ev,
+	const float* restrict fract, size_t n, batch_weight weight, batch_scalar tail)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= n; i += 4){
+		__m128 a = _mm_loadu_ps(&sv[i]);
+		__m128 b = _mm_loadu_ps(&ev[i]);
+		__m128 w = weight(_mm_loadu_ps(&fract[i]));
+		_mm_storeu_ps(&dst[i], _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), w)));
+	}
+
+	for (; i < n; i++)
+		dst[i] = tail(sv[i], ev[i], fract[i]);
+}
+
+void interp_batch_linear(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	interp_batch(dst, sv, ev, fract, n, weight_linear, interp_1d_linear);
+}
+
+void interp_batch_sine(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	interp_batch(dst, sv, ev, fract, n, weight_sine, interp_1d_sine);
+}
+
+void interp_batch_expin(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	interp_batch(dst, sv, ev, fract, n, weight_expin, interp_1d_expin);
+}
+
+void interp_batch_expout(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	interp_batch(dst, sv, ev, fract, n, weight_expout, interp_1d_expout);
+}
+
+void interp_batch_expinout(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	interp_batch(dst, sv, ev, fract, n, weight_expinout, interp_1d_expinout);
+}
+
+void interp_batch_smoothstep(float* restrict dst, const float* restrict sv,
+	const float* restrict ev, const float* restrict fract, size_t n)
+{
+	interp_batch(dst, sv, ev, fract, n, weight_smoothstep, interp_1d_smoothstep);
+}
@@ -623,6 +623,7 @@ static char* extract_vidref(struct text_format* prev, char* base, bool ext)
 		return NULL;
 	}
 
+	arcan_vint_atlas_detach(vobj);
 	struct agp_vstore* vs = vobj->vstore;
 	if (vs->txmapped != TXSTATE_TEX2D){
 		arcan_warning(
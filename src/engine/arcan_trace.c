@@ -6,6 +6,9 @@
 #include <unistd.h>
 #include <string.h>
 #include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
 
 #include "arcan_math.h"
 #include "arcan_general.h"
@@ -17,6 +20,267 @@ static size_t buffer_sz;
 static size_t buffer_pos;
 static bool* buffer_flag;
 
+/*
+ * The streaming output uses a fixed ring of pre-sized samples so that the
+ * producer side (whatever thread calls arcan_trace_mark) never touches the
+ * file descriptor. The writer thread drains the ring and formats the samples
+ * as chrome trace-event JSON. Should the ring be full, the sample is dropped
+ * and the drop counter exposed as a counter event in the output so that the
+ * capture doesn't silently lie about what happened.
+ */
+#define STREAM_RING_SZ 8192
+
+struct stream_sample {
+	uint64_t ts;
+	uint64_t ident;
+	uint32_t quant;
+	uint8_t trigger;
+	uint8_t tracelevel;
+	uint16_t thread;
+	char sys[16];
+	char subsys[32];
+	char message[48];
+};
+
+static struct {
+	FILE* fout;
+	pthread_t writer;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool alive;
+
+	struct stream_sample ring[STREAM_RING_SZ];
+	size_t head;
+	size_t tail;
+	size_t dropped;
+
+/* map each system and producing thread to its own 'thread' lane in the
+ * viewer so that enter/exit pairs from different systems or from workers
+ * running in parallel don't need to nest within each other */
+	struct {
+		char sys[16];
+		uint16_t thread;
+	} lanes[64];
+	size_t n_lanes;
+	bool first;
+
+/* the thread that set up the stream gets index 0, any other producer draws
+ * the next index the first time it marks something */
+	pthread_t main;
+	_Atomic uint16_t thread_seq;
+} stream = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER
+};
+
+static void json_string(FILE* fout, const char* str)
+{
+	fputc('"', fout);
+	for (; *str; str++){
+		unsigned char ch = *str;
+		if (ch == '"' || ch == '\\'){
+			fputc('\\', fout);
+			fputc(ch, fout);
+		}
+		else if (ch < 0x20)
+			fprintf(fout, "\\u%04x", ch);
+		else
+			fputc(ch, fout);
+	}
+	fputc('"', fout);
+}
+
+static _Thread_local uint16_t thread_ind;
+static _Thread_local bool thread_set;
+
+static uint16_t stream_thread()
+{
+	if (!thread_set){
+		thread_set = true;
+		thread_ind = pthread_equal(pthread_self(), stream.main) ?
+			0 : atomic_fetch_add(&stream.thread_seq, 1) + 1;
+	}
+	return thread_ind;
+}
+
+static size_t stream_lane(const char* sys, uint16_t thread)
+{
+	for (size_t i = 0; i < stream.n_lanes; i++)
+		if (stream.lanes[i].thread == thread &&
+			strcmp(stream.lanes[i].sys, sys) == 0)
+			return i + 1;
+
+/* out of lanes, share the last one rather than fail */
+	if (stream.n_lanes == sizeof(stream.lanes) / sizeof(stream.lanes[0]))
+		return stream.n_lanes;
+
+	snprintf(stream.lanes[stream.n_lanes].sys,
+		sizeof(stream.lanes[0].sys), "%s", sys);
+	stream.lanes[stream.n_lanes].thread = thread;
+	stream.n_lanes++;
+
+	char name[32];
+	if (thread)
+		snprintf(name, sizeof(name), "%s:worker%"PRIu16, sys, thread);
+	else
+		snprintf(name, sizeof(name), "%s", sys);
+
+	fprintf(stream.fout, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+		"\"tid\":%zu,\"args\":{\"name\":", stream.first ? "" : ",\n", stream.n_lanes);
+	json_string(stream.fout, name);
+	fputs("}}", stream.fout);
+	stream.first = false;
+
+	return stream.n_lanes;
+}
+
+static void stream_write(struct stream_sample* s)
+{
+	static const char* levels[] = {"default", "slow", "fast", "warning", "error"};
+	char ph = s->trigger == 1 ? 'B' : (s->trigger == 2 ? 'E' : 'i');
+	size_t lane = stream_lane(s->sys, s->thread);
+
+	fprintf(stream.fout, "%s{\"name\":", stream.first ? "" : ",\n");
+	json_string(stream.fout, s->subsys);
+	fputs(",\"cat\":", stream.fout);
+	json_string(stream.fout, s->sys);
+	fprintf(stream.fout, ",\"ph\":\"%c\",\"ts\":%"PRIu64",\"pid\":1,\"tid\":%zu,%s"
+		"\"args\":{\"ident\":%"PRIu64",\"quant\":%"PRIu32",\"level\":\"%s\",\"message\":",
+		ph, s->ts, lane, ph == 'i' ? "\"s\":\"t\"," : "",
+		s->ident, s->quant,
+		s->tracelevel < sizeof(levels) / sizeof(levels[0]) ? levels[s->tracelevel] : "broken"
+	);
+	json_string(stream.fout, s->message);
+	fputs("}}", stream.fout);
+	stream.first = false;
+}
+
+static void* stream_writer(void* arg)
+{
+	pthread_mutex_lock(&stream.lock);
+
+	while (stream.alive || stream.head != stream.tail){
+		if (stream.head == stream.tail){
+			struct timespec ts;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_nsec += 100 * 1000000;
+			if (ts.tv_nsec >= 1000000000){
+				ts.tv_sec++;
+				ts.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&stream.cond, &stream.lock, &ts);
+			continue;
+		}
+
+/* grab a contiguous span and release the lock while formatting, the
+ * producer can't touch these slots until tail has been moved */
+		size_t tail = stream.tail;
+		size_t end = stream.head > tail ? stream.head : STREAM_RING_SZ;
+		size_t dropped = stream.dropped;
+		stream.dropped = 0;
+		pthread_mutex_unlock(&stream.lock);
+
+		if (dropped){
+			fprintf(stream.fout, "%s{\"name\":\"trace-dropped\",\"ph\":\"C\","
+				"\"ts\":%"PRIu64",\"pid\":1,\"args\":{\"samples\":%zu}}",
+				stream.first ? "" : ",\n", stream.ring[tail].ts, dropped);
+			stream.first = false;
+		}
+
+		for (size_t i = tail; i < end; i++)
+			stream_write(&stream.ring[i]);
+
+		pthread_mutex_lock(&stream.lock);
+		stream.tail = end % STREAM_RING_SZ;
+	}
+
+	pthread_mutex_unlock(&stream.lock);
+	return NULL;
+}
+
+static void stream_close()
+{
+	if (!stream.fout)
+		return;
+
+	pthread_mutex_lock(&stream.lock);
+	stream.alive = false;
+	pthread_cond_signal(&stream.cond);
+	pthread_mutex_unlock(&stream.lock);
+	pthread_join(stream.writer, NULL);
+
+	fputs("\n]}\n", stream.fout);
+	fclose(stream.fout);
+	stream.fout = NULL;
+	arcan_trace_enabled = buffer != NULL;
+}
+
+bool arcan_trace_setstream(const char* path)
+{
+	stream_close();
+	if (!path)
+		return true;
+
+	FILE* fout = fopen(path, "w");
+	if (!fout){
+		arcan_warning("trace_stream(), couldn't open (%s) for writing\n", path);
+		return false;
+	}
+
+	stream.fout = fout;
+	stream.head = stream.tail = stream.dropped = 0;
+	stream.n_lanes = 0;
+	stream.first = true;
+	stream.main = pthread_self();
+	stream.alive = true;
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", fout);
+
+	if (0 != pthread_create(&stream.writer, NULL, stream_writer, NULL)){
+		arcan_warning("trace_stream(), couldn't spawn writer thread\n");
+		stream.alive = false;
+		fclose(fout);
+		stream.fout = NULL;
+		return false;
+	}
+
+	arcan_trace_enabled = true;
+	return true;
+}
+
+static void stream_mark(uint64_t ts,
+	const char* sys, const char* subsys, uint8_t trigger,
+	uint8_t tracelevel, uint64_t ident, uint32_t quant, const char* message)
+{
+	pthread_mutex_lock(&stream.lock);
+	size_t next = (stream.head + 1) % STREAM_RING_SZ;
+	if (next == stream.tail){
+		stream.dropped++;
+		pthread_mutex_unlock(&stream.lock);
+		return;
+	}
+
+	struct stream_sample* s = &stream.ring[stream.head];
+	*s = (struct stream_sample){
+		.ts = ts,
+		.ident = ident,
+		.quant = quant,
+		.trigger = trigger,
+		.tracelevel = tracelevel,
+		.thread = stream_thread()
+	};
+	snprintf(s->sys, sizeof(s->sys), "%s", sys);
+	snprintf(s->subsys, sizeof(s->subsys), "%s", subsys);
+	snprintf(s->message, sizeof(s->message), "%s", message ? message : "");
+	stream.head = next;
+
+/* wake the writer at half capacity rather than per sample */
+	size_t used = (stream.head + STREAM_RING_SZ - stream.tail) % STREAM_RING_SZ;
+	if (used == STREAM_RING_SZ >> 1)
+		pthread_cond_signal(&stream.cond);
+
+	pthread_mutex_unlock(&stream.lock);
+}
+
 void arcan_trace_setbuffer(uint8_t* buf, size_t buf_sz, bool* finish_flag)
 {
 	if (buffer){
@@ -24,7 +288,7 @@ void arcan_trace_setbuffer(uint8_t* buf, size_t buf_sz, bool* finish_flag)
 		buffer = NULL;
 		buffer_flag = NULL;
 		buffer_pos = 0;
-		arcan_trace_enabled = false;
+		arcan_trace_enabled = stream.fout != NULL;
 	}
 
 	if (!buf || !buf_sz)
@@ -57,6 +321,13 @@ void arcan_trace_mark(
 	if (!arcan_trace_enabled)
 		return;
 
+	uint64_t ts = arcan_timemicros();
+	if (stream.fout)
+		stream_mark(ts, sys, subsys, trigger, tracelevel, ident, quant, message);
+
+	if (!buffer)
+		return;
+
 	size_t start_ofs = buffer_pos;
 
 	size_t sys_len = strlen(sys) + 1;
@@ -81,7 +352,6 @@ void arcan_trace_mark(
 	buffer_pos++;
 
 /* timestamp */
-	uint64_t ts = arcan_timemicros();
 	memcpy(&buffer[buffer_pos], &ts, sizeof(ts));
 	buffer_pos += sizeof(ts);
 
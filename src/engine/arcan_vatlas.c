@@ -0,0 +1,590 @@
+/*
+ * Copyright 2026, Arcan contributors
+ * License: 3-Clause BSD, see COPYING file in arcan source repository.
+ * Reference: http://arcan-fe.com
+ * Description: Sub-allocation of small static images from shared texture
+ * pages, so that many objects sample the same store and can be drawn without
+ * rebinding (and be merged into the same draw batch).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "arcan_math.h"
+#include "arcan_general.h"
+#include "arcan_shmif.h"
+#include "arcan_event.h"
+#include "arcan_video.h"
+#include "arcan_videoint.h"
+
+/*
+ * Pages are packed bottom-left with a skyline. Each region gets a gutter
+ * where the edge pixels are repeated so that filtering at the border does
+ * not pull in the neighbours. Repeat- wrapping and mipmaps can't work on a
+ * sub-region, so such stores are left alone.
+ *
+ * A skyline can't reuse the holes left by deleted regions. When a deletion
+ * leaves the packed part of a page mostly unused, the live regions are
+ * repacked into a fresh skyline and the texture coordinates of all objects
+ * that reference them are updated.
+ */
+#ifndef VATLAS_PAGE
+#define VATLAS_PAGE 1024
+#endif
+
+#ifndef VATLAS_MAXDIM
+#define VATLAS_MAXDIM 256
+#endif
+
+#define VATLAS_GUTTER 1
+
+struct vatlas_node {
+	uint16_t x, y, w;
+};
+
+struct vatlas_skyline {
+	struct vatlas_node* nodes;
+	size_t n_nodes;
+};
+
+struct vatlas_slot {
+	struct vatlas_page* page;
+	struct vatlas_slot* next;
+
+/* all objects that sample this region, linked through vobj->atlas.next */
+	arcan_vobject* users;
+
+/* the source reference of the store that was moved into the page */
+	char* source;
+
+/* x, y is the origin of the region including the gutter, w, h the contents */
+	size_t x, y, w, h;
+};
+
+struct vatlas_page {
+	struct agp_vstore* store;
+	struct vatlas_page* next;
+	struct vatlas_page** owner;
+	struct vatlas_slot* slots;
+	struct vatlas_skyline sky;
+
+/* pixels in live regions vs. pixels handed out since the last repack */
+	size_t used, packed;
+};
+
+static size_t padded(size_t v)
+{
+	return v + 2 * VATLAS_GUTTER;
+}
+
+static void skyline_reset(struct vatlas_skyline* sky)
+{
+	sky->nodes[0] = (struct vatlas_node){.x = 0, .y = 0, .w = VATLAS_PAGE};
+	sky->n_nodes = 1;
+}
+
+static bool skyline_fit(
+	struct vatlas_skyline* sky, size_t i, size_t w, size_t h, size_t* y)
+{
+	if (sky->nodes[i].x + w > VATLAS_PAGE)
+		return false;
+
+/* the nodes always cover the full width, so this can't step past the end */
+	size_t left = w;
+	size_t ry = sky->nodes[i].y;
+
+	while (left > 0){
+		if (sky->nodes[i].y > ry)
+			ry = sky->nodes[i].y;
+
+		if (ry + h > VATLAS_PAGE)
+			return false;
+
+		if (sky->nodes[i].w >= left)
+			break;
+
+		left -= sky->nodes[i].w;
+		i++;
+	}
+
+	*y = ry;
+	return true;
+}
+
+static bool skyline_insert(
+	struct vatlas_skyline* sky, size_t w, size_t h, size_t* x, size_t* y)
+{
+	struct vatlas_node* nodes = sky->nodes;
+	size_t best = SIZE_MAX, best_y = SIZE_MAX, best_w = SIZE_MAX;
+
+/* lowest resulting top edge, ties go to the narrowest node */
+	for (size_t i = 0; i < sky->n_nodes; i++){
+		size_t cy;
+		if (!skyline_fit(sky, i, w, h, &cy))
+			continue;
+
+		if (cy + h < best_y || (cy + h == best_y && nodes[i].w < best_w)){
+			best = i;
+			best_y = cy + h;
+			best_w = nodes[i].w;
+		}
+	}
+
+	if (best == SIZE_MAX)
+		return false;
+
+	*x = nodes[best].x;
+	*y = best_y - h;
+
+/* new node for the top edge of the region, then trim the ones it shadows */
+	size_t n = sky->n_nodes;
+	memmove(&nodes[best + 1], &nodes[best], (n - best) * sizeof(struct vatlas_node));
+	nodes[best] = (struct vatlas_node){.x = *x, .y = best_y, .w = w};
+	n++;
+
+	for (size_t i = best + 1; i < n; i++){
+		size_t end = nodes[i - 1].x + nodes[i - 1].w;
+		if (nodes[i].x >= end)
+			break;
+
+		size_t shrink = end - nodes[i].x;
+		if (nodes[i].w > shrink){
+			nodes[i].x += shrink;
+			nodes[i].w -= shrink;
+			break;
+		}
+
+		memmove(&nodes[i], &nodes[i + 1], (n - i - 1) * sizeof(struct vatlas_node));
+		n--;
+		i--;
+	}
+
+/* and merge neighbours that ended up at the same height */
+	for (size_t i = 0; i + 1 < n;){
+		if (nodes[i].y == nodes[i + 1].y){
+			nodes[i].w += nodes[i + 1].w;
+			memmove(&nodes[i + 1], &nodes[i + 2],
+				(n - i - 2) * sizeof(struct vatlas_node));
+			n--;
+		}
+		else
+			i++;
+	}
+
+	sky->n_nodes = n;
+	return true;
+}
+
+static void slot_mapping(struct vatlas_slot* slot, float* dst)
+{
+	float s1 = (float)(slot->x + VATLAS_GUTTER) / (float) VATLAS_PAGE;
+	float t1 = (float)(slot->y + VATLAS_GUTTER) / (float) VATLAS_PAGE;
+	float s2 = (float)(slot->x + VATLAS_GUTTER + slot->w) / (float) VATLAS_PAGE;
+	float t2 = (float)(slot->y + VATLAS_GUTTER + slot->h) / (float) VATLAS_PAGE;
+
+	dst[0] = s1;
+	dst[1] = t1;
+	dst[2] = s2;
+	dst[3] = t1;
+	dst[4] = s2;
+	dst[5] = t2;
+	dst[6] = s1;
+	dst[7] = t2;
+}
+
+static void slot_blit(av_pixel* page, struct vatlas_slot* slot, av_pixel* src)
+{
+	for (size_t y = 0; y < padded(slot->h); y++){
+		size_t sy = y < VATLAS_GUTTER ? 0 : y - VATLAS_GUTTER;
+		if (sy >= slot->h)
+			sy = slot->h - 1;
+
+		av_pixel* srow = &src[sy * slot->w];
+		av_pixel* drow = &page[(slot->y + y) * VATLAS_PAGE + slot->x];
+
+		for (size_t x = 0; x < VATLAS_GUTTER; x++){
+			drow[x] = srow[0];
+			drow[VATLAS_GUTTER + slot->w + x] = srow[slot->w - 1];
+		}
+
+		memcpy(&drow[VATLAS_GUTTER], srow, slot->w * sizeof(av_pixel));
+	}
+}
+
+/* only the region needs to go to the GPU, the page raw acts as the source */
+static void slot_synch(struct vatlas_slot* slot)
+{
+	struct agp_vstore* store = slot->page->store;
+
+	agp_stream_prepare(store, (struct stream_meta){
+		.buf = store->vinf.text.raw,
+		.dirty = true,
+		.x1 = slot->x,
+		.y1 = slot->y,
+		.w = padded(slot->w),
+		.h = padded(slot->h)
+	}, STREAM_RAW_DIRECT_SYNCHRONOUS);
+}
+
+static struct vatlas_page* page_alloc(
+	struct vatlas_page** owner, struct agp_vstore* tmpl)
+{
+	struct vatlas_page* page = arcan_alloc_mem(sizeof(struct vatlas_page),
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO | ARCAN_MEM_NONFATAL,
+		ARCAN_MEMALIGN_NATURAL
+	);
+
+	struct agp_vstore* store = arcan_alloc_mem(sizeof(struct agp_vstore),
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO | ARCAN_MEM_NONFATAL,
+		ARCAN_MEMALIGN_NATURAL
+	);
+
+/* every insert adds at most one node and every node is at least 1px wide */
+	struct vatlas_node* nodes = arcan_alloc_mem(
+		sizeof(struct vatlas_node) * (VATLAS_PAGE + 1),
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL
+	);
+
+	size_t buf_sz = VATLAS_PAGE * VATLAS_PAGE * sizeof(av_pixel);
+	av_pixel* raw = arcan_alloc_mem(buf_sz,
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_BZERO | ARCAN_MEM_NONFATAL,
+		ARCAN_MEMALIGN_PAGE
+	);
+
+	if (!page || !store || !nodes || !raw){
+		arcan_mem_free(page);
+		arcan_mem_free(store);
+		arcan_mem_free(nodes);
+		arcan_mem_free(raw);
+		return NULL;
+	}
+
+	store->refcount = 1;
+	store->txmapped = TXSTATE_TEX2D;
+	store->txu = tmpl->txu;
+	store->txv = tmpl->txv;
+	store->scale = tmpl->scale;
+	store->imageproc = tmpl->imageproc;
+	store->filtermode = tmpl->filtermode;
+	store->w = VATLAS_PAGE;
+	store->h = VATLAS_PAGE;
+	store->bpp = sizeof(av_pixel);
+	store->vinf.text.raw = raw;
+	store->vinf.text.s_raw = buf_sz;
+	agp_update_vstore(store, true);
+
+	page->store = store;
+	page->sky.nodes = nodes;
+	skyline_reset(&page->sky);
+
+	page->owner = owner;
+	page->next = *owner;
+	*owner = page;
+
+	TRACE_MARK_ONESHOT("video", "atlas-page",
+		TRACE_SYS_DEFAULT, 0, VATLAS_PAGE, "new page");
+
+	return page;
+}
+
+static void page_free(struct vatlas_page* page)
+{
+	struct vatlas_page** cur = page->owner;
+	while (*cur && *cur != page)
+		cur = &(*cur)->next;
+	if (*cur)
+		*cur = page->next;
+
+/* objects that still sample the store hold their own references */
+	arcan_vint_drop_vstore(page->store);
+	arcan_mem_free(page->sky.nodes);
+	arcan_mem_free(page);
+}
+
+static int slot_height_cmp(const void* a, const void* b)
+{
+	const struct vatlas_slot* sa = *(struct vatlas_slot* const*) a;
+	const struct vatlas_slot* sb = *(struct vatlas_slot* const*) b;
+	return sa->h < sb->h ? 1 : (sa->h > sb->h ? -1 : 0);
+}
+
+static void page_compact(struct vatlas_page* page)
+{
+	size_t n = 0;
+	for (struct vatlas_slot* cur = page->slots; cur; cur = cur->next)
+		n++;
+
+	struct vatlas_slot** set = arcan_alloc_mem(sizeof(struct vatlas_slot*) * n,
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+
+	size_t* pos = arcan_alloc_mem(sizeof(size_t) * n * 2,
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+
+	struct vatlas_skyline sky = {
+		.nodes = arcan_alloc_mem(sizeof(struct vatlas_node) * (VATLAS_PAGE + 1),
+			ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL)
+	};
+
+	av_pixel* raw = arcan_alloc_mem(page->store->vinf.text.s_raw,
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_BZERO | ARCAN_MEM_NONFATAL,
+		ARCAN_MEMALIGN_PAGE
+	);
+
+	if (!set || !pos || !sky.nodes || !raw)
+		goto out;
+
+	TRACE_MARK_ENTER("video", "atlas-compact",
+		TRACE_SYS_DEFAULT, 0, n, "repack page");
+
+	n = 0;
+	for (struct vatlas_slot* cur = page->slots; cur; cur = cur->next)
+		set[n++] = cur;
+	qsort(set, n, sizeof(struct vatlas_slot*), slot_height_cmp);
+
+/* place everything before touching the page, if the new order happens to
+ * pack worse than the old one, just keep the old */
+	skyline_reset(&sky);
+	for (size_t i = 0; i < n; i++){
+		if (!skyline_insert(&sky,
+			padded(set[i]->w), padded(set[i]->h), &pos[i * 2], &pos[i * 2 + 1])){
+			TRACE_MARK_EXIT("video", "atlas-compact",
+				TRACE_SYS_WARN, 0, n, "couldn't repack");
+			goto out;
+		}
+	}
+
+	av_pixel* old = page->store->vinf.text.raw;
+	for (size_t i = 0; i < n; i++){
+		struct vatlas_slot* slot = set[i];
+
+		for (size_t y = 0; y < padded(slot->h); y++)
+			memcpy(&raw[(pos[i * 2 + 1] + y) * VATLAS_PAGE + pos[i * 2]],
+				&old[(slot->y + y) * VATLAS_PAGE + slot->x],
+				padded(slot->w) * sizeof(av_pixel)
+			);
+
+		slot->x = pos[i * 2];
+		slot->y = pos[i * 2 + 1];
+
+		for (arcan_vobject* user = slot->users; user; user = user->atlas.next)
+			if (user->txcos)
+				slot_mapping(slot, user->txcos);
+	}
+
+	page->store->vinf.text.raw = raw;
+	raw = old;
+
+	struct vatlas_node* nodes = page->sky.nodes;
+	page->sky = sky;
+	sky.nodes = nodes;
+
+	page->packed = page->used;
+	agp_update_vstore(page->store, true);
+	FLAG_DIRTY(NULL);
+
+	TRACE_MARK_EXIT("video", "atlas-compact",
+		TRACE_SYS_DEFAULT, 0, page->used, "repacked");
+
+out:
+	arcan_mem_free(set);
+	arcan_mem_free(pos);
+	arcan_mem_free(sky.nodes);
+	arcan_mem_free(raw);
+}
+
+bool arcan_vint_atlas_alloc(arcan_vobject* vobj)
+{
+	struct agp_vstore* vs = vobj->vstore;
+
+	if (!arcan_video_display.atlas || arcan_video_display.conservative ||
+		vobj->atlas.slot || vobj->frameset || vobj->txcos ||
+		FL_TEST(vobj, FL_PRSIST))
+		return false;
+
+	if (vs->refcount != 1 || vs->txmapped != TXSTATE_TEX2D ||
+		!vs->vinf.text.raw || vs->vinf.text.s_fmt || vs->vinf.text.d_fmt ||
+		vs->vinf.text.compression ||
+		vs->vinf.text.s_raw != vs->w * vs->h * sizeof(av_pixel) ||
+		vs->txu == ARCAN_VTEX_REPEAT || vs->txv == ARCAN_VTEX_REPEAT ||
+		(vs->filtermode & ARCAN_VFILTER_MIPMAP) ||
+		!vs->w || !vs->h || vs->w > VATLAS_MAXDIM || vs->h > VATLAS_MAXDIM)
+		return false;
+
+	struct vatlas_page** owner = &vcontext_stack[vcontext_ind].atlas;
+	size_t pw = padded(vs->w), ph = padded(vs->h);
+	size_t x, y;
+
+	struct vatlas_page* page = *owner;
+	for (; page; page = page->next){
+		if (page->store->filtermode == vs->filtermode &&
+			page->store->txu == vs->txu && page->store->txv == vs->txv &&
+			skyline_insert(&page->sky, pw, ph, &x, &y))
+			break;
+	}
+
+	if (!page){
+		page = page_alloc(owner, vs);
+		if (!page || !skyline_insert(&page->sky, pw, ph, &x, &y))
+			return false;
+	}
+
+/* the region is spent either way, a failed allocation here is reclaimed on
+ * the next repack */
+	page->packed += pw * ph;
+
+	struct vatlas_slot* slot = arcan_alloc_mem(sizeof(struct vatlas_slot),
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO | ARCAN_MEM_NONFATAL,
+		ARCAN_MEMALIGN_NATURAL
+	);
+
+	float* txcos = arcan_alloc_mem(8 * sizeof(float),
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_SIMD);
+
+	if (!slot || !txcos){
+		arcan_mem_free(slot);
+		arcan_mem_free(txcos);
+		return false;
+	}
+
+	*slot = (struct vatlas_slot){
+		.page = page,
+		.next = page->slots,
+		.users = vobj,
+		.source = vs->vinf.text.source,
+		.x = x,
+		.y = y,
+		.w = vs->w,
+		.h = vs->h
+	};
+	page->slots = slot;
+	page->used += pw * ph;
+
+	slot_blit(page->store->vinf.text.raw, slot, vs->vinf.text.raw);
+	slot_synch(slot);
+
+/* the private store may never have been uploaded, so release its buffers
+ * here rather than rely on drop_vstore */
+	vs->vinf.text.source = NULL;
+	arcan_mem_free(vs->vinf.text.raw);
+	vs->vinf.text.raw = NULL;
+	vs->vinf.text.s_raw = 0;
+	arcan_vint_drop_vstore(vs);
+
+	vobj->vstore = page->store;
+	vobj->vstore->refcount++;
+	vobj->atlas.slot = slot;
+	vobj->atlas.next = NULL;
+
+	slot_mapping(slot, txcos);
+	vobj->txcos = txcos;
+
+	TRACE_MARK_ONESHOT("video", "atlas-alloc",
+		TRACE_SYS_DEFAULT, vobj->cellid, page->used, vobj->tracetag);
+
+	FLAG_DIRTY(vobj);
+	return true;
+}
+
+void arcan_vint_atlas_share(arcan_vobject* src, arcan_vobject* dst)
+{
+	if (!src->atlas.slot || dst->atlas.slot)
+		return;
+
+	dst->atlas.slot = src->atlas.slot;
+	dst->atlas.next = src->atlas.slot->users;
+	src->atlas.slot->users = dst;
+}
+
+void arcan_vint_atlas_release(arcan_vobject* vobj)
+{
+	struct vatlas_slot* slot = vobj->atlas.slot;
+	if (!slot)
+		return;
+
+	arcan_vobject** cur = &slot->users;
+	while (*cur && *cur != vobj)
+		cur = &(*cur)->atlas.next;
+	if (*cur)
+		*cur = vobj->atlas.next;
+
+	vobj->atlas.slot = NULL;
+	vobj->atlas.next = NULL;
+
+	if (slot->users)
+		return;
+
+	struct vatlas_page* page = slot->page;
+	struct vatlas_slot** sc = &page->slots;
+	while (*sc != slot)
+		sc = &(*sc)->next;
+	*sc = slot->next;
+
+	page->used -= padded(slot->w) * padded(slot->h);
+	arcan_mem_free(slot->source);
+	arcan_mem_free(slot);
+
+	if (!page->slots){
+		page_free(page);
+		return;
+	}
+
+	if (page->used * 2 < page->packed &&
+		page->packed > (VATLAS_PAGE * VATLAS_PAGE) / 4)
+		page_compact(page);
+}
+
+void arcan_vint_atlas_detach(arcan_vobject* vobj)
+{
+	arcan_vint_uncompress(vobj);
+
+	struct vatlas_slot* slot = vobj->atlas.slot;
+	if (!slot)
+		return;
+
+	struct agp_vstore* page = slot->page->store;
+	struct agp_vstore* vs = arcan_alloc_mem(sizeof(struct agp_vstore),
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO, ARCAN_MEMALIGN_NATURAL);
+
+	vs->refcount = 1;
+	vs->txmapped = TXSTATE_TEX2D;
+	vs->txu = page->txu;
+	vs->txv = page->txv;
+	vs->scale = page->scale;
+	vs->imageproc = page->imageproc;
+	vs->filtermode = page->filtermode;
+	vs->w = slot->w;
+	vs->h = slot->h;
+	vs->bpp = sizeof(av_pixel);
+
+	vs->vinf.text.s_raw = slot->w * slot->h * sizeof(av_pixel);
+	vs->vinf.text.raw = arcan_alloc_mem(vs->vinf.text.s_raw,
+		ARCAN_MEM_VBUFFER, 0, ARCAN_MEMALIGN_PAGE);
+
+	av_pixel* src = page->vinf.text.raw;
+	for (size_t y = 0; y < slot->h; y++)
+		memcpy(&vs->vinf.text.raw[y * slot->w],
+			&src[(slot->y + VATLAS_GUTTER + y) * VATLAS_PAGE + slot->x + VATLAS_GUTTER],
+			slot->w * sizeof(av_pixel)
+		);
+
+	if (slot->source)
+		vs->vinf.text.source = strdup(slot->source);
+
+	agp_update_vstore(vs, true);
+
+	arcan_vint_atlas_release(vobj);
+	arcan_vint_drop_vstore(vobj->vstore);
+	vobj->vstore = vs;
+
+	arcan_mem_free(vobj->txcos);
+	vobj->txcos = NULL;
+
+	TRACE_MARK_ONESHOT("video", "atlas-detach",
+		TRACE_SYS_DEFAULT, vobj->cellid, 0, vobj->tracetag);
+
+	FLAG_DIRTY(vobj);
+}
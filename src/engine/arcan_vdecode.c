@@ -0,0 +1,608 @@
+/*
+ * Copyright 2026, Arcan contributors
+ * License: 3-Clause BSD, see COPYING file in arcan source repository.
+ * Reference: http://arcan-fe.com
+ * Description: Image decoding for the video subsystem, a fixed pool of
+ * workers for asynchronous loads and a size-bounded cache of decoded images.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "arcan_math.h"
+#include "arcan_general.h"
+#include "arcan_shmif.h"
+#include "arcan_event.h"
+#include "arcan_video.h"
+#include "arcan_videoint.h"
+#include "arcan_renderfun.h"
+#include "arcan_img.h"
+
+/*
+ * Asynchronous loads are queued as jobs and picked up by a fixed number of
+ * worker threads that are started on the first load. Workers take the oldest
+ * job with the highest priority, the owner raises the priority of objects
+ * that have become visible while waiting. Jobs that are still queued when
+ * their object is deleted are dropped, running ones are discarded when they
+ * complete.
+ *
+ * All decodes, synchronous or not, go through a cache of the decoded (and
+ * possibly rescaled) images keyed on the resource, its modification time and
+ * size, and the load constraints. The least recently used entries are evicted
+ * when the cache exceeds its limit. Every hit is copied as the objects own
+ * their backing stores.
+ *
+ * Loads can ask for the result to be block compressed for the GPU, which is
+ * done after any rescaling so the cache holds the compressed blocks as well.
+ */
+#ifndef ASYNCH_CONCURRENT_THREADS
+#define ASYNCH_CONCURRENT_THREADS 4
+#endif
+
+#ifndef VDECODE_CACHE_LIMIT
+#define VDECODE_CACHE_LIMIT (64 * 1024 * 1024)
+#endif
+
+/* below this, the savings don't warrant the encoding and the lost precision */
+#ifndef VDECODE_COMPRESS_MIN
+#define VDECODE_COMPRESS_MIN (32 * 32)
+#endif
+
+enum job_state {
+	JOB_QUEUED = 0,
+	JOB_RUNNING,
+	JOB_DONE
+};
+
+struct arcan_vdecode_job {
+	char* fname;
+	img_cons forced;
+	enum arcan_vimage_mode scale;
+	bool flip, compress;
+	int prio;
+
+	_Atomic int state;
+	bool cancelled;
+	struct arcan_vdecode out;
+
+	struct arcan_vdecode_job* next;
+};
+
+static struct {
+	pthread_mutex_t lock;
+	pthread_cond_t wake, done;
+	pthread_t threads[ASYNCH_CONCURRENT_THREADS];
+	size_t n_threads;
+	bool shutdown;
+	struct arcan_vdecode_job* first, * last;
+} pool = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.wake = PTHREAD_COND_INITIALIZER,
+	.done = PTHREAD_COND_INITIALIZER
+};
+
+struct cache_key {
+	uint64_t hash;
+	char* fname;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	time_t mtime;
+	img_cons forced;
+	enum arcan_vimage_mode scale;
+	bool flip, compress;
+};
+
+struct cache_entry {
+	struct cache_key key;
+	struct arcan_vdecode img;
+	struct cache_entry* prev, * next;
+};
+
+static struct {
+	pthread_mutex_t lock;
+	size_t limit, used;
+	struct cache_entry* first, * last;
+} cache = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.limit = VDECODE_CACHE_LIMIT
+};
+
+static uint16_t nexthigher(uint16_t k)
+{
+	k--;
+	for (size_t i=1; i < sizeof(uint16_t) * 8; i = i * 2)
+		k = k | k >> i;
+	return k+1;
+}
+
+static bool key_match(struct cache_key* a, struct cache_key* b)
+{
+	return a->hash == b->hash && a->dev == b->dev && a->ino == b->ino &&
+		a->size == b->size && a->mtime == b->mtime &&
+		a->forced.w == b->forced.w && a->forced.h == b->forced.h &&
+		a->scale == b->scale && a->flip == b->flip && a->compress == b->compress &&
+		strcmp(a->fname, b->fname) == 0;
+}
+
+static void cache_unlink(struct cache_entry* ent)
+{
+	if (ent->prev)
+		ent->prev->next = ent->next;
+	else
+		cache.first = ent->next;
+
+	if (ent->next)
+		ent->next->prev = ent->prev;
+	else
+		cache.last = ent->prev;
+
+	ent->prev = ent->next = NULL;
+}
+
+static void cache_front(struct cache_entry* ent)
+{
+	ent->next = cache.first;
+	if (cache.first)
+		cache.first->prev = ent;
+	cache.first = ent;
+	if (!cache.last)
+		cache.last = ent;
+}
+
+static void cache_trim(size_t limit)
+{
+	while (cache.last && cache.used > limit){
+		struct cache_entry* ent = cache.last;
+		cache_unlink(ent);
+		cache.used -= ent->img.s_raw;
+		arcan_mem_free(ent->img.raw);
+		arcan_mem_free(ent->key.fname);
+		arcan_mem_free(ent);
+	}
+}
+
+static bool cache_get(struct cache_key* key, struct arcan_vdecode* out)
+{
+	bool rv = false;
+	pthread_mutex_lock(&cache.lock);
+
+	for (struct cache_entry* ent = cache.first; ent; ent = ent->next){
+		if (!key_match(&ent->key, key))
+			continue;
+
+		av_pixel* raw = arcan_alloc_mem(ent->img.s_raw,
+			ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_PAGE);
+		if (!raw)
+			break;
+
+		memcpy(raw, ent->img.raw, ent->img.s_raw);
+		*out = ent->img;
+		out->raw = raw;
+
+		cache_unlink(ent);
+		cache_front(ent);
+		rv = true;
+		break;
+	}
+
+	pthread_mutex_unlock(&cache.lock);
+	return rv;
+}
+
+/* the limit can be changed from the main thread while workers decode */
+static size_t cache_limit()
+{
+	pthread_mutex_lock(&cache.lock);
+	size_t limit = cache.limit;
+	pthread_mutex_unlock(&cache.lock);
+	return limit;
+}
+
+static void cache_put(struct cache_key* key, struct arcan_vdecode* img)
+{
+/* a single image shouldn't be able to flush out most of the cache */
+	if (!img->raw || img->s_raw > cache_limit() / 4)
+		return;
+
+	struct cache_entry* ent = arcan_alloc_mem(sizeof(struct cache_entry),
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL | ARCAN_MEM_BZERO,
+		ARCAN_MEMALIGN_NATURAL);
+	if (!ent)
+		return;
+
+	ent->img = *img;
+	ent->key = *key;
+	ent->key.fname = strdup(key->fname);
+	ent->img.raw = arcan_alloc_mem(img->s_raw,
+		ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_PAGE);
+
+	if (!ent->img.raw || !ent->key.fname){
+		arcan_mem_free(ent->img.raw);
+		arcan_mem_free(ent->key.fname);
+		arcan_mem_free(ent);
+		return;
+	}
+
+	memcpy(ent->img.raw, img->raw, img->s_raw);
+
+	pthread_mutex_lock(&cache.lock);
+
+/* two loads of the same image might have raced */
+	for (struct cache_entry* cur = cache.first; cur; cur = cur->next)
+		if (key_match(&cur->key, key)){
+			pthread_mutex_unlock(&cache.lock);
+			arcan_mem_free(ent->img.raw);
+			arcan_mem_free(ent->key.fname);
+			arcan_mem_free(ent);
+			return;
+		}
+
+	cache_front(ent);
+	cache.used += ent->img.s_raw;
+	cache_trim(cache.limit);
+	pthread_mutex_unlock(&cache.lock);
+}
+
+void arcan_vint_decode_cache(size_t limit)
+{
+	pthread_mutex_lock(&cache.lock);
+	cache.limit = limit;
+	cache_trim(limit);
+	pthread_mutex_unlock(&cache.lock);
+}
+
+/*
+ * Stores that are entirely opaque fit in BC1, anything else needs the alpha
+ * channel of BC3. Failing to compress isn't fatal, the pixels are kept.
+ */
+static void compress_image(struct arcan_vdecode* img)
+{
+	size_t npx = img->w * img->h;
+	if (img->w % 4 || img->h % 4 || npx < VDECODE_COMPRESS_MIN)
+		return;
+
+	enum agp_compression fmt = AGP_COMPRESS_BC1;
+	for (size_t i = 0; i < npx; i++){
+		uint8_t r, g, b, a;
+		RGBA_DECOMP(img->raw[i], &r, &g, &b, &a);
+		if (a != 255){
+			fmt = AGP_COMPRESS_BC3;
+			break;
+		}
+	}
+
+	size_t sz;
+	uint8_t* blocks = arcan_img_compress(img->raw, img->w, img->h, fmt, &sz);
+	if (!blocks)
+		return;
+
+	arcan_mem_free(img->raw);
+	img->raw = (av_pixel*) blocks;
+	img->s_raw = sz;
+	img->compression = fmt;
+}
+
+arcan_errc arcan_vint_decode(const char* fname, img_cons forced,
+	enum arcan_vimage_mode scale, bool flip, bool compress,
+	struct arcan_vdecode* out)
+{
+	*out = (struct arcan_vdecode){.rc = ARCAN_ERRC_BAD_RESOURCE};
+	size_t inw, inh;
+
+/* try- open */
+	data_source inres = arcan_open_resource(fname);
+	if (inres.fd == BADFD)
+		return out->rc;
+
+	struct stat fs;
+	struct cache_key key = {
+		.fname = (char*) fname,
+		.forced = forced,
+		.scale = scale,
+		.flip = flip,
+		.compress = compress
+	};
+
+	bool cacheable = cache_limit() > 0 && fstat(inres.fd, &fs) == 0;
+	if (cacheable){
+		key.hash = 0xcbf29ce484222325ULL;
+		for (const char* c = fname; *c; c++)
+			key.hash = (key.hash ^ (uint8_t) *c) * 0x100000001b3ULL;
+		key.dev = fs.st_dev;
+		key.ino = fs.st_ino;
+		key.size = fs.st_size;
+		key.mtime = fs.st_mtime;
+
+		if (cache_get(&key, out)){
+			arcan_release_resource(&inres);
+			return out->rc;
+		}
+	}
+
+/* mmap (preferred) or buffer (mmap not working / useful due to alignment) */
+	map_region inmem = arcan_map_resource(&inres, false);
+	if (inmem.ptr == NULL){
+		arcan_release_resource(&inres);
+		return out->rc;
+	}
+
+	struct arcan_img_meta meta = {0};
+	uint32_t* ch_imgbuf = NULL;
+
+/* the image will be stretched to the constraints, so the decoder can reduce
+ * it on the way (power of two scaling depends on the source dimensions) */
+	bool reduce = scale != ARCAN_VIMAGE_SCALEPOW2 && forced.w && forced.h;
+
+	out->rc = arcan_img_decode_reduced(fname, inmem.ptr, inmem.sz,
+		&ch_imgbuf, &inw, &inh, &meta, flip,
+		reduce ? forced.w : 0, reduce ? forced.h : 0);
+
+	arcan_release_map(inmem);
+	arcan_release_resource(&inres);
+
+	if (ARCAN_OK != out->rc)
+		return out->rc;
+
+	av_pixel* imgbuf = arcan_img_repack(ch_imgbuf, inw, inh);
+	if (!imgbuf)
+		return (out->rc = ARCAN_ERRC_OUT_OF_SPACE);
+
+/* store this so we can maintain aspect ratios etc. while still
+ * possibly aligning to next power of two */
+	out->origw = inw;
+	out->origh = inh;
+
+/* native-compressed formats can't be processed further */
+	if (meta.compressed){
+		arcan_mem_free(imgbuf);
+		return out->rc;
+	}
+
+	size_t neww = inw;
+	size_t newh = inh;
+
+/* the user requested specific dimensions, or we are in a mode where
+ * we should manually enfore a stretch to the nearest power of two */
+	if (scale == ARCAN_VIMAGE_SCALEPOW2){
+		forced.w = nexthigher(neww) == neww ? 0 : nexthigher(neww);
+		forced.h = nexthigher(newh) == newh ? 0 : nexthigher(newh);
+	}
+
+	if (forced.h > 0 && forced.w > 0){
+		neww = scale == ARCAN_VIMAGE_SCALEPOW2 ? nexthigher(forced.w) : forced.w;
+		newh = scale == ARCAN_VIMAGE_SCALEPOW2 ? nexthigher(forced.h) : forced.h;
+		out->origw = forced.w;
+		out->origh = forced.h;
+
+		out->s_raw = neww * newh * sizeof(av_pixel);
+		out->raw = arcan_alloc_mem(out->s_raw,
+			ARCAN_MEM_VBUFFER, 0, ARCAN_MEMALIGN_PAGE);
+
+		arcan_renderfun_stretchblit((char*)imgbuf, inw, inh,
+			(uint32_t*) out->raw, neww, newh, flip);
+		arcan_mem_free(imgbuf);
+	}
+	else {
+		out->raw = imgbuf;
+		out->s_raw = inw * inh * sizeof(av_pixel);
+	}
+
+	out->w = neww;
+	out->h = newh;
+
+	if (compress && out->raw)
+		compress_image(out);
+
+	if (cacheable)
+		cache_put(&key, out);
+
+	return out->rc;
+}
+
+static void free_job(struct arcan_vdecode_job* job)
+{
+	arcan_mem_free(job->out.raw);
+	arcan_mem_free(job->fname);
+	arcan_mem_free(job);
+}
+
+static void unlink_job(struct arcan_vdecode_job* job)
+{
+	struct arcan_vdecode_job* prev = NULL;
+	for (struct arcan_vdecode_job* cur = pool.first; cur; cur = cur->next){
+		if (cur != job){
+			prev = cur;
+			continue;
+		}
+
+		if (prev)
+			prev->next = job->next;
+		else
+			pool.first = job->next;
+
+		if (pool.last == job)
+			pool.last = prev;
+		break;
+	}
+	job->next = NULL;
+}
+
+/* oldest job with the highest priority, pool lock held */
+static struct arcan_vdecode_job* next_job()
+{
+	struct arcan_vdecode_job* job = pool.first;
+	for (struct arcan_vdecode_job* cur = pool.first; cur; cur = cur->next)
+		if (cur->prio > job->prio)
+			job = cur;
+
+	if (job)
+		unlink_job(job);
+	return job;
+}
+
+static void run_job(struct arcan_vdecode_job* job)
+{
+	arcan_vint_decode(job->fname, job->forced,
+		job->scale, job->flip, job->compress, &job->out);
+
+	pthread_mutex_lock(&pool.lock);
+	if (job->cancelled)
+		free_job(job);
+	else {
+		atomic_store(&job->state, JOB_DONE);
+		pthread_cond_broadcast(&pool.done);
+	}
+	pthread_mutex_unlock(&pool.lock);
+}
+
+static void* decode_worker(void* arg)
+{
+	pthread_mutex_lock(&pool.lock);
+
+	for(;;){
+		while (!pool.first && !pool.shutdown)
+			pthread_cond_wait(&pool.wake, &pool.lock);
+
+		if (pool.shutdown)
+			break;
+
+		struct arcan_vdecode_job* job = next_job();
+		atomic_store(&job->state, JOB_RUNNING);
+		pthread_mutex_unlock(&pool.lock);
+
+		run_job(job);
+		pthread_mutex_lock(&pool.lock);
+	}
+
+	pthread_mutex_unlock(&pool.lock);
+	return NULL;
+}
+
+struct arcan_vdecode_job* arcan_vint_decode_queue(const char* fname,
+	img_cons forced, enum arcan_vimage_mode scale, bool flip, bool compress,
+	int prio)
+{
+	struct arcan_vdecode_job* job = arcan_alloc_mem(
+		sizeof(struct arcan_vdecode_job),
+		ARCAN_MEM_THREADCTX, ARCAN_MEM_BZERO, ARCAN_MEMALIGN_NATURAL);
+
+	job->fname = strdup(fname);
+	job->forced = forced;
+	job->scale = scale;
+	job->flip = flip;
+	job->compress = compress;
+	job->prio = prio;
+	atomic_store(&job->state, JOB_QUEUED);
+
+	pthread_mutex_lock(&pool.lock);
+	while (pool.n_threads < ASYNCH_CONCURRENT_THREADS){
+		if (0 != pthread_create(
+			&pool.threads[pool.n_threads], NULL, decode_worker, NULL)){
+			arcan_warning("vdecode: couldn't spawn worker %zu/%d\n",
+				pool.n_threads + 1, ASYNCH_CONCURRENT_THREADS);
+			break;
+		}
+		pool.n_threads++;
+	}
+
+/* without workers, the job is decoded when it is collected */
+	if (pool.last)
+		pool.last->next = job;
+	else
+		pool.first = job;
+	pool.last = job;
+
+	pthread_cond_signal(&pool.wake);
+	pthread_mutex_unlock(&pool.lock);
+
+	return job;
+}
+
+void arcan_vint_decode_prio(struct arcan_vdecode_job* job, int prio)
+{
+	if (job->prio == prio)
+		return;
+
+	pthread_mutex_lock(&pool.lock);
+	job->prio = prio;
+	pthread_mutex_unlock(&pool.lock);
+}
+
+bool arcan_vint_decode_collect(
+	struct arcan_vdecode_job* job, bool wait, struct arcan_vdecode* out)
+{
+	if (!wait && atomic_load(&job->state) != JOB_DONE)
+		return false;
+
+	pthread_mutex_lock(&pool.lock);
+
+/* rather than waiting for it to reach the front of the queue, decode here */
+	if (atomic_load(&job->state) == JOB_QUEUED){
+		unlink_job(job);
+		atomic_store(&job->state, JOB_RUNNING);
+		pthread_mutex_unlock(&pool.lock);
+		run_job(job);
+		pthread_mutex_lock(&pool.lock);
+	}
+
+	while (atomic_load(&job->state) != JOB_DONE)
+		pthread_cond_wait(&pool.done, &pool.lock);
+
+	pthread_mutex_unlock(&pool.lock);
+
+	*out = job->out;
+	job->out.raw = NULL;
+	free_job(job);
+	return true;
+}
+
+void arcan_vint_decode_cancel(struct arcan_vdecode_job* job)
+{
+	pthread_mutex_lock(&pool.lock);
+
+	if (atomic_load(&job->state) == JOB_RUNNING)
+		job->cancelled = true;
+	else {
+		if (atomic_load(&job->state) == JOB_QUEUED)
+			unlink_job(job);
+		free_job(job);
+	}
+
+	pthread_mutex_unlock(&pool.lock);
+}
+
+void arcan_vint_decode_shutdown()
+{
+	pthread_mutex_lock(&pool.lock);
+	pool.shutdown = true;
+	pthread_cond_broadcast(&pool.wake);
+	pthread_mutex_unlock(&pool.lock);
+
+	for (size_t i = 0; i < pool.n_threads; i++)
+		pthread_join(pool.threads[i], NULL);
+
+/* anything left belonged to objects that are already gone */
+	while (pool.first){
+		struct arcan_vdecode_job* job = pool.first;
+		pool.first = job->next;
+		free_job(job);
+	}
+
+	pool.last = NULL;
+	pool.n_threads = 0;
+	pool.shutdown = false;
+
+	pthread_mutex_lock(&cache.lock);
+	cache_trim(0);
+	pthread_mutex_unlock(&cache.lock);
+}
@@ -28,10 +28,6 @@
 
 #define CLAMP(x, l, h) (((x) > (h)) ? (h) : (((x) < (l)) ? (l) : (x)))
 
-#ifndef ASYNCH_CONCURRENT_THREADS
-#define ASYNCH_CONCURRENT_THREADS 12
-#endif
-
 #include PLATFORM_HEADER
 
 #include "arcan_shmif.h"
@@ -43,6 +39,7 @@
 #include "arcan_audio.h"
 #include "arcan_event.h"
 #include "arcan_frameserver.h"
+#include "arcan_conductor.h"
 #include "arcan_renderfun.h"
 #include "arcan_videoint.h"
 #include "arcan_3dbase.h"
@@ -58,7 +55,6 @@
 #endif
 
 static surface_properties empty_surface();
-static sem_handle asynchsynch;
 
 /* these match arcan_vinterpolant enum */
 static arcan_interp_3d_function lut_interp_3d[] = {
@@ -79,6 +75,15 @@ static arcan_interp_1d_function lut_interp_1d[] = {
 	interp_1d_smoothstep
 };
 
+static arcan_interp_batch_function lut_interp_batch[] = {
+	interp_batch_linear,
+	interp_batch_sine,
+	interp_batch_expin,
+	interp_batch_expout,
+	interp_batch_expinout,
+	interp_batch_smoothstep
+};
+
 struct arcan_video_display arcan_video_display = {
 	.conservative = false,
 	.deftxs = ARCAN_VTEX_CLAMP, ARCAN_VTEX_CLAMP,
@@ -93,6 +98,10 @@ struct arcan_video_display arcan_video_display = {
 	.imageproc = IMAGEPROC_NORMAL,
 	.mipmap = ARCAN_VIDEO_DEFAULT_MIPMAP_STATE,
 	.dirty = 0,
+	.frame_cache = true,
+	.active_set = true,
+	.cull = true,
+	.shader_cache = true,
 	.cursor.w = 24,
 	.cursor.h = 16
 };
@@ -238,11 +247,26 @@ static void addchild(arcan_vobject* parent, arcan_vobject* child)
 	}
 
 	parent->extrefc.links++;
+	FLAG_RTDEP();
 
 	child->parent = parent;
 	*slot = child;
 }
 
+/*
+ * the pick index of a rendertarget can be rebuilt while the transform caches
+ * are still invalid (pick between two moves in the same frame), so this part
+ * can't stop where the cache sweep does
+ */
+static void flag_pick_tree(arcan_vobject* vobj)
+{
+	FLAG_PICK_OBJ(vobj);
+
+	for (size_t i = 0; i < vobj->childslots; i++)
+		if (vobj->children[i])
+			flag_pick_tree(vobj->children[i]);
+}
+
 /*
  * recursively sweep children and
  * flag their caches for updates as well
@@ -251,8 +275,12 @@ static void invalidate_cache(arcan_vobject* vobj)
 {
 	FLAG_DIRTY(vobj);
 
-	if (!vobj->valid_cache)
+	if (!vobj->valid_cache){
+		flag_pick_tree(vobj);
 		return;
+	}
+
+	FLAG_PICK_OBJ(vobj);
 
 	vobj->valid_cache = false;
 
@@ -268,6 +296,7 @@ static void dropchild(arcan_vobject* parent, arcan_vobject* child)
 			parent->children[i] = NULL;
 			parent->extrefc.links--;
 			child->parent = &current_context->world;
+			FLAG_RTDEP();
 			break;
 		}
 	}
@@ -285,9 +314,10 @@ static void deallocate_gl_context(
 			arcan_vobject* current = &(context->vitems_pool[i]);
 
 /* before doing any modification, wait for any async load calls to finish(!),
- * question is IF this should invalidate or not */
-			if (current->feed.state.tag == ARCAN_TAG_ASYNCIMGLD ||
-				current->feed.state.tag == ARCAN_TAG_ASYNCIMGRD)
+ * question is IF this should invalidate or not, objects that are about to be
+ * deleted will just cancel theirs */
+			if (!del && (current->feed.state.tag == ARCAN_TAG_ASYNCIMGLD ||
+				current->feed.state.tag == ARCAN_TAG_ASYNCIMGRD))
 				arcan_video_pushasynch(i);
 
 /* for persistant objects, deleteobject will only be "effective" if we're at
@@ -308,7 +338,74 @@ static void deallocate_gl_context(
 	if (del){
 		arcan_mem_free(context->vitems_pool);
 		context->vitems_pool = NULL;
+		arcan_mem_free(context->active.ids);
+		arcan_mem_free(context->active.tick);
+		memset(&context->active, '\0', sizeof(context->active));
+	}
+}
+
+/*
+ * The active set tracks the objects that might need to be visited every tick
+ * so that the cost of a tick follows the number of animated or feeding
+ * objects rather than the number of objects in the scene. Members are added
+ * when one of the conditions below is set and dropped lazily when a tick
+ * finds that none of them apply anymore, or when the object is deleted.
+ */
+static inline bool tick_needed(arcan_vobject* vobj)
+{
+	return vobj->transform || vobj->feed.ffunc > FFUNC_NULL ||
+		(vobj->frameset && vobj->frameset->mctr != 0) ||
+		(vobj->lifetime > 0 && (vobj->mask & MASK_LIVING)) ||
+		vobj->feed.state.tag == ARCAN_TAG_ASYNCIMGLD ||
+		vobj->feed.state.tag == ARCAN_TAG_ASYNCIMGRD;
+}
+
+static void active_add(struct arcan_video_context* ctx, arcan_vobject* vobj)
+{
+	if (vobj->active_ind || !vobj->cellid)
+		return;
+
+	if (ctx->active.count == ctx->active.limit){
+		size_t limit = ctx->active.limit ? ctx->active.limit * 2 : 256;
+		arcan_vobj_id* ids = arcan_alloc_mem(limit * sizeof(arcan_vobj_id),
+			ARCAN_MEM_VSTRUCT, 0, ARCAN_MEMALIGN_NATURAL);
+		arcan_vobj_id* tick = arcan_alloc_mem(limit * sizeof(arcan_vobj_id),
+			ARCAN_MEM_VSTRUCT, 0, ARCAN_MEMALIGN_NATURAL);
+
+/* this can happen in the middle of tick_active, so the snapshot is kept */
+		if (ctx->active.ids){
+			memcpy(ids, ctx->active.ids, ctx->active.count * sizeof(arcan_vobj_id));
+			memcpy(tick, ctx->active.tick, ctx->active.limit * sizeof(arcan_vobj_id));
+			arcan_mem_free(ctx->active.ids);
+			arcan_mem_free(ctx->active.tick);
+		}
+
+		ctx->active.ids = ids;
+		ctx->active.tick = tick;
+		ctx->active.limit = limit;
 	}
+
+	ctx->active.ids[ctx->active.count++] = vobj->cellid;
+	vobj->active_ind = ctx->active.count;
+}
+
+static void active_drop(struct arcan_video_context* ctx, arcan_vobject* vobj)
+{
+	if (!vobj->active_ind)
+		return;
+
+/* swap in the last member */
+	size_t ind = vobj->active_ind - 1;
+	arcan_vobj_id last = ctx->active.ids[--ctx->active.count];
+	ctx->active.ids[ind] = last;
+	ctx->vitems_pool[last].active_ind = ind + 1;
+	vobj->active_ind = 0;
+}
+
+static inline void tick_activate(arcan_vobject* vobj)
+{
+	if (!vobj->active_ind && tick_needed(vobj))
+		active_add(current_context, vobj);
 }
 
 static inline void step_active_frame(arcan_vobject* vobj)
@@ -366,11 +463,13 @@ static void reallocate_gl_context(struct arcan_video_context* context)
 					char* fname = strdup( current->vstore->vinf.text.source );
 					arcan_mem_free(current->vstore->vinf.text.source);
 				arcan_vint_getimage(fname,
-					current, (img_cons){.w = current->origw, .h = current->origh}, false);
+					current, (img_cons){.w = current->origw, .h = current->origh});
 				arcan_mem_free(fname);
 			}
+/* atlas pages are shared by many objects, only rebuild them once */
 			else
-				if (current->vstore->txmapped != TXSTATE_OFF)
+				if (current->vstore->txmapped != TXSTATE_OFF &&
+					!(current->atlas.slot && current->vstore->vinf.text.glid))
 					agp_update_vstore(current->vstore, true);
 
 			arcan_frameserver* fsrv = current->feed.state.ptr;
@@ -423,6 +522,9 @@ static void push_transfer_persists(
 		memcpy(dstobj, srcobj, sizeof(arcan_vobject));
 		dst->nalive++; /* fake allocate */
 		dstobj->parent = &dst->world; /* don't cross- reference worlds */
+		dstobj->active_ind = 0;
+		if (tick_needed(dstobj))
+			active_add(dst, dstobj);
 		attach_object(&dst->stdoutp, dstobj);
 		trace("vcontext_stack_push() : transfer-attach: %s\n", srcobj->tracetag);
 	}
@@ -445,6 +547,7 @@ static void pop_transfer_persists(
 			continue;
 
 		arcan_vobject* parent = dstobj->parent;
+		size_t active_ind = dstobj->active_ind;
 
 		detach_fromtarget(srcobj->owner, srcobj);
 		src->nalive--;
@@ -452,6 +555,9 @@ static void pop_transfer_persists(
 		memcpy(dstobj, srcobj, sizeof(arcan_vobject));
 		attach_object(&dst->stdoutp, dstobj);
 		dstobj->parent = parent;
+		dstobj->active_ind = active_ind;
+		if (tick_needed(dstobj))
+			active_add(dst, dstobj);
 		memset(srcobj, '\0', sizeof(arcan_vobject));
 	}
 }
@@ -628,6 +734,7 @@ signed arcan_video_pushcontext()
 
 	current_context = &vcontext_stack[ vcontext_ind ];
 	current_context->stdoutp.first = NULL;
+	memset(&current_context->active, '\0', sizeof(current_context->active));
 	current_context->vitem_ofs = 1;
 	current_context->nalive = 0;
 
@@ -649,6 +756,8 @@ signed arcan_video_pushcontext()
 	push_transfer_persists(
 		&vcontext_stack[ vcontext_ind - 1], current_context);
 	FLAG_DIRTY(NULL);
+	FLAG_PICK();
+	FLAG_RTDEP();
 
 	return arcan_video_nfreecontexts();
 }
@@ -775,6 +884,7 @@ clense:
 		vobj->vstore = alim[i].gl_store;
 		vobj->feed.state = alim[i].state;
 		vobj->feed.ffunc = alim[i].ffunc;
+		tick_activate(vobj);
 		vobj->origw = alim[i].origw;
 		vobj->origh = alim[i].origh;
 /*		vobj->order = alim[i].zv;
@@ -901,6 +1011,8 @@ unsigned arcan_video_popcontext()
 
 	reallocate_gl_context(current_context);
 	FLAG_DIRTY(NULL);
+	FLAG_PICK();
+	FLAG_RTDEP();
 
 	return (CONTEXT_STACK_LIMIT - 1) - vcontext_ind;
 }
@@ -951,6 +1063,7 @@ arcan_errc arcan_video_resampleobject(arcan_vobj_id vid,
 	if (neww <= 0 || newh <= 0)
 		return ARCAN_ERRC_OUT_OF_SPACE;
 
+	arcan_vint_atlas_detach(vobj);
 	if (vobj->vstore->txmapped != TXSTATE_TEX2D)
 		return ARCAN_ERRC_UNACCEPTED_STATE;
 
@@ -1041,6 +1154,7 @@ arcan_errc arcan_video_resampleobject(arcan_vobj_id vid,
 	if (did == ARCAN_EID){
 		vobj->origw = neww;
 		vobj->origh = newh;
+		FLAG_PICK_OBJ(vobj);
 		arcan_video_shareglstore(dst, vid);
 		arcan_video_objectscale(vid, 1.0, 1.0, 1.0, 0);
 	}
@@ -1061,6 +1175,7 @@ arcan_errc arcan_video_mipmapset(arcan_vobj_id vid, bool enable)
 	if (!vobj)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
+	arcan_vint_atlas_detach(vobj);
 	if (vobj->vstore->txmapped != TXSTATE_TEX2D ||
 		!vobj->vstore->vinf.text.raw)
 		return ARCAN_ERRC_UNACCEPTED_STATE;
@@ -1219,6 +1334,28 @@ arcan_vobject* arcan_video_getobject(arcan_vobj_id id)
 	return rc;
 }
 
+/* damage regions are (x1, y1, x2, y2) in normalized device coordinates */
+static inline bool damage_empty(const float* box)
+{
+	return box[2] <= box[0] || box[3] <= box[1];
+}
+
+static inline void damage_merge(float* dst, const float* src)
+{
+	if (damage_empty(src))
+		return;
+
+	if (damage_empty(dst)){
+		memcpy(dst, src, sizeof(float) * 4);
+		return;
+	}
+
+	dst[0] = src[0] < dst[0] ? src[0] : dst[0];
+	dst[1] = src[1] < dst[1] ? src[1] : dst[1];
+	dst[2] = src[2] > dst[2] ? src[2] : dst[2];
+	dst[3] = src[3] > dst[3] ? src[3] : dst[3];
+}
+
 static bool detach_fromtarget(struct rendertarget* dst, arcan_vobject* src)
 {
 	arcan_vobject_litem* torem;
@@ -1255,6 +1392,9 @@ static bool detach_fromtarget(struct rendertarget* dst, arcan_vobject* src)
 	if (!torem)
 		return false;
 
+	FLAG_PICK_RT(dst);
+	FLAG_RTDEP();
+
 /* (1.) remove first */
 	if (dst->first == torem){
 		dst->first = torem->next;
@@ -1275,7 +1415,15 @@ static bool detach_fromtarget(struct rendertarget* dst, arcan_vobject* src)
 		torem->previous->next = torem->next;
 	}
 
-/* (4.) mark as something easy to find in dumps */
+/* (4.) the area it was last drawn to needs to be redrawn */
+	if (torem->damage.drawn){
+		if (torem->damage.art != dst->art)
+			dst->damage.full = true;
+		else
+			damage_merge(dst->damage.box, torem->damage.box);
+	}
+
+/* (5.) mark as something easy to find in dumps */
 	torem->elem = (arcan_vobject*) 0xfeedface;
 
 /* cleanup torem */
@@ -1343,9 +1491,12 @@ static void attach_object(struct rendertarget* dst, arcan_vobject* src)
 	if (dst->link)
 		return attach_object(dst->link, src);
 
+	FLAG_PICK_RT(dst);
+	FLAG_RTDEP();
+
 	arcan_vobject_litem* new_litem =
 		arcan_alloc_mem(sizeof *new_litem,
-			ARCAN_MEM_VSTRUCT, 0, ARCAN_MEMALIGN_NATURAL);
+			ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO, ARCAN_MEMALIGN_NATURAL);
 
 	new_litem->next = new_litem->previous = NULL;
 	new_litem->elem = src;
@@ -1531,6 +1682,7 @@ arcan_errc arcan_video_transformmask(arcan_vobj_id id,
 
 	if (vobj && id > FL_INUSE){
 		vobj->mask = mask;
+		FLAG_PICK_OBJ(vobj);
 		rv = ARCAN_OK;
 	}
 
@@ -1608,10 +1760,6 @@ arcan_errc arcan_video_init(uint16_t width, uint16_t height, uint8_t bpp,
 
 /* might be called multiple times due to longjmp recover etc. */
 	if (firstinit){
-		if (-1 == arcan_sem_init(&asynchsynch, ASYNCH_CONCURRENT_THREADS)){
-			arcan_warning("video_init couldn't create synchronization handle\n");
-		}
-
 		arcan_vint_defaultmapping(arcan_video_display.default_txcos, 1.0, 1.0);
 		arcan_vint_defaultmapping(arcan_video_display.cursor_txcos, 1.0, 1.0);
 		arcan_vint_mirrormapping(arcan_video_display.mirror_txcos, 1.0, 1.0);
@@ -1700,6 +1848,7 @@ arcan_errc arcan_video_resize_canvas(size_t neww, size_t newh)
 
 	current_context->world.origw = neww;
 	current_context->world.origh = newh;
+	FLAG_PICK();
 
 	FLAG_DIRTY(NULL);
 	arcan_video_forceupdate(ARCAN_VIDEO_WORLDID, true);
@@ -1715,118 +1864,109 @@ static uint16_t nexthigher(uint16_t k)
 	return k+1;
 }
 
-arcan_errc arcan_vint_getimage(const char* fname, arcan_vobject* dst,
-	img_cons forced, bool asynchsrc)
+static bool uncompress_store(struct agp_vstore* vs)
 {
-/*
- * with asynchsynch, it's likely that we get a storm of requests and we'd
- * likely suffer thrashing, so limit this.  also, look into using
- * pthread_setschedparam and switch to pthreads exclusively
- */
-	arcan_sem_wait(asynchsynch);
-
-	size_t inw, inh;
-
-/* try- open */
-	data_source inres = arcan_open_resource(fname);
-	if (inres.fd == BADFD){
-		arcan_sem_post(asynchsynch);
-		return ARCAN_ERRC_BAD_RESOURCE;
-	}
-
-/* mmap (preferred) or buffer (mmap not working / useful due to alignment) */
-	map_region inmem = arcan_map_resource(&inres, false);
-	if (inmem.ptr == NULL){
-		arcan_sem_post(asynchsynch);
-		arcan_release_resource(&inres);
-		return ARCAN_ERRC_BAD_RESOURCE;
-	}
-
-	struct arcan_img_meta meta = {0};
-	uint32_t* ch_imgbuf = NULL;
-
-	arcan_errc rv = arcan_img_decode(fname, inmem.ptr, inmem.sz,
-		&ch_imgbuf, &inw, &inh, &meta, dst->vstore->imageproc == IMAGEPROC_FLIPH);
-
-	arcan_release_map(inmem);
-	arcan_release_resource(&inres);
+	av_pixel* raw = arcan_img_uncompress((uint8_t*) vs->vinf.text.raw,
+		vs->vinf.text.s_raw, vs->w, vs->h, vs->vinf.text.compression);
+	if (!raw)
+		return false;
 
-	if (ARCAN_OK != rv)
-		goto done;
+	arcan_mem_free(vs->vinf.text.raw);
+	vs->vinf.text.raw = raw;
+	vs->vinf.text.s_raw = vs->w * vs->h * sizeof(av_pixel);
+	vs->vinf.text.compression = AGP_COMPRESS_NONE;
+	return true;
+}
 
-	av_pixel* imgbuf = arcan_img_repack(ch_imgbuf, inw, inh);
-	if (!imgbuf){
-		rv = ARCAN_ERRC_OUT_OF_SPACE;
-		goto done;
-	}
+/* compression is decided when the load is issued, on the main thread */
+static bool want_compress(struct agp_vstore* vs)
+{
+	if (!arcan_video_display.compress || (vs->filtermode & ARCAN_VFILTER_MIPMAP))
+		return false;
 
-	uint16_t neww, newh;
+	return arcan_video_display.compress_force ||
+		(agp_compression_support(AGP_COMPRESS_BC1) &&
+		agp_compression_support(AGP_COMPRESS_BC3));
+}
 
+/* the decode results are only applied on the main thread */
+static void assign_image(
+	arcan_vobject* dst, const char* fname, struct arcan_vdecode* img)
+{
 /* store this so we can maintain aspect ratios etc. while still
  * possibly aligning to next power of two */
-	dst->origw = inw;
-	dst->origh = inh;
-
-	neww = inw;
-	newh = inh;
-
-/* the thread_loader will take care of converting the asynchsrc
- * to an image once its completely done */
-	if (!asynchsrc)
-		dst->feed.state.tag = ARCAN_TAG_IMAGE;
+	dst->origw = img->origw;
+	dst->origh = img->origh;
 
 /* need to keep the identification string in order to rebuild
  * on a forced push/pop */
 	struct agp_vstore* dstframe = dst->vstore;
 	dstframe->vinf.text.source = strdup(fname);
 
-	enum arcan_vimage_mode desm = dst->vstore->scale;
-
-	if (meta.compressed)
-		goto push_comp;
+	if (!img->raw)
+		return;
 
-/* the user requested specific dimensions, or we are in a mode where
- * we should manually enfore a stretch to the nearest power of two */
-	if (desm == ARCAN_VIMAGE_SCALEPOW2){
-		forced.w = nexthigher(neww) == neww ? 0 : nexthigher(neww);
-		forced.h = nexthigher(newh) == newh ? 0 : nexthigher(newh);
+	dstframe->vinf.text.raw = img->raw;
+	dstframe->vinf.text.s_raw = img->s_raw;
+	dstframe->vinf.text.compression = img->compression;
+	dstframe->w = img->w;
+	dstframe->h = img->h;
+
+/* forced compression without backend support, decode on the CPU instead */
+	if (img->compression && !agp_compression_support(img->compression)){
+		if (!uncompress_store(dstframe)){
+			arcan_mem_free(dstframe->vinf.text.raw);
+			dstframe->vinf.text.raw = NULL;
+			dstframe->vinf.text.s_raw = 0;
+			dstframe->vinf.text.compression = AGP_COMPRESS_NONE;
+		}
 	}
+}
 
-	if (forced.h > 0 && forced.w > 0){
-		neww = desm == ARCAN_VIMAGE_SCALEPOW2 ? nexthigher(forced.w) : forced.w;
-		newh = desm == ARCAN_VIMAGE_SCALEPOW2 ? nexthigher(forced.h) : forced.h;
-		dst->origw = forced.w;
-		dst->origh = forced.h;
-
-		dstframe->vinf.text.s_raw = neww * newh * sizeof(av_pixel);
-		dstframe->vinf.text.raw = arcan_alloc_mem(dstframe->vinf.text.s_raw,
-			ARCAN_MEM_VBUFFER, 0, ARCAN_MEMALIGN_PAGE);
+void arcan_vint_uncompress(arcan_vobject* vobj)
+{
+	struct agp_vstore* vs = vobj->vstore;
+	if (!vs || vs->txmapped != TXSTATE_TEX2D ||
+		vs->vinf.text.compression == AGP_COMPRESS_NONE)
+		return;
 
-		arcan_renderfun_stretchblit((char*)imgbuf, inw, inh,
-			(uint32_t*) dstframe->vinf.text.raw,
-			neww, newh, dst->vstore->imageproc == IMAGEPROC_FLIPH);
-		arcan_mem_free(imgbuf);
+	if (vs->vinf.text.raw){
+		if (!uncompress_store(vs))
+			return;
 	}
+/* conservative mode has dropped the blocks after upload */
 	else {
-		neww = inw;
-		newh = inh;
-		dstframe->vinf.text.raw = imgbuf;
-		dstframe->vinf.text.s_raw = inw * inh * sizeof(av_pixel);
+		struct arcan_vdecode img;
+		char* fname = vs->vinf.text.source;
+		if (!fname || ARCAN_OK != arcan_vint_decode(fname,
+			(img_cons){.w = vobj->origw, .h = vobj->origh}, vs->scale,
+			vs->imageproc == IMAGEPROC_FLIPH, false, &img))
+			return;
+
+		vs->vinf.text.source = NULL;
+		assign_image(vobj, fname, &img);
+		arcan_mem_free(fname);
 	}
 
-	dst->vstore->w = neww;
-	dst->vstore->h = newh;
+	agp_update_vstore(vs, true);
+}
 
-/*
- * for the asynch case, we need to do this separately as we're in a different
- * thread and forcibly assigning the glcontext to another thread is expensive */
+arcan_errc arcan_vint_getimage(
+	const char* fname, arcan_vobject* dst, img_cons forced)
+{
+	struct arcan_vdecode img;
+	arcan_errc rv = arcan_vint_decode(fname, forced, dst->vstore->scale,
+		dst->vstore->imageproc == IMAGEPROC_FLIPH, want_compress(dst->vstore), &img);
+
+	if (ARCAN_OK != rv)
+		return rv;
 
-push_comp:
-	if (!asynchsrc && dst->vstore->txmapped != TXSTATE_OFF)
+	dst->feed.state.tag = ARCAN_TAG_IMAGE;
+	assign_image(dst, fname, &img);
+
+	if (dst->vstore->txmapped != TXSTATE_OFF && !arcan_vint_atlas_alloc(dst))
 		agp_update_vstore(dst->vstore, true);
 
-done:
-	arcan_sem_post(asynchsynch);
 	return rv;
 }
 
@@ -1870,6 +2010,7 @@ arcan_errc arcan_video_framecyclemode(arcan_vobj_id id, int mode)
 		return ARCAN_ERRC_UNACCEPTED_STATE;
 
 	vobj->frameset->ctr = vobj->frameset->mctr = abs(mode);
+	tick_activate(vobj);
 
 	return ARCAN_OK;
 }
@@ -1904,6 +2045,8 @@ void arcan_video_cursorstore(arcan_vobj_id src)
 		vobj->vstore->txmapped != TXSTATE_TEX2D)
 		return;
 
+	arcan_vint_atlas_detach(vobj);
+
 /* texture coordinates are managed separately through _display.cursor_txcos */
 	arcan_video_display.cursor.vstore = vobj->vstore;
 	vobj->vstore->refcount++;
@@ -1918,6 +2061,7 @@ arcan_errc arcan_video_shareglstore(arcan_vobj_id sid, arcan_vobj_id did)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
 /* remove the original target store, substitute in our own */
+	arcan_vint_atlas_release(dst);
 	arcan_vint_drop_vstore(dst->vstore);
 
 /* if the source is broken, convert dst to null store (color with bad prg) */
@@ -1937,6 +2081,8 @@ arcan_errc arcan_video_shareglstore(arcan_vobj_id sid, arcan_vobj_id did)
 
 	dst->vstore = src->vstore;
 	dst->vstore->refcount++;
+	arcan_vint_atlas_share(src, dst);
+	FLAG_RTDEP();
 
 /* customized texture coordinates unless we should use defaults ... */
 	if (src->txcos){
@@ -2272,6 +2418,7 @@ arcan_errc arcan_video_linkrendertarget(arcan_vobj_id did,
 	vobj = arcan_video_getobject(did);
 	struct rendertarget* newtgt = arcan_vint_findrt(vobj);
 	newtgt->link = tgt;
+	FLAG_RTDEP();
 	return ARCAN_OK;
 }
 
@@ -2291,6 +2438,8 @@ arcan_errc arcan_video_setuprendertarget(arcan_vobj_id did,
 		return rv;
 	}
 
+	arcan_vint_atlas_detach(vobj);
+
 /* hard-coded number of render-targets allowed */
 	if (current_context->n_rtargets >= RENDERTARGET_LIMIT)
 		return ARCAN_ERRC_OUT_OF_SPACE;
@@ -2298,6 +2447,7 @@ arcan_errc arcan_video_setuprendertarget(arcan_vobj_id did,
 	int ind = current_context->n_rtargets++;
 	struct rendertarget* dst = &current_context->rtargets[ ind ];
 	*dst = (struct rendertarget){};
+	FLAG_RTDEP();
 
 	FL_SET(vobj, FL_RTGT);
 	FL_SET(dst, TGTFL_ALIVE);
@@ -2367,6 +2517,8 @@ arcan_errc arcan_video_setasframe(arcan_vobj_id dst,
 	if (!dstvobj || !srcvobj)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
+/* frames aren't tracked as atlas users, so they can't follow a repack */
+	arcan_vint_atlas_detach(srcvobj);
 	if (dstvobj->frameset == NULL || srcvobj->vstore->txmapped != TXSTATE_TEX2D)
 		return ARCAN_ERRC_UNACCEPTED_STATE;
 
@@ -2387,39 +2539,33 @@ arcan_errc arcan_video_setasframe(arcan_vobj_id dst,
 		arcan_vint_defaultmapping(store->txcos, 1.0, 1.0);
 
 	store->frame->refcount++;
+	FLAG_RTDEP();
 
 	return ARCAN_OK;
 }
 
-struct thread_loader_args {
-	arcan_vobject* dst;
-	pthread_t self;
+struct asynch_loader_args {
+	struct arcan_vdecode_job* job;
 	arcan_vobj_id dstid;
 	char* fname;
 	intptr_t tag;
-	img_cons constraints;
-	arcan_errc rc;
 };
 
-static void* thread_loader(void* in)
-{
-	struct thread_loader_args* largs = (struct thread_loader_args*) in;
-	arcan_vobject* dst = largs->dst;
-	largs->rc = arcan_vint_getimage(largs->fname, dst, largs->constraints, true);
-	dst->feed.state.tag = ARCAN_TAG_ASYNCIMGRD;
-	return 0;
-}
-
 void arcan_vint_joinasynch(arcan_vobject* img, bool emit, bool force)
 {
-	if (!force && img->feed.state.tag != ARCAN_TAG_ASYNCIMGRD){
+	if (img->feed.state.tag != ARCAN_TAG_ASYNCIMGLD &&
+		img->feed.state.tag != ARCAN_TAG_ASYNCIMGRD)
 		return;
-	}
 
-	struct thread_loader_args* args =
-		(struct thread_loader_args*) img->feed.state.ptr;
+	struct asynch_loader_args* args =
+		(struct asynch_loader_args*) img->feed.state.ptr;
 
-	pthread_join(args->self, NULL);
+/* visible objects are decoded first */
+	struct arcan_vdecode res;
+	if (!arcan_vint_decode_collect(args->job, force, &res)){
+		arcan_vint_decode_prio(args->job, img->current.opa > EPSILON);
+		return;
+	}
 
 	arcan_event loadev = {
 		.category = EVENT_VIDEO,
@@ -2427,7 +2573,8 @@ void arcan_vint_joinasynch(arcan_vobject* img, bool emit, bool force)
 		.vid.source = args->dstid
 	};
 
-	if (args->rc == ARCAN_OK){
+	if (res.rc == ARCAN_OK){
+		assign_image(img, args->fname, &res);
 		loadev.vid.kind = EVENT_VIDEO_ASYNCHIMAGE_LOADED;
 		loadev.vid.width = img->origw;
 		loadev.vid.height = img->origh;
@@ -2450,7 +2597,9 @@ void arcan_vint_joinasynch(arcan_vobject* img, bool emit, bool force)
 		loadev.vid.kind = EVENT_VIDEO_ASYNCHIMAGE_FAILED;
 	}
 
-	agp_update_vstore(img->vstore, true);
+	if (res.rc != ARCAN_OK || !arcan_vint_atlas_alloc(img))
+		agp_update_vstore(img->vstore, true);
+	FLAG_PICK_OBJ(img);
 
 	if (emit)
 		arcan_event_enqueue(arcan_event_defaultctx(), &loadev);
@@ -2461,6 +2610,19 @@ void arcan_vint_joinasynch(arcan_vobject* img, bool emit, bool force)
 	img->feed.state.tag = ARCAN_TAG_IMAGE;
 }
 
+/* the object is going away, the decode result will never be collected */
+static void cancel_asynch(arcan_vobject* img)
+{
+	struct asynch_loader_args* args =
+		(struct asynch_loader_args*) img->feed.state.ptr;
+
+	arcan_vint_decode_cancel(args->job);
+	arcan_mem_free(args->fname);
+	arcan_mem_free(args);
+	img->feed.state.ptr = NULL;
+	img->feed.state.tag = ARCAN_TAG_NONE;
+}
+
 static arcan_vobj_id loadimage_asynch(const char* fname,
 	img_cons constraints, intptr_t tag)
 {
@@ -2469,21 +2631,21 @@ static arcan_vobj_id loadimage_asynch(const char* fname,
 	if (!dstobj)
 		return rv;
 
-	struct thread_loader_args* args = arcan_alloc_mem(
-		sizeof(struct thread_loader_args),
+	struct asynch_loader_args* args = arcan_alloc_mem(
+		sizeof(struct asynch_loader_args),
 		ARCAN_MEM_THREADCTX, 0, ARCAN_MEMALIGN_NATURAL);
 
 	args->dstid = rv;
-	args->dst = dstobj;
 	args->fname = strdup(fname);
 	args->tag = tag;
-	args->constraints = constraints;
+	args->job = arcan_vint_decode_queue(fname, constraints,
+		dstobj->vstore->scale, dstobj->vstore->imageproc == IMAGEPROC_FLIPH,
+		want_compress(dstobj->vstore), 0);
 
 	dstobj->feed.state.tag = ARCAN_TAG_ASYNCIMGLD;
+	tick_activate(dstobj);
 	dstobj->feed.state.ptr = args;
 
-	pthread_create(&args->self, NULL, thread_loader, (void*) args);
-
 	return rv;
 }
 
@@ -2514,7 +2676,7 @@ static arcan_vobj_id loadimage(const char* fname, img_cons constraints,
 	if (newvobj == NULL)
 		return ARCAN_EID;
 
-	arcan_errc rc = arcan_vint_getimage(fname, newvobj, constraints, false);
+	arcan_errc rc = arcan_vint_getimage(fname, newvobj, constraints);
 
 	if (rc != ARCAN_OK)
 		arcan_video_deleteobject(rv);
@@ -2545,8 +2707,10 @@ arcan_errc arcan_video_alterfeed(arcan_vobj_id id,
 	if (!vobj)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
+	arcan_vint_atlas_detach(vobj);
 	vobj->feed.state = state;
 	vobj->feed.ffunc = cb;
+	tick_activate(vobj);
 
 	return ARCAN_OK;
 }
@@ -2593,6 +2757,7 @@ static arcan_vobj_id arcan_video_setupfeed(
 		ARCAN_MEM_VBUFFER, ARCAN_MEM_BZERO, ARCAN_MEMALIGN_PAGE);
 
 	newvobj->feed.ffunc = ffunc;
+	tick_activate(newvobj);
 	agp_update_vstore(newvobj->vstore, true);
 
 	return rv;
@@ -2610,6 +2775,8 @@ arcan_errc arcan_video_resizefeed(arcan_vobj_id id, size_t w, size_t h)
 		vobj->feed.state.tag == ARCAN_TAG_ASYNCIMGRD)
 		arcan_video_pushasynch(id);
 
+	arcan_vint_atlas_detach(vobj);
+
 /* rescale transformation chain */
 	float ox = (float)vobj->origw*vobj->current.scale.x;
 	float oy = (float)vobj->origh*vobj->current.scale.y;
@@ -2698,6 +2865,7 @@ arcan_errc arcan_video_scaletxcos(arcan_vobj_id id, float sfs, float sft)
 	if (!vobj)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
+	arcan_vint_atlas_detach(vobj);
 	if (!vobj->txcos){
 		vobj->txcos = arcan_alloc_mem(8 * sizeof(float),
 			ARCAN_MEM_VSTRUCT, 0, ARCAN_MEMALIGN_SIMD);
@@ -2828,6 +2996,7 @@ arcan_errc arcan_video_setlife(arcan_vobj_id id, unsigned lifetime)
 			vobj->mask |= MASK_LIVING;
 
 		vobj->lifetime = lifetime;
+		tick_activate(vobj);
 		rv = ARCAN_OK;
 	}
 
@@ -3074,6 +3243,7 @@ arcan_errc arcan_video_objecttexmode(arcan_vobj_id id,
 	arcan_errc rv = ARCAN_ERRC_NO_SUCH_OBJECT;
 
 	if (src){
+		arcan_vint_atlas_detach(src);
 		src->vstore->txu = modes;
 		src->vstore->txv = modet;
 		agp_update_vstore(src->vstore, false);
@@ -3091,6 +3261,7 @@ arcan_errc arcan_video_objectfilter(arcan_vobj_id id,
 
 /* fake an upload with disabled filteroptions */
 	if (src){
+		arcan_vint_atlas_detach(src);
 		src->vstore->filtermode = mode;
 		agp_update_vstore(src->vstore, false);
 	}
@@ -3158,6 +3329,7 @@ arcan_errc arcan_video_copytransform(arcan_vobj_id sid, arcan_vobj_id did)
 
 	arcan_video_zaptransform(did, 0, NULL);
 	dst->transform = dup_chain(src->transform);
+	tick_activate(dst);
 	update_zv(dst, src->order);
 
 	invalidate_cache(dst);
@@ -3167,6 +3339,7 @@ arcan_errc arcan_video_copytransform(arcan_vobj_id sid, arcan_vobj_id did)
  * chain, as scale is relative origw? */
 	dst->origw = src->origw;
 	dst->origh = src->origh;
+	FLAG_PICK_OBJ(dst);
 
 	return ARCAN_OK;
 }
@@ -3244,6 +3417,7 @@ static void drop_rtarget(arcan_vobject* vobj)
 
 /* found one, disassociate with the context */
 	current_context->n_rtargets--;
+	FLAG_RTDEP();
 	if (current_context->n_rtargets < 0){
 		arcan_warning(
 			"[bug] rtgt count (%d) < 0\n", current_context->n_rtargets);
@@ -3442,10 +3616,12 @@ arcan_errc arcan_video_deleteobject(arcan_vobj_id id)
 		vobj->feed.state.tag = ARCAN_TAG_NONE;
 	}
 
-	if (vobj->feed.state.tag == ARCAN_TAG_ASYNCIMGLD)
-		arcan_video_pushasynch(id);
+	if (vobj->feed.state.tag == ARCAN_TAG_ASYNCIMGLD ||
+		vobj->feed.state.tag == ARCAN_TAG_ASYNCIMGRD)
+		cancel_asynch(vobj);
 
 /* video storage, will take care of refcounting in case of shared storage */
+	arcan_vint_atlas_release(vobj);
 	arcan_vint_drop_vstore(vobj->vstore);
 	vobj->vstore = NULL;
 
@@ -3462,6 +3638,8 @@ arcan_errc arcan_video_deleteobject(arcan_vobj_id id)
 	arcan_mem_free(vobj->tracetag);
 	arcan_vint_dropshape(vobj);
 
+	active_drop(current_context, vobj);
+
 /* lots of default values are assumed to be 0, so reset the
  * entire object to be sure. will help leak detectors as well */
 	memset(vobj, 0, sizeof(arcan_vobject));
@@ -3486,6 +3664,7 @@ arcan_errc arcan_video_override_mapping(arcan_vobj_id id, float* newmapping)
 	arcan_errc rv = ARCAN_ERRC_NO_SUCH_OBJECT;
 
 	if (vobj && id > 0){
+		arcan_vint_atlas_detach(vobj);
 		if (vobj->txcos)
 			arcan_mem_free(vobj->txcos);
 
@@ -3505,6 +3684,7 @@ arcan_errc arcan_video_retrieve_mapping(arcan_vobj_id id, float* dst)
 	arcan_errc rv = ARCAN_ERRC_NO_SUCH_OBJECT;
 
 	if (vobj && dst && id > 0){
+		arcan_vint_atlas_detach(vobj);
 		float* sptr = vobj->txcos ?
 			vobj->txcos : arcan_video_display.default_txcos;
 		memcpy(dst, sptr, sizeof(float) * 8);
@@ -3617,8 +3797,10 @@ arcan_errc arcan_video_objectrotate3d(arcan_vobj_id id,
 				ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO, ARCAN_MEMALIGN_NATURAL);
 	}
 
-	if (!vobj->transform)
+	if (!vobj->transform){
 		vobj->transform = base;
+		tick_activate(vobj);
+	}
 
 	base->rotate.startt = last->rotate.endt < arcan_video_display.c_ticks ?
 		arcan_video_display.c_ticks : last->rotate.endt;
@@ -3648,6 +3830,8 @@ arcan_errc arcan_video_allocframes(arcan_vobj_id id,
 	if (!target)
 		return rv;
 
+	arcan_vint_atlas_detach(target);
+
 /* similar restrictions as with sharestore */
 	if (target->vstore->txmapped != TXSTATE_TEX2D)
 		return ARCAN_ERRC_UNACCEPTED_STATE;
@@ -3682,6 +3866,7 @@ arcan_errc arcan_video_allocframes(arcan_vobj_id id,
 
 		target->vstore->refcount++;
 	}
+	FLAG_RTDEP();
 
 	target->frameset->mode = mode;
 
@@ -3747,8 +3932,10 @@ arcan_errc arcan_video_objectopacity(arcan_vobj_id id,
 							ARCAN_MEM_BZERO, ARCAN_MEMALIGN_NATURAL);
 			}
 
-			if (!vobj->transform)
+			if (!vobj->transform){
 				vobj->transform = base;
+				tick_activate(vobj);
+			}
 
 			if (vobj->owner)
 				vobj->owner->transfc++;
@@ -3881,8 +4068,10 @@ arcan_errc arcan_video_objectmove(arcan_vobj_id id, float newx,
 
 	point newp = {newx, newy, newz};
 
-	if (!vobj->transform)
+	if (!vobj->transform){
 		vobj->transform = base;
+		tick_activate(vobj);
+	}
 
 	base->move.startt = last->move.endt < arcan_video_display.c_ticks ?
 		arcan_video_display.c_ticks : last->move.endt;
@@ -3942,8 +4131,10 @@ arcan_errc arcan_video_objectscale(arcan_vobj_id id, float wf,
 						ARCAN_MEM_VSTRUCT, ARCAN_MEM_BZERO, ARCAN_MEMALIGN_NATURAL);
 			}
 
-			if (!vobj->transform)
+			if (!vobj->transform){
 				vobj->transform = base;
+				tick_activate(vobj);
+			}
 
 			base->scale.startt = last->scale.endt < arcan_video_display.c_ticks ?
 				arcan_video_display.c_ticks : last->scale.endt;
@@ -4141,6 +4332,117 @@ static inline float lerp_fract(float startt, float endt, float ts)
 	return rv;
 }
 
+/*
+ * Transform batching
+ *
+ * Ongoing (not completing) blend, move and scale steps are queued as
+ * independent scalar lanes, grouped by interpolation function, rather than
+ * evaluated in update_object. Once all objects in a rendertarget have been
+ * stepped, each group is evaluated with the batch interpolators and written
+ * back. Completion, cycling and events are still handled by update_object.
+ */
+static struct transform_lanes {
+	float* sv, * ev, * fract, * res;
+	float** dst;
+	size_t count, limit;
+} transform_batch[ARCAN_VINTER_ENDMARKER];
+
+static bool grow_lanes(struct transform_lanes* lanes)
+{
+	size_t limit = lanes->limit ? lanes->limit * 2 : 1024;
+	size_t lane_sz = sizeof(float) * 4 + sizeof(float*);
+
+	char* buf = arcan_alloc_mem(limit * lane_sz,
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_SIMD);
+	if (!buf)
+		return false;
+
+	struct transform_lanes new = {
+		.dst = (float**) buf,
+		.sv = (float*)(buf + limit * sizeof(float*)),
+		.count = lanes->count,
+		.limit = limit
+	};
+	new.ev = &new.sv[limit];
+	new.fract = &new.ev[limit];
+	new.res = &new.fract[limit];
+
+	if (lanes->limit){
+		memcpy(new.dst, lanes->dst, lanes->count * sizeof(float*));
+		memcpy(new.sv, lanes->sv, lanes->count * sizeof(float));
+		memcpy(new.ev, lanes->ev, lanes->count * sizeof(float));
+		memcpy(new.fract, lanes->fract, lanes->count * sizeof(float));
+		arcan_mem_free(lanes->dst);
+	}
+
+	*lanes = new;
+	return true;
+}
+
+static inline bool queue_lane(
+	unsigned kind, float* dst, float sv, float ev, float fract)
+{
+	struct transform_lanes* lanes = &transform_batch[kind];
+	if (lanes->count == lanes->limit && !grow_lanes(lanes))
+		return false;
+
+	size_t i = lanes->count++;
+	lanes->dst[i] = dst;
+	lanes->sv[i] = sv;
+	lanes->ev[i] = ev;
+	lanes->fract[i] = fract;
+
+	return true;
+}
+
+static void flush_transforms()
+{
+	for (size_t i = 0; i < ARCAN_VINTER_ENDMARKER; i++){
+		struct transform_lanes* lanes = &transform_batch[i];
+		if (!lanes->count)
+			continue;
+
+		lut_interp_batch[i](
+			lanes->res, lanes->sv, lanes->ev, lanes->fract, lanes->count);
+
+		for (size_t j = 0; j < lanes->count; j++)
+			*(lanes->dst[j]) = lanes->res[j];
+
+		lanes->count = 0;
+	}
+}
+
+static void drop_transform_batch()
+{
+	for (size_t i = 0; i < ARCAN_VINTER_ENDMARKER; i++){
+		arcan_mem_free(transform_batch[i].dst);
+		transform_batch[i] = (struct transform_lanes){};
+	}
+}
+
+static inline void step_1d(float* dst,
+	unsigned kind, float sv, float ev, float fract)
+{
+	if (arcan_video_display.batch_transform &&
+		queue_lane(kind, dst, sv, ev, fract))
+		return;
+
+	*dst = lut_interp_1d[kind](sv, ev, fract);
+}
+
+static inline void step_3d(vector* dst,
+	unsigned kind, vector sv, vector ev, float fract)
+{
+/* a partial queue just means that some lanes get written twice */
+	if (arcan_video_display.batch_transform &&
+		queue_lane(kind, &dst->x, sv.x, ev.x, fract) &&
+		queue_lane(kind, &dst->y, sv.y, ev.y, fract) &&
+		queue_lane(kind, &dst->z, sv.z, ev.z, fract))
+		return;
+
+	*dst = lut_interp_3d[kind](sv, ev, fract);
+}
+
 static int update_object(arcan_vobject* ci, unsigned long long stamp)
 {
 	int upd = 0;
@@ -4162,11 +4464,6 @@ static int update_object(arcan_vobject* ci, unsigned long long stamp)
 		float fract = lerp_fract(ci->transform->blend.startt,
 			ci->transform->blend.endt, stamp);
 
-		ci->current.opa = lut_interp_1d[ci->transform->blend.interp](
-			ci->transform->blend.startopa,
-			ci->transform->blend.endopa, fract
-		);
-
 		if (fract > 1.0-EPSILON){
 			ci->current.opa = ci->transform->blend.endopa;
 
@@ -4185,6 +4482,9 @@ static int update_object(arcan_vobject* ci, unsigned long long stamp)
 				offsetof(surface_transform, blend),
 				sizeof(struct transf_blend));
 		}
+		else
+			step_1d(&ci->current.opa, ci->transform->blend.interp,
+				ci->transform->blend.startopa, ci->transform->blend.endopa, fract);
 	}
 
 	if (ci->transform && ci->transform->move.startt){
@@ -4192,11 +4492,6 @@ static int update_object(arcan_vobject* ci, unsigned long long stamp)
 		float fract = lerp_fract(ci->transform->move.startt,
 			ci->transform->move.endt, stamp);
 
-		ci->current.position = lut_interp_3d[ci->transform->move.interp](
-				ci->transform->move.startp,
-				ci->transform->move.endp, fract
-			);
-
 		if (fract > 1.0-EPSILON){
 			ci->current.position = ci->transform->move.endp;
 
@@ -4220,16 +4515,15 @@ static int update_object(arcan_vobject* ci, unsigned long long stamp)
 				offsetof(surface_transform, move),
 				sizeof(struct transf_move));
 		}
+		else
+			step_3d(&ci->current.position, ci->transform->move.interp,
+				ci->transform->move.startp, ci->transform->move.endp, fract);
 	}
 
 	if (ci->transform && ci->transform->scale.startt){
 		upd++;
 		float fract = lerp_fract(ci->transform->scale.startt,
 			ci->transform->scale.endt, stamp);
-		ci->current.scale = lut_interp_3d[ci->transform->scale.interp](
-			ci->transform->scale.startd,
-			ci->transform->scale.endd, fract
-		);
 
 		if (fract > 1.0-EPSILON){
 			ci->current.scale = ci->transform->scale.endd;
@@ -4251,6 +4545,9 @@ static int update_object(arcan_vobject* ci, unsigned long long stamp)
 				offsetof(surface_transform, scale),
 				sizeof(struct transf_scale));
 		}
+		else
+			step_3d(&ci->current.scale, ci->transform->scale.interp,
+				ci->transform->scale.startd, ci->transform->scale.endd, fract);
 	}
 
 	if (ci->transform && ci->transform->rotate.startt){
@@ -4337,40 +4634,103 @@ static inline void process_readback(struct rendertarget* tgt, float fract)
 	}
 }
 
+/* the parts of a tick that are not transformations */
+static inline void tick_feed(arcan_vobject* elem)
+{
+	if (elem->feed.ffunc)
+		arcan_ffunc_lookup(elem->feed.ffunc)
+			(FFUNC_TICK, 0, 0, 0, 0, 0, elem->feed.state, elem->cellid);
+
+/* mode > 0, cycle activate frame every 'n' ticks */
+	if (elem->frameset && elem->frameset->mctr != 0){
+		elem->frameset->ctr--;
+		if (elem->frameset->ctr == 0){
+			step_active_frame(elem);
+			elem->frameset->ctr = abs( elem->frameset->mctr );
+		}
+	}
+
+	if ((elem->mask & MASK_LIVING) > 0)
+		expire_object(elem);
+}
+
 /*
- * return number of actual objects that were updated / dirty,
- * move/process/etc. and possibly dispatch draw commands if needed
+ * step the members of the active set, the transformation counts go to the
+ * rendertarget that owns the object. Objects that are not attached anywhere
+ * are skipped, as they would be when walking the rendertargets.
  */
-static int tick_rendertarget(struct rendertarget* tgt)
+static void tick_active(struct arcan_video_context* ctx)
 {
-	tgt->transfc = 0;
-	arcan_vobject_litem* current = tgt->first;
+	unsigned long stamp = arcan_video_display.c_ticks;
 
-	while (current){
-		arcan_vobject* elem = current->elem;
+	for (size_t i = 0; i < ctx->active.count; i++){
+		arcan_vobject* elem = &ctx->vitems_pool[ctx->active.ids[i]];
+		if (!elem->owner)
+			continue;
 
 		arcan_vint_joinasynch(elem, true, false);
 
-		if (elem->last_updated != arcan_video_display.c_ticks)
-			tgt->transfc += update_object(elem, arcan_video_display.c_ticks);
+		if (elem->last_updated != stamp)
+			elem->owner->transfc += update_object(elem, stamp);
+	}
+
+	flush_transforms();
 
-		if (elem->feed.ffunc)
-			arcan_ffunc_lookup(elem->feed.ffunc)
-				(FFUNC_TICK, 0, 0, 0, 0, 0, elem->feed.state, elem->cellid);
+/* the feed tick might delete objects (swapping in the last member) or add
+ * new ones, so walk a snapshot of the set and skip the ones that left it */
+	size_t count = ctx->active.count;
+	if (!count)
+		return;
 
-/* mode > 0, cycle activate frame every 'n' ticks */
-		if (elem->frameset && elem->frameset->mctr != 0){
-			elem->frameset->ctr--;
-			if (elem->frameset->ctr == 0){
-				step_active_frame(elem);
-				elem->frameset->ctr = abs( elem->frameset->mctr );
-			}
+	memcpy(ctx->active.tick, ctx->active.ids, count * sizeof(arcan_vobj_id));
+
+	for (size_t i = 0; i < count; i++){
+		arcan_vobject* elem = &ctx->vitems_pool[ctx->active.tick[i]];
+		if (!elem->active_ind)
+			continue;
+
+		if (elem->owner)
+			tick_feed(elem);
+
+		if (elem->active_ind && !tick_needed(elem))
+			active_drop(ctx, elem);
+	}
+}
+
+/*
+ * return number of actual objects that were updated / dirty,
+ * move/process/etc. and possibly dispatch draw commands if needed
+ */
+static int tick_rendertarget(struct rendertarget* tgt)
+{
+/* with the active set, the objects have already been stepped */
+	if (!arcan_video_display.active_set){
+		tgt->transfc = 0;
+		arcan_vobject_litem* current = tgt->first;
+
+/* step all objects first so the queued transforms are written back before
+ * anything else in the tick gets to look at the results */
+		if (arcan_video_display.batch_transform){
+			for (; current; current = current->next)
+				if (current->elem->last_updated != arcan_video_display.c_ticks)
+					tgt->transfc +=
+						update_object(current->elem, arcan_video_display.c_ticks);
+
+			flush_transforms();
+			current = tgt->first;
 		}
 
-		if ((elem->mask & MASK_LIVING) > 0)
-			expire_object(elem);
+		while (current){
+			arcan_vobject* elem = current->elem;
 
-		current = current->next;
+			arcan_vint_joinasynch(elem, true, false);
+
+			if (elem->last_updated != arcan_video_display.c_ticks)
+				tgt->transfc += update_object(elem, arcan_video_display.c_ticks);
+
+			tick_feed(elem);
+			current = current->next;
+		}
 	}
 
 	if (tgt->refresh > 0 && process_counter(tgt,
@@ -4401,10 +4761,19 @@ unsigned arcan_video_tick(unsigned steps, unsigned* njobs)
 	do {
 		arcan_video_display.dirty +=
 			update_object(&current_context->world, arcan_video_display.c_ticks);
+		flush_transforms();
 
 		arcan_video_display.dirty +=
 			agp_shader_envv(TIMESTAMP_D, &tsd, sizeof(uint32_t));
 
+		if (arcan_video_display.active_set){
+			for (size_t i = 0; i < current_context->n_rtargets; i++)
+				current_context->rtargets[i].transfc = 0;
+			current_context->stdoutp.transfc = 0;
+
+			tick_active(current_context);
+		}
+
 		for (size_t i = 0; i < current_context->n_rtargets; i++)
 			arcan_video_display.dirty +=
 				tick_rendertarget(&current_context->rtargets[i]);
@@ -4459,6 +4828,9 @@ arcan_errc arcan_video_persistobject(arcan_vobj_id id)
 	if (!vobj)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
+/* atlas pages belong to the context and would be lost on push */
+	arcan_vint_atlas_detach(vobj);
+
 	if (!vobj->frameset &&
 		vobj->vstore->refcount == 1 &&
 		vobj->parent == &current_context->world){
@@ -4557,10 +4929,24 @@ static void apply(arcan_vobject* vobj, surface_properties* dprops,
  * and a resolve- pass is performed with its results stored in prop_matr
  * which is then re-used every rendercall.
  * Queueing a transformation immediately invalidates the cache.
+ *
+ * While the rendertargets are being processed, nothing can change the
+ * object properties, so the results are also stored in the frame_cache
+ * and stamped with the resolve_cookie. Siblings in animated hierarchies
+ * then only resolve their shared parent chain once per frame.
  */
 void arcan_resolve_vidprop(
 	arcan_vobject* vobj, float lerp, surface_properties* props)
 {
+	uint64_t cookie = arcan_video_display.resolve_cookie;
+	if (cookie &&
+		vobj->frame_cache.cookie == cookie && vobj->frame_cache.lerp == lerp){
+		*props = vobj->frame_cache.props;
+		return;
+	}
+
+	bool static_chain = !vobj->transform;
+
 	if (vobj->valid_cache)
 		*props = vobj->prop_cache;
 
@@ -4631,28 +5017,32 @@ void arcan_resolve_vidprop(
 	else
 		apply(vobj, props, &current_context->world.current, lerp, true);
 
-/* the cache evaluation here is a bit shallow - there are differences between
- * in-frame caching (multiple resolves of related objects within the same
- * frame) and time-stable (no ongoing transformations queued) - likely that big
- * gains can be have with in-frame caching as well */
-	arcan_vobject* current = vobj;
-	bool can_cache = true;
-	while (current && can_cache){
-		if (current->transform){
-			can_cache = false;
-			break;
-		}
-		current = current->parent;
+/* re-use the parent stamp if it has been resolved during this frame */
+	arcan_vobject* parent = vobj->parent;
+	if (static_chain && parent){
+		if (cookie && parent->frame_cache.cookie == cookie)
+			static_chain = parent->frame_cache.static_chain;
+		else
+			for (; parent && static_chain; parent = parent->parent)
+				static_chain = !parent->transform;
 	}
 
-	if (can_cache && vobj->owner && !vobj->valid_cache){
+/* time-stable (no ongoing transformations queued in the chain) results are
+ * kept along with the modelview until invalidated, in-frame results until
+ * the next refresh */
+	if (static_chain && vobj->owner && !vobj->valid_cache){
 		surface_properties dprop = *props;
 		vobj->prop_cache  = *props;
 		vobj->valid_cache = true;
 		build_modelview(vobj->prop_matr, vobj->owner->base, &dprop, vobj);
 	}
-	else
-		;
+
+	if (cookie){
+		vobj->frame_cache.cookie = cookie;
+		vobj->frame_cache.lerp = lerp;
+		vobj->frame_cache.static_chain = static_chain;
+		vobj->frame_cache.props = *props;
+	}
 }
 
 static void calc_cp_area(arcan_vobject* vobj, point* ul, point* lr)
@@ -4761,15 +5151,12 @@ static void update_shenv(arcan_vobject* src, surface_properties* prop)
 	}
 }
 
-static inline void setup_surf(struct rendertarget* dst,
+static inline void setup_modelview(struct rendertarget* dst,
 	surface_properties* prop, arcan_vobject* src, float** mv)
 {
 /* just temporary storage/scratch */
 	static float _Alignas(16) dmatr[16];
 
-	if (src->feed.state.tag == ARCAN_TAG_ASYNCIMGLD)
-		return;
-
 /* currently, we only cache the primary rendertarget, and the better option is
  * to actually remove secondary attachments etc. now that we have order-peeling
  * and sharestorage there should really just be 1:1 between src and dst */
@@ -4784,6 +5171,15 @@ static inline void setup_surf(struct rendertarget* dst,
 		build_modelview(dmatr, dst->base, prop, src);
 		*mv = dmatr;
 	}
+}
+
+static inline void setup_surf(struct rendertarget* dst,
+	surface_properties* prop, arcan_vobject* src, float** mv)
+{
+	if (src->feed.state.tag == ARCAN_TAG_ASYNCIMGLD)
+		return;
+
+	setup_modelview(dst, prop, src, mv);
 	update_shenv(src, prop);
 }
 
@@ -5050,24 +5446,31 @@ void arcan_vint_bindmulti(arcan_vobject* elem, size_t ind)
 	agp_activate_vstore_multi(elems, sz);
 }
 
+static inline enum arcan_blendfunc draw_blend(
+	arcan_vobject* vobj, surface_properties* dprops)
+{
+	if (vobj->blendmode == BLEND_NORMAL && dprops->opa > 1.0 - EPSILON)
+		return BLEND_NONE;
+	return vobj->blendmode;
+}
+
 static int draw_vobj(struct rendertarget* tgt,
 	arcan_vobject* vobj, surface_properties* dprops, float* txcos)
 {
-	if (vobj->blendmode == BLEND_NORMAL && dprops->opa > 1.0 - EPSILON)
-		agp_blendstate(BLEND_NONE);
-	else
-		agp_blendstate(vobj->blendmode);
+	agp_blendstate(draw_blend(vobj, dprops));
 
 /* pick the right vstore drawing type (textured, colored) */
 	struct agp_vstore* vstore = vobj->vstore;
 	if (vstore->txmapped == TXSTATE_OFF && vobj->program != 0){
 		draw_colorsurf(tgt, *dprops, vobj, vstore->vinf.col.r,
 			vstore->vinf.col.g, vstore->vinf.col.b, txcos);
+		arcan_video_display.drawcalls++;
 		return 1;
 	}
 
 	if (vstore->txmapped == TXSTATE_TEX2D){
 		draw_texsurf(tgt, *dprops, vobj, txcos);
+		arcan_video_display.drawcalls++;
 		return 1;
 	}
 
@@ -5075,11 +5478,77 @@ static int draw_vobj(struct rendertarget* tgt,
 }
 
 /*
- * Apply clipping without using the stencil buffer, cheaper but with some
- * caveats of its own. Will work particularly bad for partial clipping with
- * customized texture coordinates.
+ * Runs of objects that are drawn with the default shader from the same store
+ * with the same blending and opacity only differ in modelview and texture
+ * coordinates, so they can be merged into one draw through the agp batch.
+ * The objects are not reordered, a run ends with the first object that
+ * doesn't match.
  */
-static inline bool setup_shallow_texclip(
+static struct {
+	bool open;
+	agp_shader_id shid;
+	struct agp_vstore* vstore;
+	enum arcan_blendfunc blend;
+	float opa;
+} draw_batch;
+
+static void batch_flush()
+{
+	if (!draw_batch.open)
+		return;
+
+	arcan_video_display.drawcalls += agp_batch_flush();
+	draw_batch.open = false;
+}
+
+static bool batch_vobj(struct rendertarget* tgt, arcan_vobject* elem,
+	agp_shader_id shid, surface_properties* dprops, float* txcos)
+{
+	if (!arcan_video_display.batch_2d ||
+		shid != agp_default_shader(BASIC_2D) ||
+		elem->frameset || elem->shape || FL_TEST(elem, FL_FULL3D) ||
+		elem->vstore->txmapped != TXSTATE_TEX2D ||
+		elem->feed.state.tag == ARCAN_TAG_ASYNCIMGLD ||
+		(elem->clip != ARCAN_CLIP_OFF && get_clip_source(elem))){
+		batch_flush();
+		return false;
+	}
+
+	enum arcan_blendfunc blend = draw_blend(elem, dprops);
+	surface_properties prop = *dprops;
+	float* mvm = NULL;
+
+	if (!draw_batch.open || draw_batch.shid != shid ||
+		draw_batch.vstore != elem->vstore ||
+		draw_batch.blend != blend || draw_batch.opa != dprops->opa){
+		batch_flush();
+		agp_shader_activate(shid);
+		agp_activate_vstore(elem->vstore);
+		agp_blendstate(blend);
+
+		draw_batch.open = true;
+		draw_batch.shid = shid;
+		draw_batch.vstore = elem->vstore;
+		draw_batch.blend = blend;
+		draw_batch.opa = dprops->opa;
+
+		setup_surf(tgt, &prop, elem, &mvm);
+	}
+	else
+		setup_modelview(tgt, &prop, elem, &mvm);
+
+	agp_batch_quad(-prop.scale.x, -prop.scale.y,
+		prop.scale.x, prop.scale.y, txcos, mvm);
+
+	return true;
+}
+
+/*
+ * Apply clipping without using the stencil buffer, cheaper but with some
+ * caveats of its own. Will work particularly bad for partial clipping with
+ * customized texture coordinates.
+ */
+static inline bool setup_shallow_texclip(
 	arcan_vobject* elem,
 	arcan_vobject* clip_src,
 	float** txcos, surface_properties* dprops, float fract)
@@ -5165,6 +5634,472 @@ struct rendertarget* arcan_vint_current_rt()
 	return current_rendertarget;
 }
 
+static inline void resolve_dprops(
+	arcan_vobject* elem, float fract, surface_properties* dprops)
+{
+	if (arcan_video_display.recorded &&
+		elem->record.cookie == arcan_video_display.record_cookie){
+		*dprops = elem->record.props;
+	}
+	else {
+		*dprops = empty_surface();
+		arcan_resolve_vidprop(elem, fract, dprops);
+	}
+}
+
+/*
+ * Damage tracking
+ *
+ * Each pipeline entry keeps the bounds (normalized device coordinates), a
+ * hash of the draw state and the store update sequence from the last time it
+ * was drawn. Before drawing, these are compared to the current state and the
+ * bounds of whatever changed are merged into the rendertarget damage. Store
+ * updates that cover a known subregion (e.g. shmif dirty regions) only damage
+ * the part of the object that samples that region.
+ *
+ * The clear and the draw calls are then scissored to the damage merged with
+ * that of the frames since the current buffer was last drawn to (buffer age),
+ * and objects outside of it are skipped.
+ */
+static uint64_t damage_hash(uint64_t h, const void* buf, size_t n)
+{
+	const uint8_t* b = buf;
+	for (size_t i = 0; i < n; i++)
+		h = (h ^ b[i]) * 0x100000001b3ULL;
+	return h;
+}
+
+static void damage_bounds(struct rendertarget* tgt, arcan_vobject* elem,
+	surface_properties prop, const float* txcos, const float* sub, float* box)
+{
+	float* mvm = NULL;
+	setup_modelview(tgt, &prop, elem, &mvm);
+
+	float x1 = -prop.scale.x;
+	float y1 = -prop.scale.y;
+	float x2 = prop.scale.x;
+	float y2 = prop.scale.y;
+
+/* map the store region back through the texture coordinates, this only works
+ * when the coordinates are axis aligned with the quad (any flip is fine) */
+	if (sub){
+		float ds = txcos[2] - txcos[0];
+		float dt = txcos[5] - txcos[1];
+
+		if (fabsf(ds) > EPSILON && fabsf(dt) > EPSILON &&
+			txcos[0] == txcos[6] && txcos[2] == txcos[4] &&
+			txcos[1] == txcos[3] && txcos[5] == txcos[7]){
+			float sx1 = x1 + (sub[0] - txcos[0]) / ds * (x2 - x1);
+			float sx2 = x1 + (sub[2] - txcos[0]) / ds * (x2 - x1);
+			float sy1 = y1 + (sub[1] - txcos[1]) / dt * (y2 - y1);
+			float sy2 = y1 + (sub[3] - txcos[1]) / dt * (y2 - y1);
+
+			x1 = fmaxf(sx1 < sx2 ? sx1 : sx2, -prop.scale.x);
+			x2 = fminf(sx1 < sx2 ? sx2 : sx1, prop.scale.x);
+			y1 = fmaxf(sy1 < sy2 ? sy1 : sy2, -prop.scale.y);
+			y2 = fminf(sy1 < sy2 ? sy2 : sy1, prop.scale.y);
+		}
+	}
+
+	float corners[4][2] = {{x1, y1}, {x2, y1}, {x2, y2}, {x1, y2}};
+	box[0] = box[1] = INFINITY;
+	box[2] = box[3] = -INFINITY;
+
+	for (size_t i = 0; i < 4; i++){
+		float _Alignas(16) vert[4] = {corners[i][0], corners[i][1], 0.0, 1.0};
+		float _Alignas(16) mv[4];
+		float _Alignas(16) pv[4];
+
+		mult_matrix_vecf(mvm, vert, mv);
+		mult_matrix_vecf(tgt->projection, mv, pv);
+		float w = fabsf(pv[3]) > EPSILON ? pv[3] : 1.0;
+
+		box[0] = fminf(box[0], pv[0] / w);
+		box[1] = fminf(box[1], pv[1] / w);
+		box[2] = fmaxf(box[2], pv[0] / w);
+		box[3] = fmaxf(box[3], pv[1] / w);
+	}
+}
+
+static void damage_clipbox(struct rendertarget* tgt,
+	arcan_vobject* src, float fract, float* box)
+{
+	surface_properties pprops = empty_surface();
+	arcan_resolve_vidprop(src, fract, &pprops);
+	damage_bounds(tgt, src, pprops, NULL, NULL, box);
+}
+
+/*
+ * Hash the state that affects the output of [elem] beyond its bounds, for
+ * clipped objects that includes the objects that define the clip region. A
+ * shallow clip region also narrows the bounds in [box].
+ */
+static uint64_t damage_signature(struct rendertarget* tgt,
+	arcan_vobject* elem, surface_properties* dprops, agp_shader_id shid,
+	const float* txcos, struct agp_vstore* store, float fract, float* box)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	enum arcan_blendfunc blend = draw_blend(elem, dprops);
+
+	h = damage_hash(h, &store, sizeof(store));
+	h = damage_hash(h, &shid, sizeof(shid));
+	h = damage_hash(h, &blend, sizeof(blend));
+	h = damage_hash(h, &dprops->opa, sizeof(float));
+	h = damage_hash(h, txcos, sizeof(float) * 8);
+
+	if (store->txmapped == TXSTATE_OFF)
+		h = damage_hash(h, &store->vinf.col, sizeof(store->vinf.col));
+	else {
+		unsigned glid = agp_resolve_texid(store);
+		h = damage_hash(h, &glid, sizeof(glid));
+	}
+
+	if (elem->frameset)
+		h = damage_hash(h, &elem->frameset->index, sizeof(elem->frameset->index));
+
+	arcan_vobject* clip_src;
+	if (elem->clip == ARCAN_CLIP_OFF || !(clip_src = get_clip_source(elem)))
+		return h;
+
+	float cbox[4];
+	h = damage_hash(h, &elem->clip, sizeof(elem->clip));
+
+	if (elem->clip == ARCAN_CLIP_SHALLOW){
+		damage_clipbox(tgt, clip_src, fract, cbox);
+		h = damage_hash(h, cbox, sizeof(cbox));
+
+		box[0] = fmaxf(box[0], cbox[0]);
+		box[1] = fmaxf(box[1], cbox[1]);
+		box[2] = fminf(box[2], cbox[2]);
+		box[3] = fminf(box[3], cbox[3]);
+		return h;
+	}
+
+/* same walk as populate_stencil */
+	for (arcan_vobject* cur = elem;
+		cur->parent != &current_context->world; cur = cur->parent){
+		damage_clipbox(tgt, cur->parent, fract, cbox);
+		h = damage_hash(h, cbox, sizeof(cbox));
+		if (cur->parent->clip == ARCAN_CLIP_SHALLOW)
+			break;
+	}
+
+	return h;
+}
+
+static uint64_t rendertarget_signature(struct rendertarget* tgt)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	h = damage_hash(h, tgt->base, sizeof(float) * 16);
+	h = damage_hash(h, tgt->projection, sizeof(float) * 16);
+	h = damage_hash(h, &tgt->shid, sizeof(tgt->shid));
+	h = damage_hash(h, &tgt->force_shid, sizeof(tgt->force_shid));
+	h = damage_hash(h, &tgt->min_order, sizeof(tgt->min_order));
+	h = damage_hash(h, &tgt->max_order, sizeof(tgt->max_order));
+	return h;
+}
+
+/*
+ * Compare the pipeline of [tgt] against the records from the last draw and
+ * collect the damage into [box]. Returns false if the target needs a full
+ * redraw, either because the records can't be trusted or because something
+ * is drawn that can't be bounded (3d pipeline, meshes, linked pipelines).
+ */
+static bool damage_collect(struct rendertarget* tgt, float fract, float* box)
+{
+	bool full = tgt->damage.full || tgt->link ||
+		FL_TEST(tgt, TGTFL_NOCLEAR) || arcan_video_display.ignore_dirty > 0;
+
+	uint64_t sig = rendertarget_signature(tgt);
+	if (sig != tgt->damage.sig){
+		tgt->damage.sig = sig;
+		full = true;
+	}
+
+	memcpy(box, tgt->damage.box, sizeof(float) * 4);
+	memset(tgt->damage.box, '\0', sizeof(float) * 4);
+	tgt->damage.full = false;
+
+	agp_shader_id basic = agp_default_shader(BASIC_2D);
+	agp_shader_id color = agp_default_shader(COLOR_2D);
+
+	for (arcan_vobject_litem* cur = tgt->link ? NULL : tgt->first;
+		cur; cur = cur->next){
+		arcan_vobject* elem = cur->elem;
+		surface_properties dprops;
+
+		if (elem->order < 0){
+			full = true;
+			continue;
+		}
+
+/* same visibility rules as the draw loop and draw_vobj */
+		bool visible = elem != tgt->color &&
+			elem->order >= tgt->min_order && elem->order <= tgt->max_order &&
+			(elem->vstore->txmapped == TXSTATE_TEX2D ||
+			(elem->vstore->txmapped == TXSTATE_OFF && elem->program));
+
+		if (visible){
+			resolve_dprops(elem, fract, &dprops);
+			visible = dprops.opa > EPSILON;
+		}
+
+		if (!visible){
+			if (cur->damage.drawn){
+				if (cur->damage.art != tgt->art)
+					full = true;
+				damage_merge(box, cur->damage.box);
+			}
+			cur->damage.drawn = false;
+			continue;
+		}
+
+		float* txcos = elem->txcos;
+		if ( (elem->mask & MASK_MAPPING) > 0)
+			txcos = elem->parent != &current_context->world ?
+				elem->parent->txcos : elem->txcos;
+		if (!txcos)
+			txcos = arcan_video_display.default_txcos;
+
+		struct agp_vstore* store = elem->vstore;
+		bool multi = false;
+		if (elem->frameset){
+			if (elem->frameset->mode == ARCAN_FRAMESET_MULTITEXTURE)
+				multi = true;
+			else {
+				struct frameset_store* ds =
+					&elem->frameset->frames[elem->frameset->index];
+				txcos = ds->txcos;
+				store = ds->frame;
+			}
+		}
+
+		agp_shader_id shid = tgt->shid;
+		if (!tgt->force_shid && elem->program)
+			shid = elem->program;
+
+		float nbox[4];
+		damage_bounds(tgt, elem, dprops, NULL, NULL, nbox);
+		uint64_t vsig = damage_signature(
+			tgt, elem, &dprops, shid, txcos, store, fract, nbox);
+
+/* meshes aren't bound by the quad */
+		if (elem->shape)
+			full = true;
+
+		if (cur->damage.drawn && cur->damage.art != tgt->art)
+			full = true;
+
+/* custom shaders may animate on their own, so always redraw those, trusting
+ * that the vertex stage stays within the bounds */
+		if (!cur->damage.drawn || cur->damage.sig != vsig ||
+			memcmp(cur->damage.box, nbox, sizeof(nbox)) != 0 ||
+			(shid != basic && shid != color)){
+			if (cur->damage.drawn)
+				damage_merge(box, cur->damage.box);
+			damage_merge(box, nbox);
+		}
+
+/* contents changed, narrow to the updated region if it is the only update */
+		else if (store->damage.seq != cur->damage.seq){
+			float sbox[4];
+			if (!multi && store->damage.partial &&
+				store->damage.seq == cur->damage.seq + 1 && store->w && store->h){
+				float sub[4] = {
+					(float)(store->damage.x1 ? store->damage.x1 - 1 : 0) / store->w,
+					(float)(store->damage.y1 ? store->damage.y1 - 1 : 0) / store->h,
+					(float)(store->damage.x2 + 1) / store->w,
+					(float)(store->damage.y2 + 1) / store->h
+				};
+				damage_bounds(tgt, elem, dprops, txcos, sub, sbox);
+			}
+			else
+				memcpy(sbox, nbox, sizeof(nbox));
+			damage_merge(box, sbox);
+		}
+
+		cur->damage.drawn = true;
+		cur->damage.sig = vsig;
+		cur->damage.seq = store->damage.seq;
+		cur->damage.art = tgt->art;
+		memcpy(cur->damage.box, nbox, sizeof(nbox));
+	}
+
+	return !full;
+}
+
+/*
+ * Build the region to redraw into [box] for the buffer that will be drawn to.
+ * Returns false if a full redraw is needed.
+ */
+static bool damage_region(struct rendertarget* tgt, float fract, float* box)
+{
+	bool partial = damage_collect(tgt, fract, box);
+	size_t age = agp_rendertarget_age(tgt->art);
+
+	if (!partial || !age || age - 1 > tgt->damage.history_valid){
+		box[0] = box[1] = -1.0;
+		box[2] = box[3] = 1.0;
+		partial = false;
+	}
+
+	float cur[4];
+	memcpy(cur, box, sizeof(cur));
+
+	for (size_t i = 1; i < age && partial; i++){
+		size_t ind = (tgt->damage.history_ind + DAMAGE_HISTORY - i) % DAMAGE_HISTORY;
+		damage_merge(box, tgt->damage.history[ind]);
+	}
+
+/* nothing changed and the buffer already has the latest contents, the history
+ * only tracks frames that are drawn */
+	if (partial && damage_empty(box))
+		return true;
+
+	memcpy(tgt->damage.history[tgt->damage.history_ind], cur, sizeof(cur));
+	tgt->damage.history_ind = (tgt->damage.history_ind + 1) % DAMAGE_HISTORY;
+	if (tgt->damage.history_valid < DAMAGE_HISTORY)
+		tgt->damage.history_valid++;
+
+/* when most of the target is covered, the scissor and culling isn't worth it */
+	float w = fminf(box[2], 1.0) - fmaxf(box[0], -1.0);
+	float h = fminf(box[3], 1.0) - fmaxf(box[1], -1.0);
+	return partial && w * h < 3.0;
+}
+
+static inline bool damage_overlap(const float* a, const float* b)
+{
+	return a[0] < b[2] && a[2] > b[0] && a[1] < b[3] && a[3] > b[1];
+}
+
+/*
+ * Culling pass over the 2D part of a rendertarget, run before the draw loop.
+ * Objects drawn with the default shaders and without a mesh are bounded by
+ * their quad, and those outside of the viewport are marked as hidden. With
+ * occlusion, the same objects are walked front to back and those that are
+ * entirely inside the box of a later opaque, non-rotated and unclipped object
+ * are hidden as well. Only single occluders are tested, not their union, and
+ * a limited number of the largest ones are kept.
+ */
+#define CULL_OCCLUDER_LIMIT 16
+
+static inline bool cull_contains(const float* a, const float* b)
+{
+	return a[0] <= b[0] && a[1] <= b[1] && a[2] >= b[2] && a[3] >= b[3];
+}
+
+static inline float cull_area(const float* a)
+{
+	return (a[2] - a[0]) * (a[3] - a[1]);
+}
+
+/* a rotated or skewed target would turn the occluder quads into something
+ * that doesn't fill their bounding box */
+static bool cull_axis_aligned(struct rendertarget* tgt)
+{
+	return
+		fabsf(tgt->base[1]) < EPSILON && fabsf(tgt->base[4]) < EPSILON &&
+		fabsf(tgt->projection[1]) < EPSILON && fabsf(tgt->projection[4]) < EPSILON;
+}
+
+static void cull_rendertarget(
+	struct rendertarget* tgt, arcan_vobject_litem* first, float fract)
+{
+	agp_shader_id basic = agp_default_shader(BASIC_2D);
+	agp_shader_id color = agp_default_shader(COLOR_2D);
+	arcan_vobject_litem* last = NULL;
+
+/* damage_collect has already bounded the drawn objects for this frame */
+	bool reuse = arcan_video_display.damage && !tgt->link;
+
+	for (arcan_vobject_litem* cur = first;
+		cur && cur->elem->order >= 0; cur = cur->next){
+		arcan_vobject* elem = cur->elem;
+		cur->cull.hidden = cur->cull.bounded = cur->cull.occluder = false;
+
+		if (elem->order < tgt->min_order)
+			continue;
+
+		if (elem->order > tgt->max_order)
+			break;
+
+		last = cur;
+		if (elem == tgt->color || elem->shape)
+			continue;
+
+		agp_shader_id shid = tgt->shid;
+		if (!tgt->force_shid && elem->program)
+			shid = elem->program;
+
+/* custom shaders may move the vertices anywhere */
+		if (shid != basic && shid != color)
+			continue;
+
+		surface_properties dprops;
+		resolve_dprops(elem, fract, &dprops);
+		if (dprops.opa <= EPSILON)
+			continue;
+
+		if (reuse && cur->damage.drawn)
+			memcpy(cur->cull.box, cur->damage.box, sizeof(float) * 4);
+		else
+			damage_bounds(tgt, elem, dprops, NULL, NULL, cur->cull.box);
+		cur->cull.bounded = true;
+
+		if (cur->cull.box[2] <= -1.0 || cur->cull.box[0] >= 1.0 ||
+			cur->cull.box[3] <= -1.0 || cur->cull.box[1] >= 1.0){
+			cur->cull.hidden = true;
+			arcan_video_display.culled++;
+			continue;
+		}
+
+		struct agp_vstore* vstore = elem->vstore;
+		cur->cull.occluder = draw_blend(elem, &dprops) == BLEND_NONE &&
+			(elem->clip == ARCAN_CLIP_OFF || !get_clip_source(elem)) &&
+			fabsf(dprops.rotation.roll) <= EPSILON &&
+			fabsf(dprops.rotation.pitch) <= EPSILON &&
+			fabsf(dprops.rotation.yaw) <= EPSILON &&
+			(vstore->txmapped == TXSTATE_TEX2D ||
+			(vstore->txmapped == TXSTATE_OFF && elem->program));
+	}
+
+	if (!arcan_video_display.occlusion || !last || !cull_axis_aligned(tgt))
+		return;
+
+	float occl[CULL_OCCLUDER_LIMIT][4];
+	size_t n_occl = 0;
+
+	for (arcan_vobject_litem* cur = last; cur;
+		cur = cur == first ? NULL : cur->previous){
+		if (!cur->cull.bounded || cur->cull.hidden)
+			continue;
+
+		for (size_t i = 0; i < n_occl; i++)
+			if (cull_contains(occl[i], cur->cull.box)){
+				cur->cull.hidden = true;
+				arcan_video_display.occluded++;
+				break;
+			}
+
+		if (cur->cull.hidden || !cur->cull.occluder)
+			continue;
+
+		if (n_occl < CULL_OCCLUDER_LIMIT){
+			memcpy(occl[n_occl++], cur->cull.box, sizeof(float) * 4);
+			continue;
+		}
+
+/* full, replace the smallest if this one is larger */
+		size_t ind = 0;
+		for (size_t i = 1; i < n_occl; i++)
+			if (cull_area(occl[i]) < cull_area(occl[ind]))
+				ind = i;
+
+		if (cull_area(occl[ind]) < cull_area(cur->cull.box))
+			memcpy(occl[ind], cur->cull.box, sizeof(float) * 4);
+	}
+}
+
 static size_t process_rendertarget(struct rendertarget* tgt, float fract)
 {
 	arcan_vobject_litem* current;
@@ -5191,6 +6126,23 @@ static size_t process_rendertarget(struct rendertarget* tgt, float fract)
 
 	current_rendertarget = tgt;
 	agp_activate_rendertarget(tgt->art);
+
+/* with damage tracking, limit the clear and the draws to what has changed,
+ * this is resolved after activation as that determines the buffer age */
+	float damage[4];
+	bool partial = false;
+	if (arcan_video_display.damage){
+		partial = damage_region(tgt, fract, damage);
+		if (partial && damage_empty(damage))
+			return 0;
+		if (partial)
+			agp_rendertarget_scissor(tgt->art, damage);
+	}
+	else {
+		tgt->damage.history_valid = 0;
+		memset(tgt->damage.box, '\0', sizeof(float) * 4);
+	}
+
 	agp_shader_envv(RTGT_ID, &tgt->id, sizeof(int));
 	agp_shader_envv(OBJ_OPACITY, &(float){1.0}, sizeof(float));
 
@@ -5218,6 +6170,10 @@ static size_t process_rendertarget(struct rendertarget* tgt, float fract)
 	agp_shader_activate(agp_default_shader(BASIC_2D));
 	agp_shader_envv(PROJECTION_MATR, tgt->projection, sizeof(float)*16);
 
+	bool cull = arcan_video_display.cull;
+	if (cull)
+		cull_rendertarget(tgt, current, fract);
+
 	while (current && current->elem->order >= 0){
 		arcan_vobject* elem = current->elem;
 
@@ -5229,9 +6185,23 @@ static size_t process_rendertarget(struct rendertarget* tgt, float fract)
 		if (current->elem->order > tgt->max_order)
 			break;
 
-/* calculate coordinate system translations, world cannot be masked */
-		surface_properties dprops = empty_surface();
-		arcan_resolve_vidprop(elem, fract, &dprops);
+/* outside of the damaged region, the buffer already has it */
+		if (partial &&
+			(!current->damage.drawn || !damage_overlap(current->damage.box, damage))){
+			current = current->next;
+			continue;
+		}
+
+/* outside of the target or behind something opaque */
+		if (cull && current->cull.hidden){
+			current = current->next;
+			continue;
+		}
+
+/* calculate coordinate system translations, world cannot be masked,
+ * unless this has already been done ahead of time */
+		surface_properties dprops;
+		resolve_dprops(elem, fract, &dprops);
 
 /* don't waste time on objects that aren't supposed to be visible */
 		if ( dprops.opa <= EPSILON || elem == tgt->color){
@@ -5265,6 +6235,13 @@ static size_t process_rendertarget(struct rendertarget* tgt, float fract)
 		agp_shader_id shid = tgt->shid;
 		if (!tgt->force_shid && elem->program)
 			shid = elem->program;
+
+		if (batch_vobj(tgt, elem, shid, &dprops, txcos)){
+			current = current->next;
+			pc++;
+			continue;
+		}
+
 		agp_shader_activate(shid);
 
 		if (elem->frameset){
@@ -5310,6 +6287,10 @@ static size_t process_rendertarget(struct rendertarget* tgt, float fract)
 
 /* reset and try the 3d part again if requested */
 end3d:
+	batch_flush();
+	if (partial)
+		agp_rendertarget_scissor(tgt->art, NULL);
+
 	current = tgt->first;
 	if (current && current->elem->order < 0 && tgt->order3d == ORDER3D_LAST){
 		agp_shader_activate(agp_default_shader(BASIC_2D));
@@ -5320,6 +6301,12 @@ end3d:
 
 	if (pc){
 		tgt->frame_cookie = arcan_video_display.cookie;
+
+/* anything that samples the output sees new contents */
+		if (tgt->color)
+			tgt->color->vstore->damage.seq++;
+		else if (tgt == &current_context->stdoutp && current_context->world.vstore)
+			current_context->world.vstore->damage.seq++;
 	}
 	return pc;
 }
@@ -5336,11 +6323,12 @@ arcan_errc arcan_video_forceread(
  */
 
 	arcan_vobject* vobj = arcan_video_getobject(sid);
-	struct agp_vstore* dstore = vobj->vstore;
-
-	if (!vobj || !dstore)
+	if (!vobj || !vobj->vstore)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
+	arcan_vint_atlas_detach(vobj);
+	struct agp_vstore* dstore = vobj->vstore;
+
 	if (dstore->txmapped != TXSTATE_TEX2D)
 		return ARCAN_ERRC_UNACCEPTED_STATE;
 
@@ -5479,6 +6467,160 @@ void arcan_vint_pollreadback(struct rendertarget* tgt)
 	FL_CLEAR(tgt, TGTFL_READING);
 }
 
+/*
+ * A rendertarget can be recorded in parallel with others if resolving its
+ * objects only touches objects it owns, i.e. no shared attachments or parents
+ * in other rendertargets as the resolve updates the transform cache, and if
+ * it doesn't sample the output of another rendertarget. The latter doesn't
+ * matter for the resolve itself, but is the dependency edge for drawing and
+ * such targets are left on the sequential path.
+ *
+ * The walk is about as expensive as the resolve it hands off, so the outcome
+ * is cached per rendertarget until something structural calls FLAG_RTDEP.
+ */
+static bool rendertarget_independent(struct rendertarget* tgt)
+{
+	if (tgt->link || !tgt->first || tgt->refresh >= 0)
+		return false;
+
+	if (tgt->indep_gen == arcan_video_display.rtdep_gen)
+		return tgt->indep;
+
+	tgt->indep_gen = arcan_video_display.rtdep_gen;
+	tgt->indep = false;
+
+	for (arcan_vobject_litem* cur = tgt->first; cur; cur = cur->next){
+		arcan_vobject* elem = cur->elem;
+		if (elem->order < 0 || elem == tgt->color)
+			continue;
+
+		for (arcan_vobject* p = elem; p && p != &current_context->world; p = p->parent)
+			if (p->owner != tgt)
+				return false;
+
+		struct rendertarget* src;
+		if (elem->vstore && elem->vstore->refcount > 1 &&
+			(src = arcan_vint_findrt_vstore(elem->vstore)) && src != tgt)
+			return false;
+
+		if (elem->frameset){
+			for (size_t i = 0; i < elem->frameset->n_frames; i++)
+				if (arcan_vint_findrt_vstore(elem->frameset->frames[i].frame))
+					return false;
+		}
+	}
+
+	tgt->indep = true;
+	return true;
+}
+
+static void record_job(void* tag, size_t ind)
+{
+	struct rendertarget* tgt = ((struct rendertarget**) tag)[ind];
+	float fract = arcan_video_display.c_lerp;
+
+	for (arcan_vobject_litem* cur = tgt->first; cur; cur = cur->next){
+		arcan_vobject* elem = cur->elem;
+		if (elem->order < 0 || elem->order < tgt->min_order || elem == tgt->color)
+			continue;
+
+		if (elem->order > tgt->max_order)
+			break;
+
+		elem->record.props = empty_surface();
+		arcan_resolve_vidprop(elem, fract, &elem->record.props);
+		elem->record.cookie = arcan_video_display.record_cookie;
+	}
+}
+
+static void record_rendertargets()
+{
+	struct rendertarget* set[RENDERTARGET_LIMIT];
+	size_t count = 0;
+
+	for (size_t ind = 0; ind < current_context->n_rtargets; ind++){
+		struct rendertarget* tgt = &current_context->rtargets[ind];
+		if (!arcan_video_display.ignore_dirty &&
+			!(tgt->dirtyc + arcan_video_display.dirty) && !tgt->transfc)
+			continue;
+
+		if (rendertarget_independent(tgt))
+			set[count++] = tgt;
+	}
+
+	if (count < 2)
+		return;
+
+	arcan_video_display.record_cookie++;
+	TRACE_MARK_ENTER("video", "record-rendertargets",
+		TRACE_SYS_DEFAULT, arcan_conductor_workers(), count, "");
+		arcan_conductor_parallel(record_job, set, count);
+	TRACE_MARK_EXIT("video", "record-rendertargets",
+		TRACE_SYS_DEFAULT, arcan_conductor_workers(), count, "");
+	arcan_video_display.recorded = true;
+}
+
+void arcan_video_parallel_rendertargets(bool enable)
+{
+	arcan_video_display.parallel_rt = enable;
+}
+
+void arcan_video_batch_draws(bool enable)
+{
+	arcan_video_display.batch_2d = enable;
+}
+
+void arcan_video_atlas(bool enable)
+{
+	arcan_video_display.atlas = enable;
+}
+
+void arcan_video_damage(bool enable)
+{
+	arcan_video_display.damage = enable;
+}
+
+void arcan_video_frame_cache(bool enable)
+{
+	arcan_video_display.frame_cache = enable;
+}
+
+void arcan_video_active_set(bool enable)
+{
+	arcan_video_display.active_set = enable;
+}
+
+void arcan_video_decode_cache(size_t limit)
+{
+	arcan_vint_decode_cache(limit);
+}
+
+void arcan_video_compress(bool enable, bool force)
+{
+	arcan_video_display.compress = enable;
+	arcan_video_display.compress_force = force;
+}
+
+void arcan_video_shader_cache(bool enable)
+{
+	arcan_video_display.shader_cache = enable;
+}
+
+void arcan_video_culling(bool cull, bool occlusion)
+{
+	arcan_video_display.cull = cull;
+	arcan_video_display.occlusion = occlusion;
+}
+
+void arcan_video_batch_transforms(bool enable)
+{
+	arcan_video_display.batch_transform = enable;
+	if (!enable){
+		flush_transforms();
+		drop_transform_batch();
+	}
+}
+
 static size_t steptgt(float fract, struct rendertarget* tgt)
 {
 /* A special case here are rendertargets where the color output store
@@ -5518,6 +6660,8 @@ unsigned arcan_vint_refresh(float fract, size_t* ndirty)
 
 /* we track last interp. state in order to handle forcerefresh */
 	arcan_video_display.c_lerp = fract;
+	arcan_video_display.drawcalls = 0;
+	arcan_video_display.culled = arcan_video_display.occluded = 0;
 	arcan_random((void*)&arcan_video_display.cookie, 8);
 
 /* active shaders with counter counts towards dirty */
@@ -5529,6 +6673,16 @@ unsigned arcan_vint_refresh(float fract, size_t* ndirty)
 	if (arcan_video_display.ignore_dirty > 0)
 		arcan_video_display.ignore_dirty--;
 
+/* resolve what can be resolved ahead of time on the worker pool */
+	if (arcan_video_display.parallel_rt && arcan_conductor_workers())
+		record_rendertargets();
+
+/* from here on until all rendertargets are processed, the object properties
+ * are stable and resolved results can be shared within the frame */
+	static uint64_t resolve_seq;
+	if (arcan_video_display.frame_cache)
+		arcan_video_display.resolve_cookie = ++resolve_seq;
+
 /* right now there is an explicit 'first come first update' kind of
  * order except for worldid as everything else might be composed there. */
 	size_t tgt_dirty = 0;
@@ -5550,12 +6704,14 @@ unsigned arcan_vint_refresh(float fract, size_t* ndirty)
  * state if world isn't dirty or with pending transfers */
 	current_rendertarget = NULL;
 	agp_activate_rendertarget(NULL);
+	arcan_video_display.recorded = false;
 
 	TRACE_MARK_ENTER("video", "process-world-rendertarget", TRACE_SYS_DEFAULT, 0, 0, "world");
 		current_context->stdoutp.dirtyc += arcan_video_display.dirty;
 		tgt_dirty = steptgt(fract, &current_context->stdoutp);
 		transfc += tgt_dirty;
 	TRACE_MARK_EXIT("video", "process-world-rendertarget", TRACE_SYS_DEFAULT, 0, tgt_dirty, "world");
+	arcan_video_display.resolve_cookie = 0;
 	*ndirty = arcan_video_display.dirty;
 
 /* transfc will give us the number of dirty transformations and possibly
@@ -5569,8 +6725,18 @@ unsigned arcan_vint_refresh(float fract, size_t* ndirty)
 		arcan_video_display.ignore_dirty = platform_video_decay();
 	}
 
+	arcan_bench_register_draws(arcan_video_display.drawcalls);
+	arcan_bench_register_cull(
+		arcan_video_display.culled, arcan_video_display.occluded);
+
+	struct agp_state_stats stats;
+	agp_state_stats(&stats);
+	arcan_bench_register_state(
+		stats.programs, stats.textures, stats.uniforms, stats.skipped);
+
 	long long int post = arcan_timemillis();
-	TRACE_MARK_EXIT("video", "refresh", TRACE_SYS_DEFAULT, 0, 0, "");
+	TRACE_MARK_EXIT("video", "refresh",
+		TRACE_SYS_DEFAULT, 0, arcan_video_display.drawcalls, "");
 	return post - pre;
 }
 
@@ -5698,6 +6864,7 @@ arcan_errc arcan_video_sliceobject(arcan_vobj_id sid,
 	if (!src)
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
+	arcan_vint_atlas_detach(src);
 	return (agp_slice_vstore(src->vstore, n_slices, base,
 		type == ARCAN_CUBEMAP ? TXSTATE_CUBE : TXSTATE_TEX3D))
 		? ARCAN_OK : ARCAN_ERRC_UNACCEPTED_STATE;
@@ -5717,6 +6884,7 @@ arcan_errc arcan_video_updateslices(
 			vstores[i] = NULL;
 			continue;
 		}
+		arcan_vint_atlas_detach(slot);
 		vstores[i] = slot->vstore;
 	}
 
@@ -5736,6 +6904,316 @@ static inline bool obj_visible(arcan_vobject* vobj)
 	return visible;
 }
 
+/*
+ * Pick index
+ *
+ * A uniform grid over the rendertarget, each cell lists the objects whose
+ * screen-space bounding box overlaps it in the same order as the rendertarget
+ * list. Objects with an ongoing transformation somewhere in their parent
+ * chain (the results depend on the interpolation), 3D objects and objects
+ * covering too many cells are instead kept in a list that is always tested.
+ * The exact test is still performed on each candidate, the index only serves
+ * to skip the objects that can't possibly be hit. The index is rebuilt on
+ * the next pick after its rendertarget has been flagged (FLAG_PICK_RT, or
+ * FLAG_PICK_OBJ on one of its objects) or after a global FLAG_PICK, and the
+ * few most recently picked rendertargets keep their index.
+ */
+#ifndef PICK_INDEX_SLOTS
+#define PICK_INDEX_SLOTS 4
+#endif
+
+#ifndef PICK_GRID_DIM
+#define PICK_GRID_DIM 64
+#endif
+
+/* objects that cover more cells than this go into the always-tested set */
+#ifndef PICK_CELL_LIMIT
+#define PICK_CELL_LIMIT 64
+#endif
+
+struct pick_index {
+	struct rendertarget* tgt;
+	unsigned ctx;
+	uint64_t gen, rt_gen;
+	uint64_t used;
+
+	float cell;
+	size_t cols, rows;
+
+/* objects in rendertarget order */
+	arcan_vobject** objs;
+	size_t n_objs, objs_lim;
+
+/* cell ranges (cells[i] to cells[i+1]) of indices into objs */
+	size_t* cells;
+	size_t cells_lim;
+	uint32_t* refs;
+	size_t n_refs, refs_lim;
+
+/* per object cell range (during build) or always-tested indices */
+	uint16_t (*range)[4];
+	size_t range_lim;
+	uint32_t* always;
+	size_t n_always, always_lim;
+};
+
+static struct pick_index pick_indices[PICK_INDEX_SLOTS];
+static uint64_t pick_use;
+
+static bool pick_grow(void** buf, size_t* lim, size_t need, size_t elem)
+{
+	if (need <= *lim)
+		return true;
+
+	size_t nlim = *lim ? *lim : 256;
+	while (nlim < need)
+		nlim *= 2;
+
+	void* nbuf = arcan_alloc_mem(nlim * elem,
+		ARCAN_MEM_VSTRUCT, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+	if (!nbuf)
+		return false;
+
+	arcan_mem_free(*buf);
+	*buf = nbuf;
+	*lim = nlim;
+	return true;
+}
+
+static void drop_pick_indices()
+{
+	for (size_t i = 0; i < PICK_INDEX_SLOTS; i++){
+		struct pick_index* ind = &pick_indices[i];
+		arcan_mem_free(ind->objs);
+		arcan_mem_free(ind->range);
+		arcan_mem_free(ind->always);
+		arcan_mem_free(ind->cells);
+		arcan_mem_free(ind->refs);
+		*ind = (struct pick_index){};
+	}
+}
+
+void arcan_vint_flagpick(arcan_vobject* vobj)
+{
+/* unpickable leaves (e.g. cursors) can move without costing a rebuild, the
+ * children of anything else are reached through invalidate_cache */
+	if (!vobj || ((vobj->mask & MASK_UNPICKABLE) && !vobj->extrefc.links))
+		return;
+
+/* the owner is the primary attachment, with more than one we'd need to sweep
+ * the rendertargets to find the others so just invalidate everything */
+	if (vobj->owner && vobj->extrefc.attachments <= 1)
+		FLAG_PICK_RT(vobj->owner);
+	else if (vobj->extrefc.attachments)
+		FLAG_PICK();
+}
+
+static bool pick_dynamic(arcan_vobject* vobj)
+{
+	if (vobj->feed.state.tag == ARCAN_TAG_3DOBJ)
+		return true;
+
+	for (; vobj; vobj = vobj->parent)
+		if (vobj->transform)
+			return true;
+
+	return false;
+}
+
+static bool build_pick_index(struct pick_index* ind, struct rendertarget* tgt)
+{
+	struct agp_vstore* vs = tgt->color ? tgt->color->vstore : NULL;
+	if (!vs || !vs->w || !vs->h)
+		return false;
+
+	size_t dim = vs->w > vs->h ? vs->w : vs->h;
+	ind->cell = (dim + PICK_GRID_DIM - 1) / PICK_GRID_DIM;
+	if (ind->cell < 32)
+		ind->cell = 32;
+	ind->cols = ceilf((float)vs->w / ind->cell);
+	ind->rows = ceilf((float)vs->h / ind->cell);
+
+	size_t n = 0;
+	for (arcan_vobject_litem* cur = tgt->first; cur; cur = cur->next)
+		n++;
+
+	size_t n_cells = ind->cols * ind->rows;
+	if (!pick_grow((void**) &ind->objs, &ind->objs_lim, n, sizeof(void*)) ||
+		!pick_grow((void**) &ind->range, &ind->range_lim, n, sizeof(uint16_t[4])) ||
+		!pick_grow((void**) &ind->always, &ind->always_lim, n, sizeof(uint32_t)) ||
+		!pick_grow((void**) &ind->cells,
+			&ind->cells_lim, n_cells + 1, sizeof(size_t)))
+		return false;
+
+	memset(ind->cells, '\0', sizeof(size_t) * (n_cells + 1));
+	ind->n_objs = ind->n_always = ind->n_refs = 0;
+
+/* first pass, bounding boxes and cell counts */
+	for (arcan_vobject_litem* cur = tgt->first; cur; cur = cur->next){
+		size_t i = ind->n_objs++;
+		arcan_vobject* vobj = cur->elem;
+		vector projv[4];
+		ind->objs[i] = vobj;
+		ind->range[i][0] = 1;
+		ind->range[i][2] = 0;
+
+		if (pick_dynamic(vobj) ||
+			ARCAN_OK != arcan_video_screencoords(vobj->cellid, projv)){
+			ind->always[ind->n_always++] = i;
+			continue;
+		}
+
+/* pad with a pixel to cover the integer truncation in hittest */
+		float x1 = projv[0].x, y1 = projv[0].y, x2 = x1, y2 = y1;
+		for (size_t j = 1; j < 4; j++){
+			x1 = projv[j].x < x1 ? projv[j].x : x1;
+			y1 = projv[j].y < y1 ? projv[j].y : y1;
+			x2 = projv[j].x > x2 ? projv[j].x : x2;
+			y2 = projv[j].y > y2 ? projv[j].y : y2;
+		}
+
+		float c1 = floorf((x1 - 1.0f) / ind->cell);
+		float r1 = floorf((y1 - 1.0f) / ind->cell);
+		float c2 = floorf((x2 + 1.0f) / ind->cell);
+		float r2 = floorf((y2 + 1.0f) / ind->cell);
+
+/* outside the grid, only reachable through the fallback */
+		if (c2 < 0 || r2 < 0 || c1 >= ind->cols || r1 >= ind->rows)
+			continue;
+
+		c1 = c1 < 0 ? 0 : c1;
+		r1 = r1 < 0 ? 0 : r1;
+		c2 = c2 >= ind->cols ? ind->cols - 1 : c2;
+		r2 = r2 >= ind->rows ? ind->rows - 1 : r2;
+
+		if ((c2 - c1 + 1) * (r2 - r1 + 1) > PICK_CELL_LIMIT){
+			ind->always[ind->n_always++] = i;
+			continue;
+		}
+
+		ind->range[i][0] = c1;
+		ind->range[i][1] = r1;
+		ind->range[i][2] = c2;
+		ind->range[i][3] = r2;
+
+		for (size_t r = r1; r <= r2; r++)
+			for (size_t c = c1; c <= c2; c++)
+				ind->cells[r * ind->cols + c + 1]++;
+	}
+
+/* prefix sum into offsets, then fill in rendertarget order */
+	for (size_t i = 0; i < n_cells; i++)
+		ind->cells[i+1] += ind->cells[i];
+
+	ind->n_refs = ind->cells[n_cells];
+	if (!pick_grow((void**) &ind->refs,
+		&ind->refs_lim, ind->n_refs, sizeof(uint32_t)))
+		return false;
+
+	size_t fill[n_cells];
+	memcpy(fill, ind->cells, sizeof(size_t) * n_cells);
+
+	for (size_t i = 0; i < ind->n_objs; i++){
+		if (ind->range[i][0] > ind->range[i][2])
+			continue;
+
+		for (size_t r = ind->range[i][1]; r <= ind->range[i][3]; r++)
+			for (size_t c = ind->range[i][0]; c <= ind->range[i][2]; c++)
+				ind->refs[fill[r * ind->cols + c]++] = i;
+	}
+
+	return true;
+}
+
+static struct pick_index* pick_index(struct rendertarget* tgt)
+{
+	if (!arcan_video_display.pick_index)
+		return NULL;
+
+	struct pick_index* lru = &pick_indices[0];
+	struct pick_index* ind = NULL;
+
+	for (size_t i = 0; i < PICK_INDEX_SLOTS; i++){
+		struct pick_index* cur = &pick_indices[i];
+		if (cur->tgt == tgt && cur->ctx == vcontext_ind){
+			ind = cur;
+			break;
+		}
+		if (cur->used < lru->used)
+			lru = cur;
+	}
+
+	if (!ind){
+		ind = lru;
+		ind->tgt = NULL;
+	}
+
+	ind->used = ++pick_use;
+	if (ind->tgt == tgt &&
+		ind->gen == arcan_video_display.pick_gen && ind->rt_gen == tgt->pick_gen)
+		return ind;
+
+	ind->tgt = NULL;
+	if (!build_pick_index(ind, tgt))
+		return NULL;
+
+	ind->tgt = tgt;
+	ind->ctx = vcontext_ind;
+	ind->gen = arcan_video_display.pick_gen;
+	ind->rt_gen = tgt->pick_gen;
+	return ind;
+}
+
+static inline bool pick_test(arcan_vobject* vobj, int x, int y, bool reverse)
+{
+	if (!reverse && !vobj->cellid)
+		return false;
+
+	return (vobj->mask & MASK_UNPICKABLE) == 0 && obj_visible(vobj) &&
+		arcan_video_hittest(vobj->cellid, x, y);
+}
+
+/* walk the cell candidates and the always-tested set in rendertarget order
+ * (or reverse), returns false if the point is outside of the grid */
+static bool pick_indexed(struct pick_index* ind,
+	arcan_vobj_id* dst, size_t lim, size_t* count, int x, int y, bool reverse)
+{
+	if (x < 0 || y < 0)
+		return false;
+
+	size_t col = x / ind->cell;
+	size_t row = y / ind->cell;
+	if (col >= ind->cols || row >= ind->rows)
+		return false;
+
+	size_t cell = row * ind->cols + col;
+	uint32_t* cset = &ind->refs[ind->cells[cell]];
+	size_t nc = ind->cells[cell + 1] - ind->cells[cell];
+	uint32_t* aset = ind->always;
+	size_t na = ind->n_always;
+	size_t ci = 0, ai = 0;
+
+	while ((ci < nc || ai < na) && *count < lim){
+		uint32_t next;
+
+		if (reverse){
+			bool use_c = ci < nc &&
+				(ai == na || cset[nc - ci - 1] > aset[na - ai - 1]);
+			next = use_c ? cset[nc - ++ci] : aset[na - ++ai];
+		}
+		else {
+			bool use_c = ci < nc && (ai == na || cset[ci] < aset[ai]);
+			next = use_c ? cset[ci++] : aset[ai++];
+		}
+
+		arcan_vobject* vobj = ind->objs[next];
+		if (pick_test(vobj, x, y, reverse))
+			dst[(*count)++] = vobj->cellid;
+	}
+
+	return true;
+}
+
 size_t arcan_video_rpick(arcan_vobj_id rt,
 	arcan_vobj_id* dst, size_t lim, int x, int y)
 {
@@ -5746,6 +7224,10 @@ size_t arcan_video_rpick(arcan_vobj_id rt,
 	if (lim == 0 || !tgt || !tgt->first)
 		return count;
 
+	struct pick_index* ind = pick_index(tgt);
+	if (ind && pick_indexed(ind, dst, lim, &count, x, y, true))
+		return count;
+
 	arcan_vobject_litem* current = tgt->first;
 
 /* skip to last, then start stepping backwards */
@@ -5755,8 +7237,7 @@ size_t arcan_video_rpick(arcan_vobj_id rt,
 	while (current && count < lim){
 		arcan_vobject* vobj = current->elem;
 
-		if ((vobj->mask & MASK_UNPICKABLE) == 0 && obj_visible(vobj) &&
-			arcan_video_hittest(vobj->cellid, x, y))
+		if (pick_test(vobj, x, y, true))
 				dst[count++] = vobj->cellid;
 
 		current = current->previous;
@@ -5774,13 +7255,16 @@ size_t arcan_video_pick(arcan_vobj_id rt,
 	if (lim == 0 || !tgt || !tgt->first)
 		return count;
 
+	struct pick_index* ind = pick_index(tgt);
+	if (ind && pick_indexed(ind, dst, lim, &count, x, y, false))
+		return count;
+
 	arcan_vobject_litem* current = tgt->first;
 
 	while (current && count < lim){
 		arcan_vobject* vobj = current->elem;
 
-		if (vobj->cellid && !(vobj->mask & MASK_UNPICKABLE) &&
-			obj_visible(vobj) && arcan_video_hittest(vobj->cellid, x, y))
+		if (pick_test(vobj, x, y, false))
 				dst[count++] = vobj->cellid;
 
 		current = current->next;
@@ -5789,6 +7273,13 @@ size_t arcan_video_pick(arcan_vobj_id rt,
 	return count;
 }
 
+void arcan_video_pick_index(bool enable)
+{
+	arcan_video_display.pick_index = enable;
+	if (!enable)
+		drop_pick_indices();
+}
+
 img_cons arcan_video_storage_properties(arcan_vobj_id id)
 {
 	img_cons res = {.w = 0, .h = 0, .bpp = 0};
@@ -6119,7 +7610,10 @@ void arcan_video_shutdown(bool release_fsrv)
 	}
 
 	agp_shader_flush();
+	drop_transform_batch();
+	drop_pick_indices();
 	deallocate_gl_context(current_context, true, NULL);
+	arcan_vint_decode_shutdown();
 	arcan_video_reset_fontcache();
 	agp_rendertarget_clear();
 	TTF_Quit();
@@ -6231,6 +7725,7 @@ lineheights, &w, &h, &dsz, &maxw, &maxh, false
 		if (vobj->feed.state.tag != ARCAN_TAG_TEXT)
 			FAIL(ARCAN_ERRC_UNACCEPTED_STATE);
 
+		arcan_vint_atlas_detach(vobj);
 		ds = vobj->vstore;
 
 		if (data.multiple)
@@ -6244,6 +7739,7 @@ lineheights, &w, &h, &dsz, &maxw, &maxh, false
 
 	vobj->origw = maxw;
 	vobj->origh = maxh;
+	FLAG_PICK_OBJ(vobj);
 
 	update_sourcedescr(ds, &data);
 
@@ -203,6 +203,10 @@ typedef vector (*arcan_interp_3d_function)(
 typedef quat (*arcan_interp_4d_function)(
 	quat begin, quat end, float fract);
 
+typedef void (*arcan_interp_batch_function)(float* restrict dst,
+	const float* restrict sv, const float* restrict ev,
+	const float* restrict fract, size_t n);
+
 /*
  * When loading an image, a transformation can be applied
  * before the image is added to
@@ -293,6 +297,85 @@ void arcan_video_default_texfilter(enum arcan_vfilter_mode);
 void arcan_video_default_imageprocmode(enum arcan_imageproc_mode);
 void arcan_video_default_blendmode(enum arcan_blendfunc);
 
+/*
+ * Allow rendertargets that are independent of each other (only contain
+ * objects they own and don't sample the output of other rendertargets) to
+ * have their transforms resolved on the conductor worker pool before the
+ * rendertargets are drawn in order. Without workers this has no effect.
+ */
+void arcan_video_parallel_rendertargets(bool);
+
+/*
+ * Merge consecutive objects that use the default shader, the same store and
+ * the same blend state and opacity into one draw call.
+ */
+void arcan_video_batch_draws(bool);
+
+/*
+ * Sub-allocate small static images from shared atlas pages so that they can
+ * be drawn without switching stores. Objects are moved back to a private
+ * store when an operation needs to modify the store or its mapping.
+ */
+void arcan_video_atlas(bool);
+
+/*
+ * Track which parts of each rendertarget that have changed since it was last
+ * drawn (moved, changed or removed objects and store updates with a known
+ * dirty region) and limit the redraw to those parts.
+ */
+void arcan_video_damage(bool);
+
+/*
+ * Share resolved object properties within the same refresh so that objects
+ * with a common parent chain only resolve it once per frame (default: on).
+ */
+void arcan_video_frame_cache(bool);
+
+/*
+ * Only visit objects that have ongoing transformations, feeds, frame cycling,
+ * a limited lifetime or a pending asynchronous load when ticking, rather than
+ * every object in every rendertarget (default: on).
+ */
+void arcan_video_active_set(bool);
+
+/*
+ * Set the size limit (bytes) for the cache of decoded images that image
+ * loading goes through, keyed on the resource, its modification time and the
+ * load constraints. 0 disables the cache.
+ */
+void arcan_video_decode_cache(size_t limit);
+
+/*
+ * Store static images block compressed (BC1, or BC3 for images with alpha)
+ * to cut their memory and upload cost by 1/8 (1/4). This is lossy, and only
+ * applies to images that have dimensions divisible by 4, are not mipmapped
+ * and when the backend can sample from the formats, unless [force] is set in
+ * which case the blocks are decoded on the CPU before upload instead.
+ * Accessing the pixels of such an image reverts it to uncompressed storage.
+ */
+void arcan_video_compress(bool enable, bool force);
+
+/*
+ * Store linked shader programs as driver binaries in the appl state namespace
+ * and reuse them on the next build of the same sources with the same driver,
+ * rather than compiling again (default: on, if the backend supports it).
+ */
+void arcan_video_shader_cache(bool);
+
+/*
+ * Skip drawing 2D objects that are entirely outside of their rendertarget
+ * [cull] (default: on) and, with [occlusion], objects that are entirely
+ * covered by a later opaque, non-rotated and unclipped object.
+ */
+void arcan_video_culling(bool cull, bool occlusion);
+
+/*
+ * Evaluate the ongoing blend, move and scale transformations of all objects
+ * in a rendertarget as one batch per interpolation function rather than
+ * one object at a time.
+ */
+void arcan_video_batch_transforms(bool);
+
 arcan_errc arcan_video_screenshot(av_pixel** dptr, size_t* dsize);
 
 /*
@@ -524,10 +607,11 @@ arcan_errc arcan_video_resizefeed(arcan_vobj_id id, size_t w, size_t h);
  * defined in the resource will be retained, otherwise the image will be
  * rescaled upon loading (unfiltered and rather slow).
  *
- * The asynchronous version will spawn a worker thread (up to a certain
- * number, compile-time limited with ASYNCH_CONCURRENT_THREADS).
- * Context operations will force a join on any outstanding asynchronous
- * loading jobs.
+ * The asynchronous version will queue the decode on a pool of worker
+ * threads (compile-time sized with ASYNCH_CONCURRENT_THREADS), visible
+ * objects are decoded first. Context operations will force a join on any
+ * outstanding asynchronous loading jobs, deleting the object cancels it.
+ * Both versions share a cache of recently decoded images.
  *
  * Loadimage returns ARCAN_EID on failure, asynch will always succeed but
  * may later enqueue EVENT_ASYNCHIMAGE_FAILED or EVENT_VIDEO_ASYNCHIMAGE_LOADED
@@ -1138,6 +1222,13 @@ size_t arcan_video_pick(arcan_vobj_id rt,
 size_t arcan_video_rpick(arcan_vobj_id rt,
 	arcan_vobj_id* dst, size_t count, int x, int y);
 
+/*
+ * Keep a grid of the static objects in recently picked rendertargets so that
+ * picking only needs to test the objects near [x,y]. The results and their
+ * order are the same as without the index.
+ */
+void arcan_video_pick_index(bool);
+
 /*
  * Perform [steps] global monotonic timer updates, returning the number of
  * Returns the amount of miliseconds elapsed processing all objects.  If
@@ -16,6 +16,12 @@
 #define RENDERTARGET_LIMIT 64
 #endif
 
+/* number of frames of damage that is kept per rendertarget, partial redraws
+ * into buffers older than this fall back to a full redraw */
+#ifndef DAMAGE_HISTORY
+#define DAMAGE_HISTORY 4
+#endif
+
 /*
  *  Indicate that the video pipeline is in such a state that
  *  it should be redrawn. X should be NULL or a vobj reference
@@ -27,12 +33,31 @@ static void _int_flag(){
 
 #define FLAG_DIRTY(X) do {_int_flag(); arcan_video_display.dirty++; } while(0)
 
+/*
+ * Indicate that object geometry or rendertarget membership/order has changed
+ * in a way that makes the pick indices stale. FLAG_PICK covers everything
+ * (context and display changes), FLAG_PICK_RT a single rendertarget and
+ * FLAG_PICK_OBJ the rendertarget(s) that an object is attached to.
+ */
+#define FLAG_PICK() (arcan_video_display.pick_gen++)
+#define FLAG_PICK_RT(X) ((X)->pick_gen++)
+#define FLAG_PICK_OBJ(X) (arcan_vint_flagpick(X))
+
+/*
+ * Indicate that rendertarget membership, parent links or storage sharing has
+ * changed, making the cached rendertarget dependencies (ARCAN_VIDEO_PARALLEL_RT)
+ * stale. These are structural changes, plain movement doesn't matter here.
+ */
+#define FLAG_RTDEP() (arcan_video_display.rtdep_gen++)
+
 #define FL_SET(obj_ptr, fl) ((obj_ptr)->flags |= fl)
 #define FL_CLEAR(obj_ptr, fl) ((obj_ptr)->flags &= ~fl)
 #define FL_TEST(obj_ptr, fl) (( ((obj_ptr)->flags) & (fl)) > 0)
 
 struct arcan_vobject_litem;
 struct arcan_vobject;
+struct vatlas_slot;
+struct vatlas_page;
 
 enum rtgt_flags {
 	TGTFL_READING = 1,
@@ -102,6 +127,15 @@ struct rendertarget {
  */
 	size_t uploadc;
 
+/* bumped through FLAG_PICK_RT/_OBJ when geometry or membership changes in a
+ * way that makes the pick index for this rendertarget stale */
+	uint64_t pick_gen;
+
+/* cached outcome of the parallel recording dependency check, valid as long
+ * as indep_gen matches the FLAG_RTDEP generation */
+	bool indep;
+	uint64_t indep_gen;
+
 /*
  * dirty- management is still incomplete in that dirty- flagging is a global
  * video state and not bound to rendertarget which is in conflict with
@@ -127,6 +161,18 @@ struct rendertarget {
  * we need to track the lower accepted bounds and the max accepted bounds.
  */
 	size_t min_order, max_order;
+
+/* damage tracking (see process_rendertarget), box accumulates the bounds in
+ * normalized device coordinates of objects that have left the pipeline since
+ * the last processing, history is the damage of the last drawn frames and sig
+ * covers the properties that invalidate the whole target when changed */
+	struct {
+		bool full;
+		float box[4];
+		float history[DAMAGE_HISTORY][4];
+		size_t history_ind, history_valid;
+		uint64_t sig;
+	} damage;
 };
 
 enum vobj_flags {
@@ -243,6 +289,13 @@ typedef struct arcan_vobject {
 	float* txcos;
 	enum arcan_blendfunc blendmode;
 
+/* set if vstore is a shared atlas page and txcos cover the region in [slot],
+ * next links the other objects that share the same region */
+	struct {
+		struct vatlas_slot* slot;
+		struct arcan_vobject* next;
+	} atlas;
+
 /* position */
 	signed int order;
 	surface_properties current;
@@ -264,9 +317,28 @@ typedef struct arcan_vobject {
 	surface_properties prop_cache;
 	float _Alignas(16) prop_matr[16];
 
-/* life-cycle tracking */
+/* in-frame resolve cache, only valid while the cookie matches the display
+ * resolve_cookie and for the same interpolation factor, static is set if
+ * there are no transformations anywhere in the parent chain */
+	struct {
+		uint64_t cookie;
+		float lerp;
+		bool static_chain;
+		surface_properties props;
+	} frame_cache;
+
+/* properties resolved ahead of rendertarget processing (possibly on another
+ * thread), only valid while the cookie matches the display record_cookie */
+	struct {
+		surface_properties props;
+		uint64_t cookie;
+	} record;
+
+/* life-cycle tracking, active_ind is the position (+1) in the context
+ * active set or 0 if the object is not a member */
 	unsigned long last_updated;
 	long lifetime;
+	size_t active_ind;
 
 /* management mappings */
 	enum parent_anchor p_anchor;
@@ -296,6 +368,23 @@ struct arcan_vobject_litem {
 	arcan_vobject* elem;
 	struct arcan_vobject_litem* next;
 	struct arcan_vobject_litem* previous;
+
+/* what was drawn the last time the rendertarget was processed with damage
+ * tracking: bounds, a hash of the draw state and the store update sequence */
+	struct {
+		bool drawn;
+		float box[4];
+		uint64_t sig;
+		uint32_t seq;
+		struct agp_rendertarget* art;
+	} damage;
+
+/* result of the culling pass for the rendertarget that was last processed,
+ * box is only valid if bounded is set */
+	struct {
+		bool hidden, bounded, occluder;
+		float box[4];
+	} cull;
 };
 typedef struct arcan_vobject_litem arcan_vobject_litem;
 
@@ -348,6 +437,50 @@ struct arcan_video_display {
 	arcan_tickv c_ticks;
 	float c_lerp;
 
+/* split the transform resolution part of independent rendertargets to the
+ * conductor worker pool, recorded is set while such results are valid */
+	bool parallel_rt, recorded;
+	uint64_t record_cookie;
+	uint64_t rtdep_gen;
+
+/* merge runs of compatible objects into batched draws, and the number of
+ * draw calls issued during the last refresh */
+	bool batch_2d;
+	size_t drawcalls;
+
+/* sub-allocate small images from shared atlas pages */
+	bool atlas;
+
+/* queue in-progress transforms and evaluate them in batches per tick */
+	bool batch_transform;
+
+/* only visit the objects in the context active set when ticking */
+	bool active_set;
+
+/* accelerate pick/rpick with a grid per rendertarget, pick_gen is bumped
+ * through FLAG_PICK whenever all existing indices become stale */
+	bool pick_index;
+	uint64_t pick_gen;
+
+/* only redraw the changed regions of rendertargets */
+	bool damage;
+
+/* skip objects outside of the rendertarget (cull) or hidden behind opaque
+ * objects (occlusion), and the number of skipped objects in the last refresh */
+	bool cull, occlusion;
+	size_t culled, occluded;
+
+/* block compress static images on load, even without backend support */
+	bool compress, compress_force;
+
+/* keep linked shader programs as driver binaries in the appl state */
+	bool shader_cache;
+
+/* stamp for the in-frame resolve cache, bumped for each refresh and only set
+ * while the rendertargets are being processed (0 = disabled) */
+	bool frame_cache;
+	uint64_t resolve_cookie;
+
 	unsigned char msasamples;
 	char* txdump;
 };
@@ -374,6 +507,17 @@ struct arcan_video_context {
 	ssize_t n_rtargets;
 
 	struct rendertarget stdoutp;
+
+/* atlas pages for objects in this context, see arcan_vatlas.c */
+	struct vatlas_page* atlas;
+
+/* objects that might need to be visited each tick (transformations, feeds,
+ * frame cycling, lifetime or pending asynch loads), [tick] is scratch of the
+ * same size used to walk a stable copy while the set changes */
+	struct {
+		arcan_vobj_id* ids, * tick;
+		size_t count, limit;
+	} active;
 };
 
 extern struct arcan_video_context vcontext_stack[];
@@ -418,11 +562,69 @@ void arcan_vint_pollreadback(struct rendertarget* rtgt);
 arcan_errc arcan_vint_attachobject(arcan_vobj_id id);
 
 /*
- * semaphore- rate limited image decoding and repacking to native
- * format used both threaded and non-threaded
+ * decode (or fetch from the decode cache) the image at [fname] and
+ * assign it as the store of [dst]
  */
 arcan_errc arcan_vint_getimage(const char* fname,
-	arcan_vobject* dst, img_cons forced, bool asynchsrc);
+	arcan_vobject* dst, img_cons forced);
+
+/*
+ * Revert a block compressed image store to plain pixels, decoding the source
+ * again if the blocks have been dropped (conservative mode). No-op for other
+ * stores.
+ */
+void arcan_vint_uncompress(arcan_vobject* vobj);
+
+/*
+ * implemented in arcan_vdecode.c
+ * image decoding and repacking to the native format, rescaled to match the
+ * constraints and the scale mode. [raw] is NULL for native-compressed images.
+ * With [compress], large enough images are block compressed and [raw] holds
+ * [s_raw] bytes in the format indicated by [compression].
+ */
+struct arcan_vdecode {
+	av_pixel* raw;
+	size_t s_raw;
+	size_t w, h;
+	size_t origw, origh;
+	enum agp_compression compression;
+	arcan_errc rc;
+};
+
+arcan_errc arcan_vint_decode(const char* fname, img_cons forced,
+	enum arcan_vimage_mode scale, bool flip, bool compress,
+	struct arcan_vdecode* out);
+
+/*
+ * queue an asynchronous decode on the worker pool, jobs with a higher [prio]
+ * are picked first. A job is finished either by collect or by cancel.
+ */
+struct arcan_vdecode_job;
+struct arcan_vdecode_job* arcan_vint_decode_queue(const char* fname,
+	img_cons forced, enum arcan_vimage_mode scale, bool flip, bool compress,
+	int prio);
+
+void arcan_vint_decode_prio(struct arcan_vdecode_job*, int prio);
+
+/*
+ * retrieve the result of a finished job into [out], the caller takes over
+ * the buffer. Returns false if the job hasn't finished, unless [wait] is set
+ * in which case the job is decoded in place or waited for.
+ */
+bool arcan_vint_decode_collect(
+	struct arcan_vdecode_job*, bool wait, struct arcan_vdecode* out);
+
+void arcan_vint_decode_cancel(struct arcan_vdecode_job*);
+
+/*
+ * set the size limit (bytes) of the decode cache, 0 disables it
+ */
+void arcan_vint_decode_cache(size_t limit);
+
+/*
+ * stop the workers and drop any queued jobs and the cache
+ */
+void arcan_vint_decode_shutdown();
 
 #ifdef _DEBUG
 void arcan_debug_tracetag_dump();
@@ -454,6 +656,36 @@ void arcan_vint_joinasynch(arcan_vobject* img, bool emit, bool force);
 
 void arcan_vint_reraster(arcan_vobject* img, struct rendertarget*);
 
+/*
+ * If atlas allocation is enabled and [vobj] has a populated, uniquely
+ * referenced and small enough TEX2D store, copy the contents into an atlas
+ * page of the current context, replace the store with a reference to the
+ * page and set txcos to cover the region. Returns true if the object was
+ * moved, the private store is released and won't have been uploaded.
+ */
+bool arcan_vint_atlas_alloc(arcan_vobject* vobj);
+
+/*
+ * Move [vobj] back to a private store with the contents of its atlas region.
+ * This needs to be done before any operation that would modify the store in
+ * place or treat txcos as relative to the full store. No-op if not atlased.
+ * Block compressed stores are uncompressed (arcan_vint_uncompress) as well,
+ * so the same rule covers all direct access to the pixels of a store.
+ */
+void arcan_vint_atlas_detach(arcan_vobject* vobj);
+
+/*
+ * Drop the region reference of [vobj] (deletion, store replacement), the
+ * vstore reference itself is left to the caller.
+ */
+void arcan_vint_atlas_release(arcan_vobject* vobj);
+
+/*
+ * [dst] has been set to share the store of [src], track it as a user of the
+ * same atlas region so that it is updated if the page is repacked.
+ */
+void arcan_vint_atlas_share(arcan_vobject* src, arcan_vobject* dst);
+
 /*
  * Figure out what the vid will be for the next object allocated in this
  * context. This function is primarily used to avoid an initialization
@@ -469,6 +701,12 @@ arcan_vobj_id arcan_vint_nextfree();
 struct rendertarget* arcan_vint_findrt(arcan_vobject* vobj);
 struct rendertarget* arcan_vint_findrt_vstore(struct agp_vstore* st);
 
+/*
+ * mark the pick indices of the rendertarget(s) [vobj] is attached to as
+ * stale, use through FLAG_PICK_OBJ
+ */
+void arcan_vint_flagpick(arcan_vobject* vobj);
+
 /*
  * used by the video platform layer, assume that agp_vstore points
  * to the backing end of a rendertarget, and draw it to the bound output-rt
@@ -213,11 +213,11 @@ void agp_readback_synchronous(struct agp_vstore* dst)
 	verbose_print(
 		"synchronous readback from id: %u", (unsigned)agp_resolve_texid(dst));
 
-	env->bind_texture(GL_TEXTURE_2D, agp_resolve_texid(dst));
+	agp_glbind(env, GL_TEXTURE_2D, agp_resolve_texid(dst));
 	env->get_tex_image(GL_TEXTURE_2D, 0,
 		GL_PIXEL_FORMAT, GL_UNSIGNED_BYTE, dst->vinf.text.raw);
 	dst->update_ts = arcan_timemillis();
-	env->bind_texture(GL_TEXTURE_2D, 0);
+	agp_glbind(env, GL_TEXTURE_2D, 0);
 }
 
 static void pbo_stream(struct agp_vstore* s,
@@ -388,6 +388,21 @@ struct stream_meta agp_stream_prepare(struct agp_vstore* s,
 			pbo_stream(s, meta.buf, &meta, type == STREAM_RAW_DIRECT_COPY);
 	break;
 
+/* orphan the previous store so that the mapping doesn't stall on an upload
+ * that is still in flight, the copy and unmap is deferred to commit */
+	case STREAM_RAW_DIRECT_MAPPED:
+		verbose_print("(%"PRIxPTR") prepare upload (raw/mapped)", (uintptr_t) s);
+		if (!s->vinf.text.wid)
+			setup_unpack_pbo(s, NULL);
+
+		env->bind_buffer(GL_PIXEL_UNPACK_BUFFER, s->vinf.text.wid);
+		env->buffer_data(GL_PIXEL_UNPACK_BUFFER,
+			s->w * s->h * sizeof(av_pixel), NULL, GL_STREAM_DRAW);
+		res.buf = env->map_buffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+		res.state = res.buf != NULL;
+		env->bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	break;
+
 /* resynch: drop PBOs and GLid, alloc / upload and rebuild possible PBOs */
 	case STREAM_EXT_RESYNCH:
 		verbose_print("(%"PRIxPTR") resynch stream", (uintptr_t) s);
@@ -434,6 +449,19 @@ struct stream_meta agp_stream_prepare(struct agp_vstore* s,
 void agp_stream_release(struct agp_vstore* s, struct stream_meta meta)
 {
 	struct agp_fenv* env = agp_env();
+
+/* a mapped upload that won't be committed, unmap and drop the contents */
+	if (meta.type == STREAM_RAW_DIRECT_MAPPED){
+		if (!meta.state)
+			return;
+
+		verbose_print("(%"PRIxPTR") discard mapped upload", (uintptr_t) s);
+		env->bind_buffer(GL_PIXEL_UNPACK_BUFFER, s->vinf.text.wid);
+		env->unmap_buffer(GL_PIXEL_UNPACK_BUFFER);
+		env->bind_buffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
+		return;
+	}
+
 	if (meta.dirty)
 		pbo_stream_sub(s, s->vinf.text.raw, &meta, false);
 	else
@@ -446,6 +474,21 @@ void agp_stream_release(struct agp_vstore* s, struct stream_meta meta)
 
 void agp_stream_commit(struct agp_vstore* s, struct stream_meta meta)
 {
+	if (meta.type != STREAM_RAW_DIRECT_MAPPED || !meta.state)
+		return;
+
+	struct agp_fenv* env = agp_env();
+	verbose_print("(%"PRIxPTR") commit mapped upload", (uintptr_t) s);
+
+	agp_activate_vstore(s);
+	env->bind_buffer(GL_PIXEL_UNPACK_BUFFER, s->vinf.text.wid);
+	env->unmap_buffer(GL_PIXEL_UNPACK_BUFFER);
+	env->tex_subimage_2d(GL_TEXTURE_2D, 0, 0, 0, s->w, s->h,
+		s->vinf.text.s_fmt ? s->vinf.text.s_fmt : GL_PIXEL_FORMAT,
+		GL_UNSIGNED_BYTE, 0
+	);
+	env->bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	agp_deactivate_vstore();
 }
 
 static void default_release(void* tag)
@@ -484,11 +527,11 @@ void agp_request_readback(struct agp_vstore* store)
 	verbose_print("(%"PRIxPTR":glid %u) getTexImage2D => PBO",
 		(uintptr_t) store, (unsigned) store->vinf.text.glid);
 
-	env->bind_texture(GL_TEXTURE_2D, agp_resolve_texid(store));
+	agp_glbind(env, GL_TEXTURE_2D, agp_resolve_texid(store));
 	env->bind_buffer(GL_PIXEL_PACK_BUFFER, store->vinf.text.rid);
 	env->get_tex_image(GL_TEXTURE_2D, 0, GL_PIXEL_FORMAT, GL_UNSIGNED_BYTE, NULL);
 	env->bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
-	env->bind_texture(GL_TEXTURE_2D, 0);
+	agp_glbind(env, GL_TEXTURE_2D, 0);
 }
 
 struct asynch_readback_meta agp_poll_readback(struct agp_vstore* store)
@@ -317,6 +317,12 @@ struct stream_meta agp_stream_prepare(struct agp_vstore* s,
 		agp_update_vstore(s, true);
 	break;
 
+/* no mappable unpack buffers here, caller falls back to RAW_DIRECT */
+	case STREAM_RAW_DIRECT_MAPPED:
+		mout.buf = NULL;
+		mout.state = false;
+	break;
+
 	case STREAM_RAW_DIRECT:
 	case STREAM_RAW_DIRECT_SYNCHRONOUS:
 	agp_activate_vstore(s);
@@ -98,6 +98,9 @@ struct agp_fenv {
 	void (*attach_shader) (GLuint, GLuint);
 	void (*link_program) (GLuint);
 	void (*get_program_iv) (GLuint, GLenum, GLint*);
+	void (*get_program_binary) (GLuint, GLsizei, GLsizei*, GLenum*, void*);
+	void (*program_binary) (GLuint, GLenum, const void*, GLsizei);
+	void (*program_parameter_i) (GLuint, GLenum, GLint);
 
 /* Texturing */
 	void (*gen_textures) (GLsizei, GLuint*);
@@ -108,6 +111,8 @@ struct agp_fenv {
 		GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*);
 	void (*tex_image_2d) (GLenum,
 		GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*);
+	void (*compressed_tex_image_2d) (GLenum,
+		GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const GLvoid*);
 	void (*tex_image_2d_multisample) (
 		GLenum, GLsizei, GLint, GLsizei, GLsizei, GLboolean);
 	void (*tex_image_3d)(
@@ -152,10 +157,44 @@ struct agp_fenv {
 	GLenum blend_src_alpha, blend_dst_alpha;
 	GLint last_store_mode;
 
+/* texture bound to the first unit, for skipping redundant binds */
+	GLenum active_unit, bound_mode;
+	GLuint bound_tex;
+
+/* state changes issued and skipped since the last agp_state_stats */
+	size_t n_programs, n_textures, n_uniforms, n_skipped;
+
 /* safety */
 	int (*reset_status) ();
 };
 
+/*
+ * All texture unit and bind changes go through these so that the binding of
+ * the first unit is known, agp_activate_vstore uses it to skip binds.
+ */
+static inline void agp_glunit(struct agp_fenv* env, GLenum unit)
+{
+	env->active_texture(unit);
+	env->active_unit = unit - GL_TEXTURE0;
+}
+
+static inline void agp_glbind(struct agp_fenv* env, GLenum mode, GLuint id)
+{
+	env->bind_texture(mode, id);
+	if (env->active_unit == 0){
+		env->bound_mode = mode;
+		env->bound_tex = id;
+	}
+}
+
+/* a deleted texture is unbound, and its name may be handed out again */
+static inline void agp_gldelete(struct agp_fenv* env, GLuint* id)
+{
+	if (env->bound_tex == *id)
+		env->bound_mode = GL_NONE;
+	env->delete_textures(1, id);
+}
+
 void agp_glinit_fenv(struct agp_fenv* dst,
 	void*(*lookup)(void* tag, const char* sym, bool req), void* tag);
 #endif
@@ -214,6 +214,32 @@ void agp_glinit_fenv(struct agp_fenv* dst,
 		(void(*)(GLuint, GLenum, GLint*))
 			lookup(tag, "glGetProgramiv");
 
+/* program binaries, for caching linked shaders between runs */
+#ifdef GLES3
+	bool progbin = true;
+#else
+	bool progbin = check_ext("GL_ARB_get_program_binary", ext);
+#endif
+	if (progbin){
+		dst->get_program_binary =
+			(void(*)(GLuint, GLsizei, GLsizei*, GLenum*, void*))
+				lookup_opt(tag, "glGetProgramBinary");
+		dst->program_binary =
+			(void(*)(GLuint, GLenum, const void*, GLsizei))
+				lookup_opt(tag, "glProgramBinary");
+		dst->program_parameter_i =
+			(void(*)(GLuint, GLenum, GLint))
+				lookup_opt(tag, "glProgramParameteri");
+	}
+	else if (check_ext("GL_OES_get_program_binary", ext)){
+		dst->get_program_binary =
+			(void(*)(GLuint, GLsizei, GLsizei*, GLenum*, void*))
+				lookup_opt(tag, "glGetProgramBinaryOES");
+		dst->program_binary =
+			(void(*)(GLuint, GLenum, const void*, GLsizei))
+				lookup_opt(tag, "glProgramBinaryOES");
+	}
+
 /* Texturing */
 	dst->gen_textures =
 		(void(*)(GLsizei, GLuint*))
@@ -233,6 +259,12 @@ void agp_glinit_fenv(struct agp_fenv* dst,
 	dst->tex_image_2d =	(void (*)(GLenum,
 		GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*))
 			lookup(tag, "glTexImage2D");
+/* only resolved when the formats we compress to can be sampled from */
+	if (check_ext("GL_EXT_texture_compression_s3tc", ext)){
+		dst->compressed_tex_image_2d = (void (*)(GLenum,
+			GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const GLvoid*))
+				lookup_opt(tag, "glCompressedTexImage2D");
+	}
 	dst->tex_image_3d = (void (*)(
 		GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*))
 			lookup(tag, "glTexImage3D");
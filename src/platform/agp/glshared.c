@@ -35,6 +35,14 @@
 #define GL_VERTEX_PROGRAM_POINT_SIZE GL_NONE
 #endif
 
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 #ifdef _DEBUG
 #define DEBUG 1
 #else
@@ -116,6 +124,13 @@ struct agp_rendertarget
 	size_t n_stores;
 	size_t dirty_flip, dirty_region, dirty_region_decay;
 	size_t store_ind;
+
+/* damage tracking, the scissor region is what draw calls invalidate and the
+ * sequence numbers track when each store was last cleared (for buffer age) */
+	struct agp_region scissor, dirty_box, dirty_box_decay;
+	size_t frame_seq;
+	size_t store_seq[MAX_BUFFERS];
+	bool proxied;
 	struct agp_vstore* stores[MAX_BUFFERS];
 	struct agp_vstore* shadow[MAX_BUFFERS];
 
@@ -123,6 +138,38 @@ struct agp_rendertarget
 	void* alloc_tag;
 };
 
+static void invalidate_age(struct agp_rendertarget* tgt)
+{
+	memset(tgt->store_seq, '\0', sizeof(tgt->store_seq));
+}
+
+static void region_merge(struct agp_region* dst, struct agp_region* src)
+{
+	if (src->x2 <= src->x1 || src->y2 <= src->y1)
+		return;
+
+	if (dst->x2 <= dst->x1 || dst->y2 <= dst->y1){
+		*dst = *src;
+		return;
+	}
+
+	dst->x1 = src->x1 < dst->x1 ? src->x1 : dst->x1;
+	dst->y1 = src->y1 < dst->y1 ? src->y1 : dst->y1;
+	dst->x2 = src->x2 > dst->x2 ? src->x2 : dst->x2;
+	dst->y2 = src->y2 > dst->y2 ? src->y2 : dst->y2;
+}
+
+static struct agp_region viewport_region(struct agp_rendertarget* tgt)
+{
+	ssize_t* vp = tgt->viewport;
+	return (struct agp_region){
+		.x1 = vp[0] > 0 ? vp[0] : 0,
+		.y1 = vp[1] > 0 ? vp[1] : 0,
+		.x2 = vp[0] + vp[2] > 0 ? vp[0] + vp[2] : 0,
+		.y2 = vp[1] + vp[3] > 0 ? vp[1] + vp[3] : 0
+	};
+}
+
 static void erase_store(struct agp_vstore* os)
 {
 	if (!os)
@@ -144,6 +191,7 @@ static void setup_stores(struct agp_rendertarget* dst)
 	dst->n_stores = MAX_BUFFERS;
 	dst->dirty_flip = MAX_BUFFERS;
 	dst->dirty_region_decay = dst->dirty_region = 0;
+	invalidate_age(dst);
 
 /* build the current ones based on the reference store properties */
 	for (size_t i = 0; i < MAX_BUFFERS; i++){
@@ -211,6 +259,7 @@ void agp_rendertarget_dropswap(struct agp_rendertarget* tgt)
 
 	BIND_FRAMEBUFFER(0);
 	tgt->dirty_flip++;
+	invalidate_age(tgt);
 }
 
 size_t agp_rendertarget_dirty(
@@ -219,11 +268,16 @@ size_t agp_rendertarget_dirty(
 	if (!dst)
 		return 0;
 
-/* rather unsofisticated, we could/should have a n-buffered merge-region
- * instead of this inc/dec/decay nonsense - but all in due course */
+/* the regions are merged into one bounding box, the count decays over two
+ * flushes to cover double buffered consumers */
 	if (dirty){
 		dst->dirty_region++;
 		dst->dirty_region_decay++;
+
+		if (dirty->x2 <= dirty->x1 || dirty->y2 <= dirty->y1)
+			region_merge(&dst->dirty_box, &dst->scissor);
+		else
+			region_merge(&dst->dirty_box, dirty);
 	}
 
 	return dst->dirty_region_decay;
@@ -317,7 +371,7 @@ static void drop_msaa(struct agp_rendertarget* dst)
 	struct agp_fenv* env = agp_env();
 	env->delete_framebuffers(1,&dst->msaa_fbo);
 	env->delete_renderbuffers(1,&dst->msaa_depth);
-	env->delete_textures(1,&dst->msaa_color);
+	agp_gldelete(env, &dst->msaa_color);
 	dst->msaa_fbo = dst->msaa_depth = dst->msaa_color = GL_NONE;
 
 	verbose_print("(%"PRIxPTR") drop MSAA", (uintptr_t) dst);
@@ -350,10 +404,10 @@ static bool alloc_fbo(struct agp_rendertarget* dst, bool retry)
 #if !defined(GLES2)
 	if (mode == RENDERTARGET_MSAA){
 		env->gen_textures(1, &dst->msaa_color);
-		env->bind_texture(GL_TEXTURE_2D_MULTISAMPLE, dst->msaa_color);
+		agp_glbind(env, GL_TEXTURE_2D_MULTISAMPLE, dst->msaa_color);
 		env->tex_image_2d_multisample(GL_TEXTURE_2D_MULTISAMPLE, GL_RGB, 4,
 			dst->store->w, dst->store->h, GL_TRUE);
-		env->bind_texture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+		agp_glbind(env, GL_TEXTURE_2D_MULTISAMPLE, 0);
 		env->gen_framebuffers(1, &dst->msaa_fbo);
 		env->gen_renderbuffers(1, &dst->msaa_depth);
 		BIND_FRAMEBUFFER(dst->msaa_fbo);
@@ -492,9 +546,10 @@ static bool alloc_fbo(struct agp_rendertarget* dst, bool retry)
 void agp_empty_vstore(struct agp_vstore* vs, size_t w, size_t h)
 {
 	size_t sz = w * h * sizeof(av_pixel);
-	if (!vs->vinf.text.s_raw){
+	if (!vs->vinf.text.s_raw || vs->vinf.text.compression){
 		vs->vinf.text.s_raw = sz;
 	}
+	vs->vinf.text.compression = AGP_COMPRESS_NONE;
 
 /* this is to allow an override of s_fmt and still handle reset */
 	if (vs->vinf.text.s_fmt == 0){
@@ -562,7 +617,7 @@ static bool update_3dtex(
 	struct agp_vstore* backing, size_t n_slices, struct agp_vstore** slices)
 {
 	struct agp_fenv* env = agp_env();
-	env->bind_texture(GL_TEXTURE_3D, backing->vinf.text.glid);
+	agp_glbind(env, GL_TEXTURE_3D, backing->vinf.text.glid);
 	return true;
 }
 
@@ -585,7 +640,7 @@ static bool update_cube(
  * and setting the output layers to behave accordingly - won't happen.
  */
 	struct agp_fenv* env = agp_env();
-	env->bind_texture(GL_TEXTURE_CUBE_MAP, backing->vinf.text.glid);
+	agp_glbind(env, GL_TEXTURE_CUBE_MAP, backing->vinf.text.glid);
 	env->tex_param_i(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	env->tex_param_i(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	env->tex_param_i(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -630,7 +685,7 @@ static bool update_cube(
 	}
 
 	backing->update_ts = arcan_timemillis();
-	env->bind_texture(GL_TEXTURE_CUBE_MAP, 0);
+	agp_glbind(env, GL_TEXTURE_CUBE_MAP, 0);
 	return true;
 }
 
@@ -759,6 +814,7 @@ bool agp_rendertarget_swapstore(
 		return true;
 
 	tgt->store = vstore;
+	invalidate_age(tgt);
 	BIND_FRAMEBUFFER(tgt->fbo);
 
 	env->framebuffer_texture_2d(GL_FRAMEBUFFER,
@@ -788,6 +844,7 @@ struct agp_rendertarget* agp_setup_rendertarget(
 	r->clearcol[1] = 0.05;
 	r->clearcol[2] = 0.05;
 	r->clearcol[3] = 1.0;
+	r->scissor = viewport_region(r);
 	verbose_print("vstore (%"PRIxPTR") bound to rendertarget "
 		"(%"PRIxPTR") in mode %d", (uintptr_t) vstore, (uintptr_t) r, (int) m);
 
@@ -973,6 +1030,7 @@ void agp_activate_rendertarget(struct agp_rendertarget* tgt)
 		if (tgt->store->refcount < 2 &&
 			tgt->proxy_state && tgt->proxy_state(tgt, tgt->proxy_tag)){
 			verbose_print("rendertarget-proxy");
+			tgt->proxied = true;
 			BIND_FRAMEBUFFER(0);
 			env->clear_color(tgt->clearcol[0],
 				tgt->clearcol[1], tgt->clearcol[2], tgt->clearcol[3]);
@@ -981,6 +1039,7 @@ void agp_activate_rendertarget(struct agp_rendertarget* tgt)
 		}
 		else {
 			verbose_print("rendertarget-fbo(%d)", (int)tgt->fbo);
+			tgt->proxied = false;
 			BIND_FRAMEBUFFER(tgt->fbo);
 		}
 		w = tgt->store->w;
@@ -991,6 +1050,7 @@ void agp_activate_rendertarget(struct agp_rendertarget* tgt)
 		ssize_t* vp = tgt->viewport;
 		env->scissor(vp[0], vp[1], vp[2], vp[3]);
 		env->viewport(vp[0], vp[1], vp[2], vp[3]);
+		tgt->scissor = viewport_region(tgt);
 
 		verbose_print("clear(%f, %f, %f, %f)",
 			tgt->clearcol[0], tgt->clearcol[1], tgt->clearcol[2], tgt->clearcol[3]);
@@ -1005,18 +1065,67 @@ void agp_activate_rendertarget(struct agp_rendertarget* tgt)
 void agp_rendertarget_dirty_reset(
 	struct agp_rendertarget* src, struct agp_region* dst)
 {
-	for (size_t i = 0; i < src->dirty_region_decay && dst; i++){
-		dst[i] = (struct agp_region){
+	struct agp_region box = src->dirty_box;
+	region_merge(&box, &src->dirty_box_decay);
+
+/* nothing tracked, fall back to the full store */
+	if (box.x2 <= box.x1 || box.y2 <= box.y1)
+		box = (struct agp_region){
 			.x1 = 0, .y1 = 0,
 			.x2 = src->store->w, .y2 = src->store->h
 		};
-	}
+
+	for (size_t i = 0; i < src->dirty_region_decay && dst; i++)
+		dst[i] = box;
 
 /* this assumes that we are double- buffered though the reality might be
- * more or less than that - so quick workaround now and do it for real a
- * bit later */
+ * more or less than that, any deeper swapchain uses the buffer age instead */
 	src->dirty_region_decay = src->dirty_region;
 	src->dirty_region = 0;
+	src->dirty_box_decay = src->dirty_box;
+	src->dirty_box = (struct agp_region){};
+}
+
+void agp_rendertarget_scissor(struct agp_rendertarget* tgt, float* ndc)
+{
+	if (!tgt)
+		return;
+
+	struct agp_region reg = viewport_region(tgt);
+
+/* pad with a pixel on each side to cover filtering and rounding */
+	if (ndc){
+		ssize_t* vp = tgt->viewport;
+		float x1 = floorf((ndc[0] * 0.5f + 0.5f) * vp[2]) + vp[0] - 1;
+		float y1 = floorf((ndc[1] * 0.5f + 0.5f) * vp[3]) + vp[1] - 1;
+		float x2 = ceilf((ndc[2] * 0.5f + 0.5f) * vp[2]) + vp[0] + 1;
+		float y2 = ceilf((ndc[3] * 0.5f + 0.5f) * vp[3]) + vp[1] + 1;
+
+		if (x1 > reg.x1)
+			reg.x1 = x1;
+		if (y1 > reg.y1)
+			reg.y1 = y1;
+		if (x2 < reg.x2)
+			reg.x2 = x2 > reg.x1 ? x2 : reg.x1;
+		if (y2 < reg.y2)
+			reg.y2 = y2 > reg.y1 ? y2 : reg.y1;
+	}
+
+	tgt->scissor = reg;
+	verbose_print("(%"PRIxPTR") scissor: %zu,%zu-%zu,%zu",
+		(uintptr_t) tgt, reg.x1, reg.y1, reg.x2, reg.y2);
+
+	if (tgt == active_rendertarget)
+		agp_env()->scissor(reg.x1, reg.y1, reg.x2 - reg.x1, reg.y2 - reg.y1);
+}
+
+size_t agp_rendertarget_age(struct agp_rendertarget* tgt)
+{
+	if (!tgt || tgt->proxied)
+		return 0;
+
+	size_t seq = tgt->store_seq[tgt->n_stores ? tgt->store_ind : 0];
+	return seq ? tgt->frame_seq + 1 - seq : 0;
 }
 
 void agp_rendertarget_clear()
@@ -1025,6 +1134,12 @@ void agp_rendertarget_clear()
 
 	agp_env()->clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	agp_rendertarget_dirty(active_rendertarget, &(struct agp_region){});
+
+/* track when the current store was last drawn to for agp_rendertarget_age */
+	if (active_rendertarget){
+		struct agp_rendertarget* tgt = active_rendertarget;
+		tgt->store_seq[tgt->n_stores ? tgt->store_ind : 0] = ++tgt->frame_seq;
+	}
 }
 
 void agp_pipeline_hint(enum pipeline_mode mode)
@@ -1068,7 +1183,7 @@ void agp_null_vstore(struct agp_vstore* store)
 		return;
 
 	struct agp_fenv* env = agp_env();
-	env->delete_textures(1, &store->vinf.text.glid);
+	agp_gldelete(env, &store->vinf.text.glid);
 	verbose_print("cleared (%"PRIxPTR"), dropped %u",
 		(uintptr_t) store, store->vinf.text.glid);
 	store->vinf.text.glid = GL_NONE;
@@ -1096,6 +1211,10 @@ void agp_rendertarget_viewport(struct agp_rendertarget* tgt,
 		return;
 	}
 
+	if (tgt->viewport[0] != x1 || tgt->viewport[1] != y1 ||
+		tgt->viewport[2] != x2 || tgt->viewport[3] != y2)
+		invalidate_age(tgt);
+
 	tgt->viewport[0] = x1;
 	tgt->viewport[1] = y1;
 	tgt->viewport[2] = x2;
@@ -1136,6 +1255,7 @@ void agp_resize_rendertarget(
 	tgt->viewport[3] = newh;
 	tgt->store_ind = 0;
 	tgt->rz_ack = true;
+	invalidate_age(tgt);
 
 	if (tgt->n_stores){
 		for (size_t i = 0; i < tgt->n_stores; i++){
@@ -1187,8 +1307,8 @@ void agp_activate_vstore_multi(struct agp_vstore** backing, size_t n)
 	verbose_print("vstore-set-multi: %zu", n);
 
 	for (int i = 0; i < n && i < 99; i++){
-		env->active_texture(GL_TEXTURE0 + i);
-		env->bind_texture(GL_TEXTURE_2D, agp_resolve_texid(backing[i]));
+		agp_glunit(env, GL_TEXTURE0 + i);
+		agp_glbind(env, GL_TEXTURE_2D, agp_resolve_texid(backing[i]));
 		if (i < 10)
 			buf[6] = '0' + i;
 		else{
@@ -1198,7 +1318,7 @@ void agp_activate_vstore_multi(struct agp_vstore** backing, size_t n)
 		agp_shader_forceunif(buf, shdrint, &i);
 	}
 
-	env->active_texture(GL_TEXTURE0);
+	agp_glunit(env, GL_TEXTURE0);
 }
 
 void agp_update_vstore(struct agp_vstore* s, bool copy)
@@ -1210,9 +1330,11 @@ void agp_update_vstore(struct agp_vstore* s, bool copy)
 	verbose_print(
 		"update vstore (%"PRIxPTR"), copy: %d", (uintptr_t) s, (int) copy);
 	FLAG_DIRTY();
+	s->damage.seq++;
+	s->damage.partial = false;
 
 	if (!copy)
-		env->bind_texture(GL_TEXTURE_2D, s->vinf.text.glid);
+		agp_glbind(env, GL_TEXTURE_2D, s->vinf.text.glid);
 	else{
 		if (GL_NONE == s->vinf.text.glid)
 			env->gen_textures(1, &s->vinf.text.glid);
@@ -1222,7 +1344,7 @@ void agp_update_vstore(struct agp_vstore* s, bool copy)
 		if (s->refcount == 0)
 			s->refcount = 1;
 
-		env->bind_texture(GL_TEXTURE_2D, s->vinf.text.glid);
+		agp_glbind(env, GL_TEXTURE_2D, s->vinf.text.glid);
 	}
 	s->vinf.text.glid_proxy = NULL;
 
@@ -1232,7 +1354,10 @@ void agp_update_vstore(struct agp_vstore* s, bool copy)
 		s->txv == ARCAN_VTEX_REPEAT ? GL_REPEAT : GL_CLAMP_TO_EDGE);
 
 	int filtermode = s->filtermode & (~ARCAN_VFILTER_MIPMAP);
-	bool mipmap = s->filtermode & ARCAN_VFILTER_MIPMAP;
+
+/* mipmaps can't be generated for the compressed formats */
+	bool mipmap = (s->filtermode & ARCAN_VFILTER_MIPMAP) &&
+		s->vinf.text.compression == AGP_COMPRESS_NONE;
 
 /*
  * Mipmapping still misses the option to manually define mipmap levels
@@ -1287,6 +1412,19 @@ void agp_update_vstore(struct agp_vstore* s, bool copy)
 		if (s->txmapped == TXSTATE_DEPTH)
 			env->tex_image_2d(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, s->w, s->h, 0,
 				GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, 0);
+/* the engine uncompresses the store if the format isn't supported, if that
+ * was missed the contents are left undefined rather than misinterpreted */
+		else if (s->vinf.text.compression != AGP_COMPRESS_NONE){
+			if (env->compressed_tex_image_2d)
+				env->compressed_tex_image_2d(GL_TEXTURE_2D, 0,
+					s->vinf.text.compression == AGP_COMPRESS_BC1 ?
+					GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+					s->w, s->h, 0, s->vinf.text.s_raw, s->vinf.text.raw
+				);
+			else
+				env->tex_image_2d(GL_TEXTURE_2D, 0, GL_STORE_PIXEL_FORMAT,
+					s->w, s->h, 0, GL_PIXEL_FORMAT, GL_UNSIGNED_BYTE, NULL);
+		}
 		else
 			env->tex_image_2d(GL_TEXTURE_2D, 0,
 				s->vinf.text.d_fmt ? s->vinf.text.d_fmt : GL_STORE_PIXEL_FORMAT,
@@ -1306,7 +1444,7 @@ void agp_update_vstore(struct agp_vstore* s, bool copy)
 	}
 #endif
 
-	env->bind_texture(GL_TEXTURE_2D, 0);
+	agp_glbind(env, GL_TEXTURE_2D, 0);
 }
 
 void agp_prepare_stencil()
@@ -1449,6 +1587,113 @@ void agp_draw_vobj(
 	agp_rendertarget_dirty(active_rendertarget, &(struct agp_region){});
 }
 
+/*
+ * Quads for agp_batch_quad, 6 vertices (two triangles) per quad with the
+ * position and texture coordinate interleaved. The buffer object is orphaned
+ * and refilled on every flush - GL2.1/GLES2 lack persistent mapping.
+ */
+static struct {
+	GLfloat* buf;
+	size_t n, cap;
+	GLuint vbo;
+} batch;
+
+void agp_batch_quad(float x1, float y1, float x2, float y2,
+	const float* txcos, const float* m)
+{
+	if (batch.n == batch.cap){
+		size_t ncap = batch.cap ? batch.cap * 2 : 256;
+		GLfloat* nbuf = arcan_alloc_mem(ncap * 24 * sizeof(GLfloat),
+			ARCAN_MEM_VBUFFER, ARCAN_MEM_NONFATAL, ARCAN_MEMALIGN_NATURAL);
+
+/* out of memory, submit what we have and start over */
+		if (!nbuf){
+			agp_batch_flush();
+			if (!batch.cap)
+				return;
+		}
+		else {
+			if (batch.buf){
+				memcpy(nbuf, batch.buf, batch.n * 24 * sizeof(GLfloat));
+				arcan_mem_free(batch.buf);
+			}
+			batch.buf = nbuf;
+			batch.cap = ncap;
+		}
+	}
+
+	if (!m)
+		m = ident;
+
+	if (!txcos)
+		txcos = (float[]){0, 0, 1, 0, 1, 1, 0, 1};
+
+	float vx[4] = {x1, x2, x2, x1};
+	float vy[4] = {y1, y1, y2, y2};
+	GLfloat quad[16];
+
+/* only the 2D part of the modelview matters as z = 0, w = 1 */
+	for (size_t i = 0; i < 4; i++){
+		quad[i * 4 + 0] = m[0] * vx[i] + m[4] * vy[i] + m[12];
+		quad[i * 4 + 1] = m[1] * vx[i] + m[5] * vy[i] + m[13];
+		quad[i * 4 + 2] = txcos[i * 2 + 0];
+		quad[i * 4 + 3] = txcos[i * 2 + 1];
+	}
+
+/* fan (0, 1, 2, 3) to triangles (0, 1, 2) (0, 2, 3) */
+	GLfloat* dst = &batch.buf[batch.n * 24];
+	static const size_t order[] = {0, 1, 2, 0, 2, 3};
+	for (size_t i = 0; i < 6; i++)
+		memcpy(&dst[i * 4], &quad[order[i] * 4], sizeof(GLfloat) * 4);
+
+	batch.n++;
+}
+
+size_t agp_batch_flush()
+{
+	if (!batch.n)
+		return 0;
+
+	struct agp_fenv* env = agp_env();
+	verbose_print("batch-flush(%zu)", batch.n);
+
+	if (!batch.vbo)
+		env->gen_buffers(1, &batch.vbo);
+
+	agp_shader_envv(MODELVIEW_MATR, ident, sizeof(float) * 16);
+	GLint attrindv = agp_shader_vattribute_loc(ATTRIBUTE_VERTEX);
+	GLint attrindt = agp_shader_vattribute_loc(ATTRIBUTE_TEXCORD0);
+
+	if (attrindv != -1){
+		size_t stride = sizeof(GLfloat) * 4;
+		env->bind_buffer(GL_ARRAY_BUFFER, batch.vbo);
+		env->buffer_data(GL_ARRAY_BUFFER,
+			batch.n * 24 * sizeof(GLfloat), batch.buf, GL_STREAM_DRAW);
+
+		env->enable_vertex_attrarray(attrindv);
+		env->vertex_attrpointer(attrindv, 2, GL_FLOAT, GL_FALSE, stride, NULL);
+
+		if (attrindt != -1){
+			env->enable_vertex_attrarray(attrindt);
+			env->vertex_attrpointer(attrindt, 2, GL_FLOAT,
+				GL_FALSE, stride, (GLvoid*)(sizeof(GLfloat) * 2));
+		}
+
+		env->draw_arrays(GL_TRIANGLES, 0, batch.n * 6);
+
+		if (attrindt != -1)
+			env->disable_vertex_attrarray(attrindt);
+		env->disable_vertex_attrarray(attrindv);
+
+/* the rest of the pipeline uses client side arrays */
+		env->bind_buffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	batch.n = 0;
+	agp_rendertarget_dirty(active_rendertarget, &(struct agp_region){});
+	return 1;
+}
+
 static void toggle_debugstates(float* modelview)
 {
 	struct agp_fenv* env = agp_env();
@@ -1636,7 +1881,7 @@ void agp_drop_vstore(struct agp_vstore* s)
 		arcan_mem_free(s->vinf.text.source_arr);
 	}
 
-	env->delete_textures(1, &s->vinf.text.glid);
+	agp_gldelete(env, &s->vinf.text.glid);
 	s->vinf.text.glid = GL_NONE;
 
 	if (GL_NONE != s->vinf.text.rid){
@@ -1775,15 +2020,22 @@ void agp_activate_vstore(struct agp_vstore* s)
 	break;
 	}
 
-	verbose_print("(%"PRIxPTR") vstore, glid: %u",
-		(uintptr_t) s, (unsigned) agp_resolve_texid(s));
-	env->bind_texture(env->last_store_mode, agp_resolve_texid(s));
+	GLuint id = agp_resolve_texid(s);
+	if (env->active_unit == 0 &&
+		env->bound_mode == env->last_store_mode && env->bound_tex == id){
+		env->n_skipped++;
+		return;
+	}
+
+	verbose_print("(%"PRIxPTR") vstore, glid: %u", (uintptr_t) s, (unsigned) id);
+	agp_glbind(env, env->last_store_mode, id);
+	env->n_textures++;
 }
 
 void agp_deactivate_vstore()
 {
 	verbose_print("");
-	agp_env()->bind_texture(GL_TEXTURE_2D, 0);
+	agp_glbind(agp_env(), GL_TEXTURE_2D, 0);
 }
 
 void agp_rendertarget_clearcolor(
@@ -1791,6 +2043,11 @@ void agp_rendertarget_clearcolor(
 {
 	if (!tgt)
 		return;
+
+	if (tgt->clearcol[0] != r || tgt->clearcol[1] != g ||
+		tgt->clearcol[2] != b || tgt->clearcol[3] != a)
+		invalidate_age(tgt);
+
 	tgt->clearcol[0] = r;
 	tgt->clearcol[1] = g;
 	tgt->clearcol[2] = b;
@@ -1863,3 +2120,27 @@ bool agp_accelerated()
 {
 	return false;
 }
+
+void agp_state_stats(struct agp_state_stats* out)
+{
+	struct agp_fenv* env = agp_env();
+	*out = (struct agp_state_stats){
+		.programs = env->n_programs,
+		.textures = env->n_textures,
+		.uniforms = env->n_uniforms,
+		.skipped = env->n_skipped
+	};
+	env->n_programs = env->n_textures = env->n_uniforms = env->n_skipped = 0;
+}
+
+bool agp_compression_support(enum agp_compression fmt)
+{
+	switch (fmt){
+	case AGP_COMPRESS_NONE:
+		return true;
+	case AGP_COMPRESS_BC1:
+	case AGP_COMPRESS_BC3:
+		return agp_env()->compressed_tex_image_2d != NULL;
+	}
+	return false;
+}
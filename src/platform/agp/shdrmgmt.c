@@ -13,6 +13,8 @@
 #include <string.h>
 #include <stddef.h>
 #include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
 
 #include "glfun.h"
 
@@ -30,6 +32,38 @@
 
 #define TBLSIZE (1 + TIMESTAMP_D - MODELVIEW_MATR)
 
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+/*
+ * Linked programs are stored as driver binaries in the appl state namespace,
+ * one file per program named after a hash of the driver identity (vendor,
+ * renderer, version) and the sources. The header repeats the key and carries
+ * a checksum of the binary, anything that doesn't match or that the driver
+ * refuses to link is rebuilt from source and replaced.
+ */
+#ifndef SHADER_CACHE_DIR
+#define SHADER_CACHE_DIR ".shadercache"
+#endif
+
+/* larger than this and the file is assumed to be broken */
+#ifndef SHADER_CACHE_LIMIT
+#define SHADER_CACHE_LIMIT (16 * 1024 * 1024)
+#endif
+
+struct shader_cache_hdr {
+	char magic[4];
+	uint32_t format;
+	uint64_t key;
+	uint64_t checksum;
+	uint32_t size;
+};
+
 /* all current global shader settings,
  * updated whenever a vobj/3dobj needs a different state
  * each global */
@@ -158,6 +192,10 @@ struct shader_cont {
 /* match attrsymtbl */
 	GLint attributes[9];
 
+/* the global values as last uploaded to this program, per slot in synched */
+	struct shader_envts synch;
+	uint32_t synched;
+
 	struct arcan_strarr ugroups;
 };
 
@@ -223,6 +261,42 @@ static void setv(GLint loc, enum shdrutype kind, void* val,
 	}
 }
 
+/*
+ * Uniform values are program state, so each program tracks what it has been
+ * given from the shared environment and only takes the slots that have
+ * changed since it was last active.
+ */
+static void synch_slot(struct shader_cont* cur, size_t slot)
+{
+	if (cur->locations[slot] < 0)
+		return;
+
+/* the counter tracks use of the slot (see agp_shader_envv), not uploads */
+	counttbl[slot]++;
+
+	char* src = (char*)(&shdr_global.context) + ofstbl[slot];
+	char* dst = (char*)(&cur->synch) + ofstbl[slot];
+	size_t sz = sizetbl[typetbl[slot]];
+
+	if ((cur->synched & (1 << slot)) && memcmp(src, dst, sz) == 0){
+		agp_env()->n_skipped++;
+		return;
+	}
+
+	memcpy(dst, src, sz);
+	cur->synched |= 1 << slot;
+	setv(cur->locations[slot], typetbl[slot], src, symtbl[slot], cur->label);
+	agp_env()->n_uniforms++;
+}
+
+/* a uniform was set outside of the shared environment */
+static void unsynch_loc(struct shader_cont* cur, GLint loc)
+{
+	for (size_t i = 0; i < TBLSIZE; i++)
+		if (cur->locations[i] == loc)
+			cur->synched &= ~(1 << i);
+}
+
 static void destroy_shader(struct shader_cont* cur)
 {
 	if (!cur->label)
@@ -300,45 +374,43 @@ int agp_shader_activate(agp_shader_id shid)
 	if (!agp_shader_valid(shid))
 		return ARCAN_ERRC_NO_SUCH_OBJECT;
 
- 	if (shid != shdr_global.active_prg){
-		struct shader_cont* cur = &shdr_global.slots[SHADER_INDEX(shid)];
-		if (SHADER_INDEX(shdr_global.active_prg) != SHADER_INDEX(shid))
-			agp_env()->use_program(cur->prg_container);
+	struct agp_fenv* env = agp_env();
+	if (shid == shdr_global.active_prg){
+		env->n_skipped++;
+		return ARCAN_OK;
+	}
+
+	struct shader_cont* cur = &shdr_global.slots[SHADER_INDEX(shid)];
+	if (SHADER_INDEX(shdr_global.active_prg) != SHADER_INDEX(shid)){
+		env->use_program(cur->prg_container);
+		env->n_programs++;
+	}
 
- 		shdr_global.active_prg = shid;
+	shdr_global.active_prg = shid;
 
 #ifdef SHADER_TRACE
-		arcan_warning("[shader] shid(%d) => (%d), activate %s\n",
-			SHADER_INDEX(shid), cur->prg_container, cur->label);
+	arcan_warning("[shader] shid(%d) => (%d), activate %s\n",
+		SHADER_INDEX(shid), cur->prg_container, cur->label);
 #endif
 
-/*
- * While we chould practically just update the uniforms that has actually
- * changed since the last push as we keep a cache, the incentive is rather
- * small (uniform- set on a bound shader is among the cheaper state changes
- * possible).
- */
-		for (size_t i = 0; i < sizeof(ofstbl) / sizeof(ofstbl[0]); i++){
-			if (cur->locations[i] >= 0){
-				setv(cur->locations[i], typetbl[i], (char*)(&shdr_global.context)
-					+ ofstbl[i], symtbl[i], cur->label);
-				counttbl[i]++;
-			}
-		}
+/* only the values that changed since the program was last active */
+	for (size_t i = 0; i < sizeof(ofstbl) / sizeof(ofstbl[0]); i++)
+		synch_slot(cur, i);
 
 /* activate any persistant values */
-		if (cur->ugroups.limit < GROUP_INDEX(shid)){
-			arcan_warning("attempt to activate shader(%d)(%d) failed: "
-				"broken group\n", (int)SHADER_INDEX(shid),(int)GROUP_INDEX(shid));
-			return -1;
-		}
-		struct shaderv* current = cur->ugroups.cdata[GROUP_INDEX(shid)];
-
-		while (current){
-			setv(current->loc, current->type, (void*) current->data,
-				current->label, cur->label);
-			current = current->next;
-		}
+	if (cur->ugroups.limit < GROUP_INDEX(shid)){
+		arcan_warning("attempt to activate shader(%d)(%d) failed: "
+			"broken group\n", (int)SHADER_INDEX(shid),(int)GROUP_INDEX(shid));
+		return -1;
+	}
+	struct shaderv* current = cur->ugroups.cdata[GROUP_INDEX(shid)];
+
+	while (current){
+		setv(current->loc, current->type, (void*) current->data,
+			current->label, cur->label);
+		unsynch_loc(cur, current->loc);
+		env->n_uniforms++;
+		current = current->next;
 	}
 
 	return ARCAN_OK;
@@ -472,6 +544,7 @@ agp_shader_id agp_shader_build(const char* tag,
 		return ARCAN_EID;
 
 	cur->shmask = shmask;
+	cur->synched = 0;
 	cur->label = strdup(tag);
 	cur->vertex = strdup(vert);
 	cur->fragment = strdup(frag);
@@ -525,20 +598,16 @@ int agp_shader_envv(enum agp_shader_envts slot, void* value, size_t size)
 	if (BROKEN_SHADER == shdr_global.active_prg)
 		return rv;
 
-	int glloc = shdr_global.slots[
-		SHADER_INDEX(shdr_global.active_prg)].locations[slot];
-
 /*
  * reflect change in current active shader, the others will be changed on
  * activation
  */
-	if (glloc != -1){
-		assert(size == sizetbl[ typetbl[slot] ]);
-		setv(glloc, typetbl[slot], value, symtbl[slot],
-			shdr_global.slots[SHADER_INDEX(shdr_global.active_prg)].label );
-		counttbl[slot]++;
+	struct shader_cont* cur =
+		&shdr_global.slots[SHADER_INDEX(shdr_global.active_prg)];
 
-		return rv;
+	if (cur->locations[slot] != -1){
+		assert(size == sizetbl[ typetbl[slot] ]);
+		synch_slot(cur, slot);
 	}
 
 	return rv;
@@ -640,6 +709,8 @@ void agp_shader_forceunif(const char* label, enum shdrutype type, void* value)
 
 	if (loc >= 0){
 		setv(loc, type, value, label, slot->label);
+		unsynch_loc(slot, loc);
+		agp_env()->n_uniforms++;
 	}
 #ifdef DEBUG
 	else
@@ -650,6 +721,155 @@ void agp_shader_forceunif(const char* label, enum shdrutype type, void* value)
 #endif
 }
 
+static uint64_t fnv1a(uint64_t hash, const void* buf, size_t n)
+{
+	const uint8_t* cur = buf;
+	for (size_t i = 0; i < n; i++)
+		hash = (hash ^ cur[i]) * 0x100000001b3ULL;
+	return hash;
+}
+
+static uint64_t cache_key(const char* vprogram, const char* fprogram)
+{
+	GLenum ident[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < sizeof(ident) / sizeof(ident[0]); i++){
+		const char* str = (const char*) glGetString(ident[i]);
+		if (str)
+			hash = fnv1a(hash, str, strlen(str) + 1);
+	}
+
+	hash = fnv1a(hash, vprogram, strlen(vprogram) + 1);
+	return fnv1a(hash, fprogram, strlen(fprogram) + 1);
+}
+
+#ifndef HEADLESS_NOARCAN
+static char* cache_path(uint64_t key)
+{
+	char name[sizeof(SHADER_CACHE_DIR) + 24];
+	snprintf(name, sizeof(name), SHADER_CACHE_DIR "/%016"PRIx64, key);
+	return arcan_expand_resource(name, RESOURCE_APPL_STATE);
+}
+
+static bool cache_load(uint64_t key, GLuint* dprg)
+{
+	struct agp_fenv* env = agp_env();
+	if (!arcan_video_display.shader_cache || !env->program_binary)
+		return false;
+
+	char* path = cache_path(key);
+	if (!path)
+		return false;
+
+	FILE* fpek = fopen(path, "r");
+	if (!fpek){
+		arcan_mem_free(path);
+		return false;
+	}
+
+	struct shader_cache_hdr hdr;
+	void* buf = NULL;
+	bool ok = fread(&hdr, sizeof(hdr), 1, fpek) == 1 &&
+		memcmp(hdr.magic, "ASHC", 4) == 0 && hdr.key == key &&
+		hdr.size > 0 && hdr.size <= SHADER_CACHE_LIMIT &&
+		(buf = malloc(hdr.size)) && fread(buf, hdr.size, 1, fpek) == 1 &&
+		fnv1a(0xcbf29ce484222325ULL, buf, hdr.size) == hdr.checksum;
+	fclose(fpek);
+
+	if (ok){
+		TRACE_MARK_ENTER("agp", "shader-cache", TRACE_SYS_DEFAULT, 0, 0, path);
+		*dprg = env->create_program();
+		env->program_binary(*dprg, hdr.format, buf, hdr.size);
+		GLint lstat = GL_FALSE;
+		env->get_program_iv(*dprg, GL_LINK_STATUS, &lstat);
+		TRACE_MARK_EXIT("agp", "shader-cache", TRACE_SYS_DEFAULT, 0, 0, path);
+
+/* typically a driver update that kept the version string */
+		if (GL_FALSE == lstat){
+			env->delete_program(*dprg);
+			*dprg = 0;
+			ok = false;
+		}
+	}
+
+	if (!ok)
+		unlink(path);
+
+	free(buf);
+	arcan_mem_free(path);
+	return ok;
+}
+
+/* write to the side and rename so a partial write never gets picked up */
+static void cache_write(
+	const char* path, struct shader_cache_hdr* hdr, void* buf)
+{
+	size_t plen = strlen(path) + sizeof(".tmp");
+	char tmp[plen];
+	snprintf(tmp, plen, "%s.tmp", path);
+
+	FILE* fpek = fopen(tmp, "w");
+	if (!fpek)
+		return;
+
+	bool ok = fwrite(hdr, sizeof(*hdr), 1, fpek) == 1 &&
+		fwrite(buf, hdr->size, 1, fpek) == 1;
+
+	if (0 == fclose(fpek) && ok)
+		rename(tmp, path);
+	else
+		unlink(tmp);
+}
+
+static void cache_store(uint64_t key, GLuint prg)
+{
+	struct agp_fenv* env = agp_env();
+	if (!arcan_video_display.shader_cache || !env->get_program_binary)
+		return;
+
+	GLint len = 0;
+	env->get_program_iv(prg, GL_PROGRAM_BINARY_LENGTH, &len);
+	if (len <= 0 || len > SHADER_CACHE_LIMIT)
+		return;
+
+	struct shader_cache_hdr hdr = {
+		.magic = {'A', 'S', 'H', 'C'},
+		.key = key
+	};
+
+	void* buf = malloc(len);
+	if (!buf)
+		return;
+
+	GLsizei outlen = 0;
+	GLenum format = 0;
+	env->get_program_binary(prg, len, &outlen, &format, buf);
+	hdr.format = format;
+	hdr.size = outlen;
+	hdr.checksum = fnv1a(0xcbf29ce484222325ULL, buf, outlen);
+
+	char* dir = arcan_expand_resource(SHADER_CACHE_DIR, RESOURCE_APPL_STATE);
+	char* path = cache_path(key);
+	if (dir && path && outlen > 0 &&
+		(0 == mkdir(dir, S_IRWXU) || errno == EEXIST))
+		cache_write(path, &hdr, buf);
+
+	free(buf);
+	arcan_mem_free(dir);
+	arcan_mem_free(path);
+}
+#else
+static bool cache_load(uint64_t key, GLuint* dprg)
+{
+	return false;
+}
+
+static void cache_store(uint64_t key, GLuint prg)
+{
+}
+#endif
+
 static void kill_shader(GLuint* dprg, GLuint* vprg, GLuint* fprg){
 	struct agp_fenv* env = agp_env();
 	if (*dprg)
@@ -714,12 +934,35 @@ static void dump_shaderlog(const char* label,
 	arcan_warning("%s shader failed on %s stage:\n", label, stage);
 }
 
+static void setup_program(GLuint prg)
+{
+	struct agp_fenv* env = agp_env();
+	env->use_program(prg);
+	int loc = env->get_uniform_loc(prg, "map_tu0");
+	GLint val = 0;
+
+	if (loc >= 0)
+		env->unif_1i(loc, val);
+
+	loc = env->get_uniform_loc(prg, "map_diffuse");
+	if (loc >= 0)
+		env->unif_1i(loc, val);
+}
+
 static bool build_shader(const char* label, GLuint* dprg,
 	GLuint* vprg, GLuint* fprg, const char* vprogram, const char* fprogram)
 {
 	struct agp_fenv* env = agp_env();
 	bool failed = false;
 
+/* the cached binary is already linked, there are no shader objects */
+	uint64_t key = cache_key(vprogram, fprogram);
+	if (cache_load(key, dprg)){
+		*vprg = *fprg = 0;
+		setup_program(*dprg);
+		return true;
+	}
+
 #ifdef DEBUG
 	bool force = true;
 #else
@@ -741,6 +984,8 @@ static bool build_shader(const char* label, GLuint* dprg,
 	*dprg = env->create_program();
 	env->attach_shader(*dprg, *fprg);
 	env->attach_shader(*dprg, *vprg);
+	if (env->program_parameter_i)
+		env->program_parameter_i(*dprg, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	env->link_program(*dprg);
 
 	int lstat = 0;
@@ -751,18 +996,11 @@ static bool build_shader(const char* label, GLuint* dprg,
 		dump_shaderlog(label, "link-vertex", vprogram, *dprg);
 		dump_shaderlog(label, "link-fragment", fprogram, *dprg);
 	}
-	else {
-		env->use_program(*dprg);
-		int loc = env->get_uniform_loc(*dprg, "map_tu0");
-		GLint val = 0;
+	else
+		setup_program(*dprg);
 
-		if (loc >= 0)
-			env->unif_1i(loc, val);
-
-		loc = env->get_uniform_loc(*dprg, "map_diffuse");
-		if (loc >= 0)
-			env->unif_1i(loc, val);
-	}
+	if (!failed)
+		cache_store(key, *dprg);
 
 	return !failed;
 }
@@ -785,12 +1023,17 @@ void agp_shader_flush()
 
 void agp_shader_rebuild_all()
 {
+/* after a context reset, nothing is known to be bound */
+	shdr_global.active_prg = BROKEN_SHADER;
+	agp_env()->bound_mode = GL_NONE;
+
 	for (size_t i = 0; i < sizeof(shdr_global.slots) /
 			sizeof(shdr_global.slots[0]); i++){
 		struct shader_cont* cur = shdr_global.slots + i;
 		if (cur->label == NULL)
 			continue;
 
+		cur->synched = 0;
 		build_shader(cur->label,
 			&cur->prg_container,
 			&cur->obj_vertex,
@@ -124,6 +124,15 @@ void agp_rendertarget_clear()
 {
 }
 
+void agp_rendertarget_scissor(struct agp_rendertarget* tgt, float* ndc)
+{
+}
+
+size_t agp_rendertarget_age(struct agp_rendertarget* tgt)
+{
+	return 0;
+}
+
 void agp_pipeline_hint(enum pipeline_mode mode)
 {
 }
@@ -167,6 +176,16 @@ void agp_draw_vobj(
 {
 }
 
+void agp_batch_quad(
+	float x1, float y1, float x2, float y2, const float* txcos, const float* m)
+{
+}
+
+size_t agp_batch_flush()
+{
+	return 0;
+}
+
 void agp_submit_mesh(struct agp_mesh_store* base, enum agp_mesh_flags fl)
 {
 }
@@ -332,3 +351,13 @@ bool agp_accelerated()
 	return false;
 }
 
+void agp_state_stats(struct agp_state_stats* out)
+{
+	*out = (struct agp_state_stats){0};
+}
+
+bool agp_compression_support(enum agp_compression fmt)
+{
+	return fmt == AGP_COMPRESS_NONE;
+}
+
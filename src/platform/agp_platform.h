@@ -125,6 +125,23 @@ unsigned agp_resolve_texid(struct agp_vstore* vs);
 
 bool agp_accelerated();
 
+/*
+ * Check if the active backend can sample from stores in the compressed
+ * format [fmt] (see agp_vstore.vinf.text.compression). Stores in formats
+ * that are not supported need to be uncompressed before being updated.
+ */
+bool agp_compression_support(enum agp_compression fmt);
+
+/*
+ * Number of program binds, texture binds and uniform uploads issued, and of
+ * the ones that were skipped as they wouldn't have changed anything, since
+ * the last call.
+ */
+struct agp_state_stats {
+	size_t programs, textures, uniforms, skipped;
+};
+void agp_state_stats(struct agp_state_stats* out);
+
 /*
  * Extended form to allow internal platform choice in format used,
  * can be used to some rendertargets for improved performance and for
@@ -175,6 +192,7 @@ enum stream_type {
 	STREAM_RAW_DIRECT,
 	STREAM_RAW_DIRECT_COPY,
 	STREAM_RAW_DIRECT_SYNCHRONOUS,
+	STREAM_RAW_DIRECT_MAPPED,
 	STREAM_EXT_RESYNCH,
 	STREAM_HANDLE
 };
@@ -206,6 +224,13 @@ struct stream_meta {
  *  - RAW_DIRECT_SYNCHRONOUS: block and copy meta.buf.
  *                pro: guarantee of content state, con: stalls pipeline
  *
+ *  - RAW_DIRECT_MAPPED: map the upload buffer and return it in meta.buf,
+ *                the caller populates it (from any thread) with a full
+ *                w * h frame, then commits on the graphics thread, or
+ *                releases it to discard the contents (failed copy).
+ *                pro: copy can be parallelized, con: state is false when
+ *                the platform lacks mappable upload buffers (fallback).
+ *
  *  - EXT_RESYNCH: vstore- is externally managed in terms of buffers,
  *                and contents have been invalidated (resize)
  *
@@ -307,6 +332,19 @@ void agp_blendstate(enum arcan_blendfunc);
 void agp_draw_vobj(float x1, float y1, float x2, float y2,
 	const float* txcos, const float* modelview);
 
+/*
+ * Batched alternative to agp_draw_vobj for many objects that share the same
+ * shader, vstore, blend state and uniforms. The quad is transformed with
+ * [modelview] on the CPU and queued, and the queue is drawn as one call with
+ * an identity modelview on agp_batch_flush. This is only equivalent for
+ * shaders that use the modelview for the vertex position alone. The caller
+ * is responsible for flushing before changing any of the shared state.
+ * Returns the number of draw calls issued by the flush (0 or 1).
+ */
+void agp_batch_quad(float x1, float y1, float x2, float y2,
+	const float* txcos, const float* modelview);
+size_t agp_batch_flush();
+
 /*
  * Destination format for rendertargets. Note that we do not currently suport
  * floating point targets and that for some platforms, COLOR_DEPTH will map to
@@ -426,7 +464,9 @@ void agp_drop_rendertarget(struct agp_rendertarget*);
 /*
  * manually mark part of rendertarget as dirty, returns number of invalidations
  * so far. if [dirty] is set to NULL, no changes will be marked, but counter
- * will still be returned.
+ * will still be returned. An empty region (x2 <= x1 or y2 <= y1) marks the
+ * current scissor region (see agp_rendertarget_scissor) as dirty, this is
+ * what the draw calls do.
  */
 struct agp_region {
 	size_t x1, y1, x2, y2;
@@ -438,10 +478,31 @@ size_t agp_rendertarget_dirty(
  * Flush the list of dirty regions, and store a copy inside [dst], if provided.
  * The [dst] size can be probed using agp_rendertarget_dirty(src, NULL).
  * This will also set the dirty- counter for the rendertarget to 0.
+ *
+ * The regions are merged into a bounding region (in pixels, lower-left origin)
+ * that covers the invalidations of this and the previous flush, and the same
+ * region is stored in each slot of [dst].
  */
 void agp_rendertarget_dirty_reset(
 	struct agp_rendertarget* src, struct agp_region* dst);
 
+/*
+ * Limit the clear and draw calls on [tgt] to the part of the viewport that
+ * covers the normalized device coordinates [ndc] (x1, y1, x2, y2), padded to
+ * whole pixels. If [ndc] is NULL, the limit is reset to the full viewport.
+ * Activating the rendertarget also resets the limit.
+ */
+void agp_rendertarget_scissor(struct agp_rendertarget* tgt, float* ndc);
+
+/*
+ * Return the number of frames since the buffer that the next clear and draw
+ * calls on [tgt] land in was last drawn to, or 0 if its contents are unknown,
+ * e.g. on first use, after a resize, viewport or clear color change, when the
+ * swapchain changes or when the output is proxied. Partial redraws need to
+ * cover the damage of the last [age] frames for the buffer to be complete.
+ */
+size_t agp_rendertarget_age(struct agp_rendertarget* tgt);
+
 /*
  * reset the currently bound rendertarget output buffer
  */
@@ -563,12 +563,13 @@ bool platform_video_map_handle(struct agp_vstore* dst, int64_t handle)
 	uintptr_t display;
 	arcan_shmifext_egl_meta(&disp[0].conn, &display, NULL, NULL);
 
+/* the descriptors are owned by the engine, only the import is ours */
 	if (0 != dst->vinf.text.tag){
+		if (handle == dst->vinf.text.handle)
+			return true;
+
 		eglDestroyImageKHR((EGLDisplay) display, (EGLImageKHR) dst->vinf.text.tag);
 		dst->vinf.text.tag = 0;
-		if (handle != dst->vinf.text.handle){
-			close(dst->vinf.text.handle);
-		}
 		dst->vinf.text.handle = -1;
 	}
 
@@ -587,7 +588,6 @@ bool platform_video_map_handle(struct agp_vstore* dst, int64_t handle)
 			"stride: %d, format: %d from %d\n", dst->w, dst->h,
 		 dst->vinf.text.stride, dst->vinf.text.format,handle
 		);
-		close(handle);
 		return false;
 	}
 
@@ -762,12 +762,15 @@ pollout:
 /* without the futex- based monitoring option we're still stuck going
  * with yield+sleep */
 		if (waiting){
+			unsigned long long start = arcan_timemillis();
 			int yv = arcan_conductor_yield(NULL, 0);
 			if (-1 == yv)
 				break;
 			else{
+/* the yield may have spent part of the budget on GC */
 				arcan_timesleep(yv);
-				left = left > yv ? left - yv : 0;
+				unsigned long long spent = arcan_timemillis() - start;
+				left = left > spent ? left - spent : 0;
 			}
 		}
 /* no relevant updates, no screens pending, just let the conductor wait */
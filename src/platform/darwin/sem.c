@@ -70,3 +70,16 @@ int arcan_sem_destroy(sem_handle sem)
 	int rv = sem_close(sem);
 	return rv;
 }
+
+/* no futexes here, callers fall back to the semaphores */
+int arcan_futex_wait(volatile _Atomic unsigned* addr, unsigned val, unsigned timeout)
+{
+	errno = ENOSYS;
+	return -1;
+}
+
+int arcan_futex_wake(volatile _Atomic unsigned* addr)
+{
+	errno = ENOSYS;
+	return -1;
+}
@@ -105,6 +105,9 @@ struct egl_env {
 	PFNEGLSWAPBUFFERSPROC swap_buffers;
 	PFNEGLSWAPINTERVALPROC swap_interval;
 	PFNEGLGETCONFIGATTRIBPROC get_config_attrib;
+
+/* optional, only set if the display has swap_buffers_with_damage (KHR/EXT) */
+	PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_buffers_damage;
 };
 
 static void map_eglext_functions(struct egl_env* denv,
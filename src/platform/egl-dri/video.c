@@ -261,6 +261,11 @@ struct dispout {
 	bool disallow_rtproxy;
 	bool skip_blit;
 	size_t dispw, disph, dispx, dispy;
+
+/* region (lower-left origin) that changed in the last drawn frame, forwarded
+ * on swap if the EGL implementation supports it */
+	struct agp_region damage;
+	bool damage_valid;
 	float vrefresh;
 
 	_Alignas(16) float projection[16];
@@ -1631,6 +1636,20 @@ static bool setup_node(struct dev_node* node)
 		return false;
 	}
 
+/* the damage on swap is just a hint, the KHR and EXT versions are identical */
+	const char* extstr =
+		node->eglenv.query_string(node->display, EGL_EXTENSIONS);
+	node->eglenv.swap_buffers_damage = NULL;
+
+	if (extstr && node->eglenv.get_proc_address){
+		if (check_ext("EGL_KHR_swap_buffers_with_damage", extstr))
+			node->eglenv.swap_buffers_damage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)
+				node->eglenv.get_proc_address("eglSwapBuffersWithDamageKHR");
+		else if (check_ext("EGL_EXT_swap_buffers_with_damage", extstr))
+			node->eglenv.swap_buffers_damage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)
+				node->eglenv.get_proc_address("eglSwapBuffersWithDamageEXT");
+	}
+
 /*
  * make sure the API we've selected match the AGP platform
  */
@@ -2600,6 +2619,79 @@ drop_disp:
 	return -1;
 }
 
+/*
+ * Clients that pass one persistent handle per video buffer rotate between
+ * them, so the imports are kept and a switch only rebinds the texture. The
+ * engine owns the descriptors and calls map_handle(-1) before importing a new
+ * set, as a new descriptor may reuse the number of one that was imported.
+ */
+static struct gbm_import {
+	struct agp_vstore* dst;
+	int64_t handle;
+	EGLImageKHR img;
+}* gbm_imports;
+static size_t gbm_imports_sz;
+
+static void drop_imports(struct agp_vstore* dst)
+{
+	for (size_t i = 0; i < gbm_imports_sz; i++){
+		if (gbm_imports[i].dst != dst)
+			continue;
+
+		nodes[0].eglenv.destroy_image(nodes[0].display, gbm_imports[i].img);
+		gbm_imports[i].dst = NULL;
+	}
+
+	dst->vinf.text.tag = 0;
+	dst->vinf.text.handle = -1;
+}
+
+static EGLImageKHR find_import(struct agp_vstore* dst, int64_t handle)
+{
+	for (size_t i = 0; i < gbm_imports_sz; i++)
+		if (gbm_imports[i].dst == dst && gbm_imports[i].handle == handle)
+			return gbm_imports[i].img;
+
+	return EGL_NO_IMAGE_KHR;
+}
+
+/* when full, evict any import that isn't the one currently sampled, and if
+ * every entry is in use, grow the table - there is at most one such entry
+ * per store so this stays bounded */
+static bool add_import(
+	struct agp_vstore* dst, int64_t handle, EGLImageKHR img)
+{
+	size_t slot = gbm_imports_sz;
+	for (size_t i = 0; i < gbm_imports_sz; i++){
+		if (!gbm_imports[i].dst){
+			slot = i;
+			break;
+		}
+		if ((uintptr_t) gbm_imports[i].img != gbm_imports[i].dst->vinf.text.tag)
+			slot = i;
+	}
+
+	if (slot == gbm_imports_sz){
+		size_t new_sz = gbm_imports_sz ? gbm_imports_sz * 2 : 64;
+		struct gbm_import* new_imports =
+			realloc(gbm_imports, new_sz * sizeof(struct gbm_import));
+		if (!new_imports)
+			return false;
+
+		memset(&new_imports[gbm_imports_sz], '\0',
+			(new_sz - gbm_imports_sz) * sizeof(struct gbm_import));
+		gbm_imports = new_imports;
+		gbm_imports_sz = new_sz;
+	}
+	else if (gbm_imports[slot].dst)
+		nodes[0].eglenv.destroy_image(nodes[0].display, gbm_imports[slot].img);
+
+	gbm_imports[slot].dst = dst;
+	gbm_imports[slot].handle = handle;
+	gbm_imports[slot].img = img;
+	return true;
+}
+
 /* NOTE: this does not handle multiple planes correctly,
  * interface needs to carry both that, strides/offsets and designated-gpu +
  * modifiers */
@@ -2608,6 +2700,14 @@ static bool map_handle_gbm(struct agp_vstore* dst, int64_t handle)
 	if (!nodes[0].eglenv.create_image || !nodes[0].eglenv.image_target_texture2D)
 		return false;
 
+	if (-1 == handle){
+		drop_imports(dst);
+		return false;
+	}
+
+	if (0 != dst->vinf.text.tag && handle == dst->vinf.text.handle)
+		return true;
+
 	EGLint attrs[] = {
 		EGL_DMA_BUF_PLANE0_FD_EXT,
 		handle,
@@ -2631,43 +2731,32 @@ static bool map_handle_gbm(struct agp_vstore* dst, int64_t handle)
  * possibly source for crashes etc. and I see no good way for verifying the
  * buffer manually.
  */
-	if (0 != dst->vinf.text.tag){
-		nodes[0].eglenv.destroy_image(
-			nodes[0].display, (EGLImageKHR) dst->vinf.text.tag);
-		dst->vinf.text.tag = 0;
-
-/*
- * Usage note, this goes against what the spec says - but from what it seems
- * like in mesa, we leak one handle per connection without this, and if we
- * close every time, the driver live-locks.
- */
-		if (handle != dst->vinf.text.handle){
-			close(dst->vinf.text.handle);
-		}
-		dst->vinf.text.handle = -1;
-	}
-
-	if (-1 == handle)
-		return false;
+	EGLImageKHR img = find_import(dst, handle);
 
 /*
  * in addition, we actually need to know which render-node this
  * little bugger comes from, this approach is flawed for multi-gpu
  */
-	EGLImageKHR img = nodes[0].eglenv.create_image(
-		nodes[0].display,
-		EGL_NO_CONTEXT,
-		EGL_LINUX_DMA_BUF_EXT,
-		(EGLClientBuffer)NULL, attrs
-	);
-
 	if (img == EGL_NO_IMAGE_KHR){
-		debug_print("could not import EGL buffer (%zu * %zu), "
-			"stride: %d, format: %d from %d", dst->w, dst->h,
-		 dst->vinf.text.stride, dst->vinf.text.format,handle
+		img = nodes[0].eglenv.create_image(
+			nodes[0].display,
+			EGL_NO_CONTEXT,
+			EGL_LINUX_DMA_BUF_EXT,
+			(EGLClientBuffer)NULL, attrs
 		);
-		close(handle);
-		return false;
+
+		if (img == EGL_NO_IMAGE_KHR){
+			debug_print("could not import EGL buffer (%zu * %zu), "
+				"stride: %d, format: %d from %d", dst->w, dst->h,
+			 dst->vinf.text.stride, dst->vinf.text.format,handle
+			);
+			return false;
+		}
+
+		if (!add_import(dst, handle, img)){
+			nodes[0].eglenv.destroy_image(nodes[0].display, img);
+			return false;
+		}
 	}
 
 /* other option ?
@@ -4078,6 +4167,37 @@ static void drop_swapchain(struct dispout* d)
 	arcan_video_display.ignore_dirty += 3;
 }
 
+static void region_merge(struct agp_region* dst, struct agp_region* src)
+{
+	if (src->x2 <= src->x1 || src->y2 <= src->y1)
+		return;
+
+	dst->x1 = src->x1 < dst->x1 ? src->x1 : dst->x1;
+	dst->y1 = src->y1 < dst->y1 ? src->y1 : dst->y1;
+	dst->x2 = src->x2 > dst->x2 ? src->x2 : dst->x2;
+	dst->y2 = src->y2 > dst->y2 ? src->y2 : dst->y2;
+}
+
+/* last drawn cursor position in display coordinates, lower-left origin */
+static struct agp_region cursor_region(struct dispout* d)
+{
+	ssize_t x1 = arcan_video_display.cursor.ox;
+	ssize_t y1 = (ssize_t) d->disph -
+		(arcan_video_display.cursor.oy + arcan_video_display.cursor.h);
+	ssize_t x2 = x1 + arcan_video_display.cursor.w;
+	ssize_t y2 = y1 + arcan_video_display.cursor.h;
+
+	if (!arcan_video_display.cursor.vstore || x2 <= 0 || y2 <= 0)
+		return (struct agp_region){};
+
+	return (struct agp_region){
+		.x1 = x1 > 0 ? x1 : 0,
+		.y1 = y1 > 0 ? y1 : 0,
+		.x2 = x2 > (ssize_t) d->dispw ? d->dispw : x2,
+		.y2 = y2 > (ssize_t) d->disph ? d->disph : y2
+	};
+}
+
 static enum display_update_state draw_display(struct dispout* d)
 {
 	bool swap_display = true;
@@ -4128,11 +4248,21 @@ static enum display_update_state draw_display(struct dispout* d)
  *     the display as already drawn.
  */
 	struct rendertarget* newtgt = arcan_vint_findrt(vobj);
+	d->damage_valid = false;
+
 	if (newtgt){
 		size_t nd = agp_rendertarget_dirty(newtgt->art, NULL);
 		verbose_print("(%d) draw display, dirty regions: %zu", nd);
 		if (nd || newtgt->frame_cookie != d->frame_cookie){
-			agp_rendertarget_dirty_reset(newtgt->art, NULL);
+			struct agp_region dirty[nd ? nd : 1];
+			agp_rendertarget_dirty_reset(newtgt->art, dirty);
+
+/* the region is only usable as is if the blit is 1:1 */
+			d->damage = dirty[0];
+			d->damage_valid = nd && !d->skip_blit && d->hint == HINT_NONE &&
+				vobj->vstore == arcan_vint_world() && !vobj->txcos &&
+				!d->dispx && !d->dispy &&
+				d->dispw == vobj->vstore->w && d->disph == vobj->vstore->h;
 		}
 		else{
 			verbose_print("(%d) no dirty, skip");
@@ -4164,7 +4294,16 @@ static enum display_update_state draw_display(struct dispout* d)
 	 * than they are worth ..
 	 */
 	if (vobj->vstore == arcan_vint_world()){
+		struct agp_region ocur = cursor_region(d);
 		arcan_vint_drawcursor(false);
+
+/* the cursor is drawn on top of the blit, so both its old and its new
+ * position are part of the damage */
+		if (d->damage_valid){
+			struct agp_region ncur = cursor_region(d);
+			region_merge(&d->damage, &ocur);
+			region_merge(&d->damage, &ncur);
+		}
 	}
 
 	agp_deactivate_vstore();
@@ -4172,6 +4311,16 @@ static enum display_update_state draw_display(struct dispout* d)
 out:
 	if (swap_display){
 		verbose_print("(%d) pre-swap", (int)d->id);
+		if (d->damage_valid && d->device->eglenv.swap_buffers_damage){
+			EGLint rect[4] = {
+				d->damage.x1, d->damage.y1,
+				d->damage.x2 - d->damage.x1, d->damage.y2 - d->damage.y1
+			};
+			if (!d->device->eglenv.swap_buffers_damage(
+				d->device->display, d->buffer.esurf, rect, 1))
+				d->device->eglenv.swap_buffers(d->device->display, d->buffer.esurf);
+		}
+		else
 			d->device->eglenv.swap_buffers(d->device->display, d->buffer.esurf);
 		verbose_print("(%d) swapped", (int)d->id);
 		return UPDATE_FLIP;
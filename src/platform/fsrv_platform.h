@@ -54,7 +54,10 @@ struct arcan_frameserver* platform_fsrv_preset_server(
 
 /*
  * perform a resynchronization (resize) operation where negotiated buffer
- * buffer counts, formats and possible substructures are reset.
+ * buffer counts, formats and possible substructures are reset. [hints] is
+ * the copy of the page render hints that the caller has already looked at,
+ * the page field is not read again so a client can't flip it in between
+ * (e.g. to get an auth- token processed on a worker thread).
  *
  * returns:
  *-1 if the backing store was corrupted, couldn't be mapped or invalid,
@@ -62,7 +65,7 @@ struct arcan_frameserver* platform_fsrv_preset_server(
  * 1 - backing store was resized / remapped
  * 2 - subprotocol state was reset
  */
-int platform_fsrv_resynch(struct arcan_frameserver* src);
+int platform_fsrv_resynch(struct arcan_frameserver* src, int hints);
 
 /*
  * Allocate a new frameserver segment, bind it to the same process and
@@ -121,6 +124,13 @@ int platform_fsrv_socketauth(struct arcan_frameserver* src);
 void platform_fsrv_enter(struct arcan_frameserver*, jmp_buf ctx);
 void platform_fsrv_leave();
 
+/*
+ * Mark the calling thread as running jobs off the main thread. While set, a
+ * recovered fault in _enter/_leave only flags the frameserver as broken
+ * (staged.broken) and the main thread is left to drop it.
+ */
+void platform_fsrv_guard_defer(bool defer);
+
 /*
  * disconnect, clean up resources, free. The connection should be considered
  * alive (not just _alloc call) or it will return false. State of *src is
@@ -161,12 +171,55 @@ bool platform_fsrv_validchild(struct arcan_frameserver*);
  */
 int platform_fsrv_pushfd(struct arcan_frameserver*, struct arcan_event*, int);
 
+/*
+ * Pick the video buffer to consume next out of the ones the client has marked
+ * as pending. Buffers with a presentation timestamp past [deadline] are kept
+ * for a later pass and of the remaining ones, the most recent wins. Returns
+ * the buffer index or -1 if nothing is due yet. [vmask] is set to the mask
+ * that should be and:ed into vpending once the buffer has been consumed and
+ * [vpts] to the timestamp of the picked buffer. [latest] is set if the picked
+ * buffer is the one signalled last and no pending buffer was dropped, only
+ * then does the page-level dirty region describe the change.
+ */
+int platform_fsrv_vbuf_select(struct arcan_frameserver*,
+	uint64_t deadline, int* vmask, uint64_t* vpts, bool* latest);
+
+/*
+ * Wake a client that blocks on [vready] and/or [aready] (SHMIF_SIGVID and
+ * SHMIF_SIGAUD in [mask]) after the flag has been cleared. Depending on the
+ * synchronization mode picked when the segment was allocated, this is either
+ * a futex wake on the flag or a post on the matching semaphore.
+ */
+void platform_fsrv_wake(struct arcan_frameserver*, int mask);
+
+/*
+ * Retrieve a descriptor that becomes readable when the client has published
+ * a new buffer, or BADFD if there is none (semaphore synch or unsupported).
+ * The client end is handed over on the first call so this should only be
+ * used with an established connection. Read from it to reset.
+ */
+int platform_fsrv_synchfd(struct arcan_frameserver*);
+
+/*
+ * Close the server end of the synch bridge, e.g. on a read error. The client
+ * keeps working through the regular buffer release wakeups.
+ */
+void platform_fsrv_synchfd_drop(struct arcan_frameserver*);
+
 /*
  * Update the static / shared default audio buffer size that is provided if
  * the client doesn't request a specific one. Returns the previous value.
  */
 size_t platform_fsrv_default_abufsize(size_t new_sz);
 
+/*
+ * Update the number of event slots in each of the two queues that are set up
+ * for new segments, rounded up to a power of two, at least 16 and capped at
+ * PP_QUEUE_MAX.
+ * Existing segments keep theirs. Returns the previous value.
+ */
+size_t platform_fsrv_default_queuesz(size_t new_sz);
+
 /*
  * Update the number of permitted displays for frameservers that have been
  * given access to the color ramp subprotocol.
@@ -30,6 +30,15 @@ int arcan_sem_trywait(sem_handle sem);
 int arcan_sem_init(sem_handle*, unsigned value);
 int arcan_sem_destroy(sem_handle);
 
+/*
+ * Wait on / wake a 32-bit flag in shared memory. _wait blocks while
+ * [*addr == val] for at most [timeout] ms (0 for no timeout), and _wake
+ * releases all waiters on [addr]. On platforms without futexes, both return
+ * -1 with errno set to ENOSYS and the semaphores should be used instead.
+ */
+int arcan_futex_wait(volatile _Atomic unsigned* addr, unsigned val, unsigned timeout);
+int arcan_futex_wake(volatile _Atomic unsigned* addr);
+
 /*
  * Launch the specified program and bind its resources and control to the
  * returned frameserver instance (NULL if spawn was not possible for some
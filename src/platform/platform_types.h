@@ -184,10 +184,28 @@ enum storage_source {
 	STORAGE_TEXTARRAY
 };
 
+/*
+ * GPU block-compressed storage for static images, the raw buffer of a store
+ * in one of these formats holds the compressed blocks rather than av_pixels.
+ */
+enum agp_compression {
+	AGP_COMPRESS_NONE = 0,
+	AGP_COMPRESS_BC1,
+	AGP_COMPRESS_BC3
+};
+
 struct agp_vstore {
 	size_t refcount;
 	uint32_t update_ts;
 
+/* incremented on each content update, with the covered texels of the latest
+ * update if it only touched part of the store, used for damage tracking */
+	struct {
+		uint32_t seq;
+		bool partial;
+		size_t x1, y1, x2, y2;
+	} damage;
+
 	union {
 		struct {
 /* ID number connecting to AGP, this MAY be bound diretly to the glid
@@ -204,6 +222,7 @@ struct agp_vstore {
 			uint64_t s_fmt;
 			uint64_t d_fmt;
 			unsigned s_type;
+			enum agp_compression compression;
 
 /* may need to propagate vpts state */
 			uint64_t vpts;
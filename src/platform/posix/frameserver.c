@@ -27,6 +27,9 @@
 #include <sys/param.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
 
 #include <signal.h>
 #include <errno.h>
@@ -50,6 +53,26 @@
 
 static size_t default_abuf_sz = 512;
 static size_t default_disp_lim = 8;
+static size_t default_evq_sz = PP_QUEUE_SZ;
+
+/* -1 = not resolved yet, see use_futex */
+static int futex_synch = -1;
+
+/*
+ * Futex synch (release vready/aready through a futex wake on the flag rather
+ * than posting the semaphores) is the default where supported, the env is
+ * there to force the old behavior for comparison and debugging.
+ */
+static bool use_futex()
+{
+#ifdef __linux__
+	if (-1 == futex_synch)
+		futex_synch = getenv("ARCAN_SHMIF_SEMAPHORES") ? 0 : 1;
+	return futex_synch == 1;
+#else
+	return false;
+#endif
+}
 
 /*
  * Provide a size calculation for the specified subprotocol in the context of a
@@ -102,14 +125,16 @@ static void* nanny_thread(void* arg)
 }
 
 static size_t shmpage_size(size_t w, size_t h,
-	size_t vbufc, size_t abufc, int abufsz, size_t apad)
+	size_t vbufc, size_t abufc, int abufsz, size_t apad, size_t evq)
 {
 #ifdef ARCAN_SHMIF_OVERCOMMIT
 	return ARCAN_SHMPAGE_START_SZ;
 #else
 	return sizeof(struct arcan_shmif_page) + apad + 64 +
+		2 * evq * sizeof(struct arcan_event) +
 		abufc * abufsz + (abufc * 64) +
-		vbufc * w * h * sizeof(shmif_pixel) + (vbufc * 64);
+		vbufc * w * h * sizeof(shmif_pixel) + (vbufc * 64) +
+		vbufc * sizeof(struct arcan_shmif_damage);
 #endif
 }
 
@@ -208,6 +233,11 @@ bool platform_fsrv_destroy_local(arcan_frameserver* src)
 	sem_close(src->vsync);
 	sem_close(src->esync);
 
+	if (BADFD != src->synch_fd){
+		close(src->synch_fd);
+		src->synch_fd = BADFD;
+	}
+
 	struct arcan_shmif_page* shmpage = src->shm.ptr;
 
 	if (shmpage && -1 == munmap((void*) shmpage, src->shm.shmsize))
@@ -265,6 +295,11 @@ bool platform_fsrv_destroy(arcan_frameserver* src)
 		shmpage->aready = false;
 		arcan_sem_post( src->vsync );
 		arcan_sem_post( src->async );
+		if (shmpage->futex){
+			arcan_futex_wake(&shmpage->vready);
+			arcan_futex_wake(&shmpage->vpending);
+			arcan_futex_wake(&shmpage->aready);
+		}
 	}
 
 /* if BUS happens during _enter, the handler will take
@@ -321,6 +356,11 @@ void platform_fsrv_dropshared(arcan_frameserver* src)
 	sem_close(src->vsync);
 	sem_close(src->esync);
 
+	if (BADFD != src->synch_fd){
+		close(src->synch_fd);
+		src->synch_fd = BADFD;
+	}
+
 	struct arcan_shmif_page* shmpage = src->shm.ptr;
 
 	if (shmpage && -1 == munmap((void*) shmpage, src->shm.shmsize))
@@ -664,6 +704,12 @@ static bool shmalloc(arcan_frameserver* ctx,
 	if (0 == ctx->shm.shmsize)
 		ctx->shm.shmsize = ARCAN_SHMPAGE_START_SZ;
 
+/* the event rings need to fit regardless of the initial buffer sizes */
+	size_t evq_min = sizeof(struct arcan_shmif_page) +
+		2 * default_evq_sz * sizeof(struct arcan_event);
+	if (ctx->shm.shmsize < evq_min)
+		ctx->shm.shmsize = evq_min;
+
 	struct arcan_shmif_page* shmpage;
 	int shmfd = 0;
 
@@ -721,13 +767,24 @@ fail:
 		shmpage->major = ASHMIF_VERSION_MAJOR;
 		shmpage->minor = ASHMIF_VERSION_MINOR;
 		shmpage->segment_size = ctx->shm.shmsize;
+		shmpage->evqueue_sz = default_evq_sz;
 		shmpage->segment_token = ctx->cookie;
 		shmpage->cookie = arcan_shmif_cookie();
 		shmpage->vpending = 1;
 		shmpage->apending = 1;
+		shmpage->futex = use_futex();
 		ctx->shm.ptr = shmpage;
 	platform_fsrv_leave(ctx);
 
+/* the page copy of the ring size is for the client, ours stays here and is
+ * what setevqs / mapav get from now on */
+	ctx->inqueue.eventbuf_sz = ctx->outqueue.eventbuf_sz = default_evq_sz;
+
+#ifdef __linux__
+	if (shmpage->futex)
+		ctx->synch_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+
 	return true;
 }
 
@@ -739,6 +796,7 @@ struct arcan_frameserver* platform_fsrv_alloc()
 	res->watch_const = 0xfeed;
 
 	res->dpipe = BADFD;
+	res->synch_fd = BADFD;
 	res->queue_mask = EVENT_EXTERNAL;
 	res->playstate = ARCAN_PLAYING;
 	res->flags.alive = true;
@@ -746,6 +804,9 @@ struct arcan_frameserver* platform_fsrv_alloc()
 	res->parent.vid = ARCAN_EID;
 	res->desc.samplerate = ARCAN_SHMIF_SAMPLERATE;
 	res->vstream.handle = BADFD;
+	res->vstream.bound = BADFD;
+	for (size_t i = 0; i < ARCAN_SHMIF_VBUFC_LIM; i++)
+		res->vstream.slots[i] = BADFD;
 	res->sockmode = S_IRWXU;
 	res->child = BROKEN_PROCESS_HANDLE;
 
@@ -862,7 +923,8 @@ static bool prepare_segment(struct arcan_frameserver* ctx,
 		abufsz = 65535;
 	}
 
-	ctx->shm.shmsize = shmpage_size(hintw, hinth, 1, abufc, abufsz, 0);
+	ctx->shm.shmsize =
+		shmpage_size(hintw, hinth, 1, abufc, abufsz, 0, default_evq_sz);
 
 	if (!shmalloc(ctx, named, optkey, optdesc))
 		return NULL;
@@ -884,7 +946,7 @@ static bool prepare_segment(struct arcan_frameserver* ctx,
 		shmpage->abufsize = abufsz;
 		shmpage->apending = abufc;
 		shmpage->segment_size = arcan_shmif_mapav(shmpage,
-			ctx->vbufs, 1, hintw * hinth * sizeof(shmif_pixel),
+			ctx->inqueue.eventbuf_sz, ctx->vbufs, 1, arcan_shmif_vbufsz(0, hints, hintw, hinth, 0, 0),
 			ctx->abufs, abufc, abufsz
 		);
 	platform_fsrv_leave(ctx);
@@ -912,7 +974,7 @@ static bool prepare_segment(struct arcan_frameserver* ctx,
 	ctx->abuf_cnt = abufc;
 	ctx->abuf_sz = abufsz;
 	ctx->tag = tag;
-	arcan_shmif_setevqs(ctx->shm.ptr, ctx->esync,
+	arcan_shmif_setevqs(ctx->shm.ptr, ctx->inqueue.eventbuf_sz, ctx->esync,
 		&(ctx->inqueue), &(ctx->outqueue), true);
 	ctx->inqueue.synch.killswitch = (void*) ctx;
 	ctx->outqueue.synch.killswitch = (void*) ctx;
@@ -1025,6 +1087,92 @@ struct arcan_frameserver* platform_fsrv_spawn_subsegment(
 	return newseg;
 }
 
+int platform_fsrv_vbuf_select(struct arcan_frameserver* src,
+	uint64_t deadline, int* vmask, uint64_t* vpts, bool* latest)
+{
+	struct arcan_shmif_page* shmpage = src->shm.ptr;
+	size_t cnt = src->vbuf_cnt ? src->vbuf_cnt : 1;
+	int last = atomic_load_explicit(&shmpage->vready, memory_order_consume);
+	unsigned pending =
+		atomic_load_explicit(&shmpage->vpending, memory_order_consume);
+	unsigned newer = 0;
+
+	last = (last <= 0 || last > cnt) ? 0 : last - 1;
+	*vmask = ~pending;
+	*vpts = 0;
+
+/* walk from the most recent buffer towards the oldest one still pending, the
+ * first one that is due wins and everything older than that gets dropped */
+	for (size_t i = 0; i < cnt; i++){
+		size_t ind = (last + cnt - i) % cnt;
+		if (i && !(pending & (1 << ind)))
+			break;
+
+		uint64_t pts = atomic_load(&shmpage->vbuf_pts[ind]);
+		if (!pts || pts <= deadline){
+			*vmask = ~(pending & ~newer);
+			*vpts = pts;
+			*latest = !i && (pending & ~newer) == (1 << ind);
+			return ind;
+		}
+		newer |= 1 << ind;
+	}
+
+	return -1;
+}
+
+void platform_fsrv_wake(struct arcan_frameserver* src, int mask)
+{
+	struct arcan_shmif_page* shmpage = src->shm.ptr;
+	if (shmpage && shmpage->futex){
+		if (mask & SHMIF_SIGVID){
+			arcan_futex_wake(&shmpage->vready);
+			arcan_futex_wake(&shmpage->vpending);
+		}
+		if (mask & SHMIF_SIGAUD)
+			arcan_futex_wake(&shmpage->aready);
+		return;
+	}
+
+	if (mask & SHMIF_SIGVID)
+		arcan_sem_post(src->vsync);
+	if (mask & SHMIF_SIGAUD)
+		arcan_sem_post(src->async);
+}
+
+int platform_fsrv_synchfd(struct arcan_frameserver* src)
+{
+	if (BADFD == src->synch_fd)
+		return BADFD;
+
+/* the bridge is sent once, a client that doesn't understand it will just
+ * drop the descriptor and the server side will never become readable */
+	if (!src->flags.synch_sent){
+		if (ARCAN_OK != platform_fsrv_pushfd(src, &(struct arcan_event){
+			.category = EVENT_TARGET,
+			.tgt.kind = TARGET_COMMAND_DEVICE_NODE,
+			.tgt.ioevs[0].iv = src->synch_fd,
+			.tgt.ioevs[1].iv = 6
+		}, src->synch_fd)){
+			close(src->synch_fd);
+			src->synch_fd = BADFD;
+			return BADFD;
+		}
+		src->flags.synch_sent = true;
+	}
+
+	return src->synch_fd;
+}
+
+void platform_fsrv_synchfd_drop(struct arcan_frameserver* src)
+{
+	if (BADFD == src->synch_fd)
+		return;
+
+	close(src->synch_fd);
+	src->synch_fd = BADFD;
+}
+
 int platform_fsrv_pushevent(arcan_frameserver* dst, arcan_event* ev)
 {
 	if (!dst || !ev || !dst->outqueue.back)
@@ -1046,6 +1194,8 @@ int platform_fsrv_pushevent(arcan_frameserver* dst, arcan_event* ev)
 
 	struct arcan_evctx* ctx = &dst->outqueue;
 	if ( ((*ctx->back + 1) % ctx->eventbuf_sz) == *ctx->front){
+		dst->evstats.overflow++;
+		dst->evstats.dropped++;
 		platform_fsrv_leave();
 		return ARCAN_ERRC_OUT_OF_SPACE;
 	}
@@ -1251,6 +1401,20 @@ size_t platform_fsrv_default_abufsize(size_t new_sz)
 	return res;
 }
 
+size_t platform_fsrv_default_queuesz(size_t new_sz)
+{
+	size_t res = default_evq_sz;
+	if (new_sz){
+/* a ring needs a few slots beyond the one kept free or clients will block on
+ * enqueue, start from a floor that fits a burst of input */
+		size_t sz = 16;
+		while (sz < new_sz && sz < PP_QUEUE_MAX)
+			sz <<= 1;
+		default_evq_sz = sz;
+	}
+	return res;
+}
+
 size_t platform_fsrv_display_limit(size_t new_sz)
 {
 	size_t res = default_disp_lim;
@@ -1259,7 +1423,7 @@ size_t platform_fsrv_display_limit(size_t new_sz)
 	return res;
 }
 
-int platform_fsrv_resynch(struct arcan_frameserver* s)
+int platform_fsrv_resynch(struct arcan_frameserver* s, int hints)
 {
 	int state = 0;
 	struct shm_handle* src = &s->shm;
@@ -1306,10 +1470,14 @@ int platform_fsrv_resynch(struct arcan_frameserver* s)
 	if (samplerate)
 		s->desc.samplerate = samplerate;
 
+/* the rings stay where they are, but take the size from our end of the
+ * queue rather than trusting the shared copy */
+	size_t evq_sz = s->inqueue.eventbuf_sz;
+
 /* shrink number of video buffers if we don't fit */
 	size_t shmsz;
 	do{
-		shmsz = shmpage_size(w, h, vbufc, abufc, abufsz, apad_sz);
+		shmsz = shmpage_size(w, h, vbufc, abufc, abufsz, apad_sz, evq_sz);
 	} while (shmsz > ARCAN_SHMPAGE_MAX_SZ && vbufc-- > 1);
 
 /* initial sanity check */
@@ -1374,7 +1542,7 @@ int platform_fsrv_resynch(struct arcan_frameserver* s)
 	s->desc.height = h;
 	s->desc.rows = rows;
 	s->desc.cols = cols;
-	s->desc.pending_hints = atomic_load(&shmpage->hints);
+	s->desc.pending_hints = hints;
 	s->vbuf_cnt = vbufc;
 	s->abuf_cnt = abufc;
 
@@ -1397,16 +1565,19 @@ int platform_fsrv_resynch(struct arcan_frameserver* s)
 /* remap pointers, padding need to be updated first as shmif_mapav
  * uses that as a side-channel and we don't want to change the interface */
 	atomic_store(&shmpage->apad, apad_sz);
-	shmpage->segment_size = arcan_shmif_mapav(shmpage,
+	shmpage->evqueue_sz = evq_sz;
+	shmpage->segment_size = arcan_shmif_mapav(shmpage, evq_sz,
 		s->vbufs, s->vbuf_cnt, vbufsz, s->abufs, s->abuf_cnt, abufsz);
 	s->abuf_sz = abufsz;
-	arcan_shmif_setevqs(shmpage, s->esync, &(s->inqueue), &(s->outqueue), 1);
+	arcan_shmif_setevqs(shmpage,
+		evq_sz, s->esync, &(s->inqueue), &(s->outqueue), 1);
 
 /* commit to shared page */
 	shmpage->resized = 0;
 	shmpage->abufsize = abufsz;
 	shmpage->apending = s->abuf_cnt;
 	shmpage->vpending = s->vbuf_cnt;
+	shmpage->vheld = 0;
 
 /* realize the sub-protocol */
 	if (reset_proto){
@@ -1462,7 +1633,7 @@ int platform_fsrv_prepare(struct arcan_frameserver* ctx, int* clsock)
 /* two separate queues for passing events back and forth between main program
  * and frameserver, set the buffer pointers to the relevant offsets in
  * backend_shmpage */
-	arcan_shmif_setevqs(ctx->shm.ptr,
+	arcan_shmif_setevqs(ctx->shm.ptr, ctx->inqueue.eventbuf_sz,
 		ctx->esync, &(ctx->inqueue), &(ctx->outqueue), true);
 	ctx->inqueue.synch.killswitch = (void*) ctx;
 	ctx->outqueue.synch.killswitch = (void*) ctx;
@@ -37,8 +37,11 @@
 #include <arcan_audio.h>
 #include <arcan_frameserver.h>
 
-static struct arcan_frameserver* tag;
-static sigjmp_buf recover;
+/* thread local as the upload stage can touch segments from worker threads,
+ * SIGBUS is delivered to the faulting thread so each gets its own recovery */
+static _Thread_local struct arcan_frameserver* tag;
+static _Thread_local sigjmp_buf recover;
+static _Thread_local bool defer;
 
 static void bus_handler(int signo)
 {
@@ -60,7 +63,10 @@ void platform_fsrv_enter(struct arcan_frameserver* m, jmp_buf out)
 
 	if (sigsetjmp(recover, 0)){
 		arcan_warning("(posix/fsrv_guard) DoS attempt from client.\n");
-		platform_fsrv_dropshared(tag);
+		if (defer)
+			tag->staged.broken = true;
+		else
+			platform_fsrv_dropshared(tag);
 		tag = NULL;
 		longjmp(out, -1);
 	}
@@ -72,3 +78,8 @@ void platform_fsrv_leave()
 {
 	tag = NULL;
 }
+
+void platform_fsrv_guard_defer(bool state)
+{
+	defer = state;
+}
@@ -9,6 +9,12 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
 #ifndef PLATFORM_HEADER
 #include "arcan_shmif.h"
 #else
@@ -47,3 +53,34 @@ int arcan_sem_destroy(sem_handle sem)
 {
 	return sem_destroy(sem);
 }
+
+/*
+ * The flags live in memory shared between processes so the _PRIVATE
+ * variants can't be used here.
+ */
+int arcan_futex_wait(volatile _Atomic unsigned* addr, unsigned val, unsigned timeout)
+{
+#ifdef __linux__
+	struct timespec ts = {
+		.tv_sec = timeout / 1000,
+		.tv_nsec = (timeout % 1000) * 1000000
+	};
+
+	return syscall(SYS_futex,
+		(unsigned*) addr, FUTEX_WAIT, val, timeout ? &ts : NULL, NULL, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+int arcan_futex_wake(volatile _Atomic unsigned* addr)
+{
+#ifdef __linux__
+	return syscall(SYS_futex,
+		(unsigned*) addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
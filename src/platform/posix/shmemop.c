@@ -1,7 +1,16 @@
 #include <stdint.h>
+#include <errno.h>
 #include "arcan_shmif.h"
 #include "../../shmif/tui/raster/raster_const.h"
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/udmabuf.h>
+#endif
+
 static inline void* alignv(uint8_t* inptr, size_t align_sz)
 {
 	return (void*) (((uintptr_t)inptr % align_sz != 0) ?
@@ -16,17 +25,90 @@ size_t arcan_shmif_vbufsz(
 			raster_hdr_sz * (rows * cols * raster_cell_sz) + (rows * raster_line_sz);
 		return sz;
 	}
-	else
-		return w * h * sizeof(shmif_pixel);
+
+/* the damage list footer follows the pixels in each buffer */
+	size_t sz = w * h * sizeof(shmif_pixel);
+	if ((hints & SHMIF_RHINT_SUBREGION) && !(hints & SHMIF_RHINT_TPACK))
+		sz += sizeof(struct arcan_shmif_damage);
+
+	return sz;
+}
+
+struct arcan_shmif_damage* arcan_shmif_damagebuf(
+	shmif_pixel* vbuf, uint8_t hints, size_t w, size_t h)
+{
+	if (!vbuf ||
+		!(hints & SHMIF_RHINT_SUBREGION) || (hints & SHMIF_RHINT_TPACK))
+		return NULL;
+
+	return (struct arcan_shmif_damage*) &vbuf[w * h];
+}
+
+int arcan_shmif_udmabuf(size_t* sz, int* dmabuf)
+{
+#ifdef __linux__
+	size_t page = sysconf(_SC_PAGESIZE);
+	*sz = (*sz + page - 1) / page * page;
+	*dmabuf = -1;
+
+	int dev = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+	if (-1 == dev)
+		return -1;
+
+/* the driver refuses memfds that can shrink (and pages vanish from under the
+ * importer) or that have their writes sealed */
+	int fd = memfd_create("shmif-vbuf", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (-1 == fd)
+		goto out;
+
+	if (-1 == ftruncate(fd, *sz) ||
+		-1 == fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL)){
+		close(fd);
+		fd = -1;
+		goto out;
+	}
+
+	struct udmabuf_create req = {
+		.memfd = fd,
+		.flags = UDMABUF_FLAGS_CLOEXEC,
+		.size = *sz
+	};
+
+	*dmabuf = ioctl(dev, UDMABUF_CREATE, &req);
+	if (-1 == *dmabuf){
+		close(fd);
+		fd = -1;
+	}
+
+out:
+	close(dev);
+	return fd;
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+struct arcan_event* arcan_shmif_evqueue(
+	struct arcan_shmif_page* addr, size_t evq_sz, bool parentq)
+{
+	uint8_t* base = (uint8_t*)addr + sizeof(struct arcan_shmif_page);
+	if (parentq)
+		base += evq_sz * sizeof(struct arcan_event);
+
+	return (struct arcan_event*) base;
 }
 
 uintptr_t arcan_shmif_mapav(
-	struct arcan_shmif_page* addr,
+	struct arcan_shmif_page* addr, size_t evq_sz,
 	shmif_pixel* vbuf[], size_t vbufc, size_t vbuf_sz,
 	shmif_asample* abuf[], size_t abufc, size_t abuf_sz)
 {
 /* now we are in bat county */
 	uint8_t* wbuf = (uint8_t*)addr + sizeof(struct arcan_shmif_page);
+	if (addr)
+		wbuf += 2 * evq_sz * sizeof(struct arcan_event);
+
 	if (addr && vbuf)
 		wbuf += addr->apad;
 
@@ -2,6 +2,8 @@
  * No copyright claimed, Public Domain
  */
 
+#include <stdbool.h>
+
 struct arcan_frameserver;
 int platform_fsrv_enter(struct arcan_frameserver* m)
 {
@@ -11,3 +13,7 @@ int platform_fsrv_enter(struct arcan_frameserver* m)
 void platform_fsrv_leave()
 {
 }
+
+void platform_fsrv_guard_defer(bool defer)
+{
+}
@@ -148,6 +148,22 @@ struct shmif_hidden {
 	uint8_t vbuf_ind, vbuf_cnt;
 	shmif_pixel* vbuf[ARCAN_SHMIF_VBUFC_LIM];
 
+/* hints the video buffers were mapped with, decides if there is a footer, and
+ * the regions accumulated through _dirty since the last signal */
+	uint8_t vbuf_hints;
+	size_t n_damage;
+	struct arcan_shmif_region damage[ARCAN_SHMIF_DAMAGE_LIM];
+
+/* ARCAN_SHMIF_UDMABUF, each video buffer is a memfd that is passed once per
+ * (re-)allocation as a dma-buf rather than copied through the shared page */
+	struct {
+		bool wanted, pending, failed;
+		size_t sz, count;
+		int memfd[ARCAN_SHMIF_VBUFC_LIM];
+		int dmabuf[ARCAN_SHMIF_VBUFC_LIM];
+		shmif_pixel* buf[ARCAN_SHMIF_VBUFC_LIM];
+	} udma;
+
 	shmif_trigger_hook audio_hook;
 	void* audio_hook_data;
 	uint8_t abuf_ind, abuf_cnt;
@@ -234,6 +250,10 @@ struct shmif_hidden {
 		char key[256];
 	} pseg;
 
+/* With futex synch, the server can provide an eventfd that we signal after
+ * publishing a buffer so that it has something to multiplex on */
+	file_handle synch_fd;
+
 /* The 'guard' structure is used by a separate monitoring thread that will
  * track a pid or descriptor for aliveness. If the tracking fails, it will
  * unlock semaphores and trigger an at_exit- like handler. This is practically
@@ -372,6 +392,30 @@ static bool fd_event(struct arcan_shmif_cont* c, struct arcan_event* dst)
 	return false;
 }
 
+/*
+ * the synch bridge is a descriptor event that is never forwarded, just take
+ * the descriptor (replacing any previous one) and reset the pending state
+ */
+static bool synch_event(struct arcan_shmif_cont* c)
+{
+	struct arcan_event* ev = &c->priv->pev.ev;
+	if (ev->category != EVENT_TARGET ||
+		ev->tgt.kind != TARGET_COMMAND_DEVICE_NODE || ev->tgt.ioevs[1].iv != 6)
+		return false;
+
+	if (BADFD != c->priv->synch_fd)
+		close(c->priv->synch_fd);
+
+	c->priv->synch_fd = c->priv->pev.fd;
+	c->priv->pev.fd = BADFD;
+	c->priv->pev.gotev = false;
+	c->priv->pev.consumed = false;
+	c->priv->pev.ev = (struct arcan_event){0};
+	debug_print(DETAILED, c, "synch bridge: %d", c->priv->synch_fd);
+
+	return true;
+}
+
 #ifdef SHMIF_DEBUG_IF
 #include "arcan_shmif_debugif.h"
 #endif
@@ -495,11 +539,64 @@ static void reset_dirty(struct arcan_shmif_cont* ctx)
 	ctx->dirty.y2 = ctx->dirty.x2 = 0;
 	ctx->dirty.y1 = ctx->h;
 	ctx->dirty.x1 = ctx->w;
+	ctx->priv->n_damage = 0;
+}
+
+static size_t region_area(struct arcan_shmif_region r)
+{
+	return (size_t)(r.x2 - r.x1) * (size_t)(r.y2 - r.y1);
+}
+
+static struct arcan_shmif_region region_union(
+	struct arcan_shmif_region a, struct arcan_shmif_region b)
+{
+	return (struct arcan_shmif_region){
+		.x1 = a.x1 < b.x1 ? a.x1 : b.x1,
+		.y1 = a.y1 < b.y1 ? a.y1 : b.y1,
+		.x2 = a.x2 > b.x2 ? a.x2 : b.x2,
+		.y2 = a.y2 > b.y2 ? a.y2 : b.y2
+	};
+}
+
+/* add to the damage list, regions that are covered by another are dropped,
+ * and when the list is full the new region is merged into the one where the
+ * union grows the least - overlap only costs some redundant upload */
+static void add_damage(struct shmif_hidden* priv, struct arcan_shmif_region r)
+{
+	for (size_t i = 0; i < priv->n_damage; i++){
+		struct arcan_shmif_region* cur = &priv->damage[i];
+		if (r.x1 >= cur->x1 && r.x2 <= cur->x2 && r.y1 >= cur->y1 && r.y2 <= cur->y2)
+			return;
+
+		if (cur->x1 >= r.x1 && cur->x2 <= r.x2 && cur->y1 >= r.y1 && cur->y2 <= r.y2){
+			*cur = r;
+			return;
+		}
+	}
+
+	if (priv->n_damage < ARCAN_SHMIF_DAMAGE_LIM){
+		priv->damage[priv->n_damage++] = r;
+		return;
+	}
+
+	size_t best = 0;
+	size_t best_cost = SIZE_MAX;
+	for (size_t i = 0; i < priv->n_damage; i++){
+		size_t cost = region_area(region_union(priv->damage[i], r)) -
+			region_area(priv->damage[i]);
+
+		if (cost < best_cost){
+			best = i;
+			best_cost = cost;
+		}
+	}
+
+	priv->damage[best] = region_union(priv->damage[best], r);
 }
 
 static bool scan_disp_event(struct arcan_evctx* c, struct arcan_event* old)
 {
-	uint8_t cur = *c->front;
+	uint16_t cur = *c->front;
 
 	while (cur != *c->back){
 		struct arcan_event* ev = &c->eventbuf[cur];
@@ -747,6 +844,9 @@ checkfd:
 			}
 
 			if (priv->pev.fd != BADFD){
+				if (synch_event(c))
+					goto reset;
+
 				if (fd_event(c, dst) && priv->autoclean){
 					priv->autoclean = false;
 					consume(c);
@@ -823,6 +923,8 @@ checkfd:
  * dependency to shmifext which in turn pulls in GL libraries and so on. */
 				debug_print(INFO, c, "buffer-fail, accelerated handle passing rejected");
 				c->privext->state_fl = STATE_NOACCEL;
+				if (priv->udma.count)
+					priv->udma.failed = true;
 				goto reset;
 			break;
 
@@ -882,6 +984,11 @@ checkfd:
 					goto reset;
 				}
 /* event that request us to switch connection point */
+				else if (iev == 6){
+					priv->pev.gotev = true;
+					priv->pev.ev = *dst;
+					goto checkfd;
+				}
 				else if (iev >= 1 && iev <= 3){
 					if (dst->tgt.message[0] == '\0'){
 						priv->pev.gotev = true;
@@ -1147,6 +1254,84 @@ int arcan_shmif_tryenqueue(
 	return arcan_shmif_enqueue(c, src);
 }
 
+size_t arcan_shmif_enqueue_batch(struct arcan_shmif_cont* c,
+	const struct arcan_event* const evs, size_t n)
+{
+	assert(c);
+	if (!c || !evs || !c->addr || !c->priv)
+		return 0;
+
+	if (!check_dms(c)){
+		fallback_migrate(c, c->priv->alt_conn, true);
+		return 0;
+	}
+
+	if (c->priv->log_event){
+		for (size_t i = 0; i < n; i++){
+			struct arcan_event outev = evs[i];
+			log_print("(@%"PRIxPTR"->)%s",
+				(uintptr_t) c, arcan_shmif_eventstr(&outev, NULL, 0));
+		}
+	}
+
+	struct arcan_evctx* ctx = &c->priv->outev;
+	if (c->priv->paused){
+		struct arcan_event ev;
+		process_events(c, &ev, true, true);
+	}
+
+#ifdef ARCAN_SHMIF_THREADSAFE_QUEUE
+	pthread_mutex_lock(&ctx->synch.lock);
+#endif
+
+	size_t ofs = 0;
+	while (ofs < n && check_dms(c)){
+		size_t back = *ctx->back;
+		size_t front = *ctx->front;
+		size_t room = front > back ?
+			front - back - 1 : ctx->eventbuf_sz - back + front - 1;
+
+/* same as the single enqueue, wait for the server to make room */
+		if (!room){
+			debug_print(STATUS, c, "=> batch: outqueue is full, waiting");
+			arcan_sem_wait(ctx->synch.handle);
+			continue;
+		}
+
+/* free space is at most two contiguous spans, copy and fix up in place */
+		size_t count = n - ofs > room ? room : n - ofs;
+		size_t span = ctx->eventbuf_sz - back;
+		span = span > count ? count : span;
+
+		memcpy(&ctx->eventbuf[back], &evs[ofs], span * sizeof(arcan_event));
+		if (count > span)
+			memcpy(ctx->eventbuf, &evs[ofs + span], (count - span) * sizeof(arcan_event));
+
+		for (size_t i = 0; i < count; i++){
+			struct arcan_event* ev = &ctx->eventbuf[(back + i) % ctx->eventbuf_sz];
+			if (!ev->category)
+				ev->category = EVENT_EXTERNAL;
+
+			if (ev->category == EVENT_EXTERNAL &&
+				ev->ext.kind == ARCAN_EVENT(REGISTER) &&
+				(ev->ext.registr.guid[0] || ev->ext.registr.guid[1])){
+				c->priv->guid[0] = ev->ext.registr.guid[0];
+				c->priv->guid[1] = ev->ext.registr.guid[1];
+			}
+		}
+
+		FORCE_SYNCH();
+		*ctx->back = (back + count) % ctx->eventbuf_sz;
+		ofs += count;
+	}
+
+#ifdef ARCAN_SHMIF_THREADSAFE_QUEUE
+	pthread_mutex_unlock(&ctx->synch.lock);
+#endif
+
+	return ofs;
+}
+
 static void unlink_keyed(const char* key)
 {
 	shm_unlink(key);
@@ -1210,15 +1395,26 @@ map_fail:
 	}
 
 /* parent suggested a different size from the start, need to remap */
+	size_t sz = ARCAN_SHMPAGE_START_SZ;
 	if (dst->addr->segment_size != (size_t) ARCAN_SHMPAGE_START_SZ){
 		debug_print(STATUS, dst, "different initial size, remapping.");
-		size_t sz = dst->addr->segment_size;
+		sz = dst->addr->segment_size;
 		munmap(dst->addr, ARCAN_SHMPAGE_START_SZ);
 		dst->addr = mmap(NULL, sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
 		if (MAP_FAILED == dst->addr)
 			goto map_fail;
 	}
 
+/* the event rings follow the page, make sure they are sane and fit */
+	size_t evq = dst->addr->evqueue_sz;
+	if (!evq || evq > PP_QUEUE_MAX || (evq & (evq - 1)) ||
+		sizeof(struct arcan_shmif_page) + 2 * evq * sizeof(struct arcan_event) > sz){
+		debug_print(FATAL, dst, "invalid event queue size: %zu", evq);
+		munmap(dst->addr, sz);
+		errno = EINVAL;
+		goto map_fail;
+	}
+
 	debug_print(STATUS, dst, "segment mapped to %" PRIxPTR, (uintptr_t) dst->addr);
 
 /* step 2, semaphore handles */
@@ -1357,6 +1553,112 @@ end:
 	return res;
 }
 
+/* DRM_FORMAT_ARGB8888 / XRGB8888, matches the SHMIF_RGBA packing */
+#define SHMIF_FOURCC(a, b, c, d) ((uint32_t)(a) |\
+	((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+static void udma_drop(struct arcan_shmif_cont* ctx)
+{
+	struct shmif_hidden* priv = ctx->priv;
+	if (!priv->udma.count)
+		return;
+
+	for (size_t i = 0; i < priv->udma.count; i++){
+		munmap(priv->udma.buf[i], priv->udma.sz);
+		close(priv->udma.memfd[i]);
+		close(priv->udma.dmabuf[i]);
+		priv->udma.buf[i] = NULL;
+	}
+
+	priv->udma.count = 0;
+	priv->udma.pending = false;
+	ctx->vidp = priv->vbuf[priv->vbuf_ind];
+}
+
+/* Swap the video buffers for ones the server can sample directly, one per
+ * negotiated buffer. The server keeps sampling the last one presented until
+ * it switches to another (addr->vheld), so a single buffer could never be
+ * drawn into again and stays on the copy path. Partial updates would land in
+ * a buffer that is several frames old, so SUBREGION stays there as well. */
+static void udma_setup(struct arcan_shmif_cont* ctx)
+{
+	struct shmif_hidden* priv = ctx->priv;
+	udma_drop(ctx);
+
+	if (!priv->udma.wanted || !ctx->w || !ctx->h || priv->vbuf_cnt < 2 ||
+		(ctx->hints & (SHMIF_RHINT_TPACK | SHMIF_RHINT_SUBREGION)) ||
+		priv->type == SEGID_ENCODER || priv->type == SEGID_CLIPBOARD_PASTE)
+		return;
+
+	priv->udma.sz = ctx->w * ctx->h * sizeof(shmif_pixel);
+
+	for (size_t i = 0; i < priv->vbuf_cnt; i++){
+		int dmabuf;
+		int memfd = arcan_shmif_udmabuf(&priv->udma.sz, &dmabuf);
+		if (-1 == memfd){
+			debug_print(INFO, ctx, "udmabuf unavailable: %s", strerror(errno));
+			goto fail;
+		}
+
+		void* buf = mmap(NULL, priv->udma.sz,
+			PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+		if (MAP_FAILED == buf){
+			close(memfd);
+			close(dmabuf);
+			goto fail;
+		}
+
+		priv->udma.memfd[i] = memfd;
+		priv->udma.dmabuf[i] = dmabuf;
+		priv->udma.buf[i] = buf;
+		priv->udma.count++;
+	}
+
+	priv->udma.pending = true;
+	ctx->vidp = priv->udma.buf[priv->vbuf_ind];
+	return;
+
+fail:
+	udma_drop(ctx);
+	priv->udma.wanted = false;
+}
+
+/* The server rejected the import, carry the frame over to the shared page and
+ * go back to the copy path for good. Otherwise hand over the new set, each
+ * buffer tagged with its index so the server can keep one import per buffer
+ * and pick it from vready. */
+static void udma_step(struct arcan_shmif_cont* ctx)
+{
+	struct shmif_hidden* priv = ctx->priv;
+
+	if (priv->udma.failed){
+		memcpy(priv->vbuf[priv->vbuf_ind], priv->udma.buf[priv->vbuf_ind],
+			ctx->w * ctx->h * sizeof(shmif_pixel));
+		udma_drop(ctx);
+		priv->udma.wanted = priv->udma.failed = false;
+		return;
+	}
+
+	if (!priv->udma.pending)
+		return;
+
+/* a partial set is retried from the start, slot 1 resets it on the server */
+	for (size_t i = 0; i < priv->udma.count; i++){
+		if (!arcan_pushhandle(priv->udma.dmabuf[i], ctx->epipe))
+			return;
+
+		arcan_shmif_enqueue(ctx, &(struct arcan_event){
+			.category = EVENT_EXTERNAL,
+			.ext.kind = EVENT_EXTERNAL_BUFFERSTREAM,
+			.ext.bstream.pitch = ctx->stride,
+			.ext.bstream.format = (ctx->hints & SHMIF_RHINT_IGNORE_ALPHA) ?
+				SHMIF_FOURCC('X', 'R', '2', '4') : SHMIF_FOURCC('A', 'R', '2', '4'),
+			.ext.bstream.slot = i + 1
+		});
+	}
+	priv->udma.pending = false;
+}
+
 static void setup_avbuf(struct arcan_shmif_cont* res)
 {
 /* flush out dangling buffers */
@@ -1387,13 +1689,14 @@ static void setup_avbuf(struct arcan_shmif_cont* res)
 
 /* the buffer limit size needs to take the rhint into account, but only
  * if we have a known cell size as that is the primitive for calculation */
+	res->priv->vbuf_hints = res->hints;
 	res->vbufsize = arcan_shmif_vbufsz(
 		res->priv->atype, res->hints, res->w, res->h,
 		atomic_load(&res->addr->rows),
 		atomic_load(&res->addr->cols)
 	);
 
-	arcan_shmif_mapav(res->addr,
+	arcan_shmif_mapav(res->addr, res->priv->inev.eventbuf_sz,
 		res->priv->vbuf, res->priv->vbuf_cnt, res->vbufsize,
 		res->priv->abuf, res->priv->abuf_cnt, res->abufsize
 	);
@@ -1404,6 +1707,7 @@ static void setup_avbuf(struct arcan_shmif_cont* res)
  */
 	res->vidp = res->priv->vbuf[0];
 	res->audp = res->priv->abuf[0];
+	udma_setup(res);
 }
 
 /* using a base address where the meta structure will reside, allocate n- audio
@@ -1474,6 +1778,7 @@ static struct arcan_shmif_cont shmif_acquire_int(
 		.flags = flags,
 		.pev = {.fd = BADFD},
 		.pseg = {.epipe = BADFD},
+		.synch_fd = BADFD
 	};
 
 	atomic_store(&gs.guard.dms, (uint8_t*) &res.addr->dms);
@@ -1494,6 +1799,7 @@ static struct arcan_shmif_cont shmif_acquire_int(
 	char* dbgenv = getenv("ARCAN_SHMIF_DEBUG");
 	if (dbgenv)
 		res.priv->log_event = strtoul(dbgenv, NULL, 10);
+	res.priv->udma.wanted = getenv("ARCAN_SHMIF_UDMABUF") != NULL;
 
 	if (!(flags & SHMIF_DISABLE_GUARD))
 		spawn_guardthread(&res);
@@ -1515,7 +1821,7 @@ static struct arcan_shmif_cont shmif_acquire_int(
 		consume(parent);
 	}
 
-	arcan_shmif_setevqs(res.addr, res.esem,
+	arcan_shmif_setevqs(res.addr, res.addr->evqueue_sz, res.esem,
 		&res.priv->inev, &res.priv->outev, false);
 
 	if (0 != type && !(flags & SHMIF_NOREGISTER)) {
@@ -1632,7 +1938,7 @@ bool arcan_shmif_integrity_check(struct arcan_shmif_cont* cont)
 	return true;
 }
 
-void arcan_shmif_setevqs(struct arcan_shmif_page* dst,
+void arcan_shmif_setevqs(struct arcan_shmif_page* dst, size_t evq_sz,
 	sem_handle esem, arcan_evctx* inq, arcan_evctx* outq, bool parent)
 {
 	if (parent){
@@ -1665,21 +1971,27 @@ void arcan_shmif_setevqs(struct arcan_shmif_page* dst,
 #endif
 
 	inq->local = false;
-	inq->eventbuf = dst->childevq.evqueue;
+	inq->eventbuf = arcan_shmif_evqueue(dst, evq_sz, false);
 	inq->front = &dst->childevq.front;
 	inq->back  = &dst->childevq.back;
-	inq->eventbuf_sz = PP_QUEUE_SZ;
+	inq->eventbuf_sz = evq_sz;
 
 	outq->local =false;
-	outq->eventbuf = dst->parentevq.evqueue;
+	outq->eventbuf = arcan_shmif_evqueue(dst, evq_sz, true);
 	outq->front = &dst->parentevq.front;
 	outq->back  = &dst->parentevq.back;
-	outq->eventbuf_sz = PP_QUEUE_SZ;
+	outq->eventbuf_sz = evq_sz;
 }
 
 unsigned arcan_shmif_signalhandle(struct arcan_shmif_cont* ctx,
 	int mask, int handle, size_t stride, int format, ...)
 {
+/* the caller provides its own buffers, so ours would just compete */
+	if (ctx->priv->udma.wanted){
+		udma_drop(ctx);
+		ctx->priv->udma.wanted = false;
+	}
+
 	if (!arcan_pushhandle(handle, ctx->epipe))
 		return 0;
 
@@ -1693,23 +2005,94 @@ unsigned arcan_shmif_signalhandle(struct arcan_shmif_cont* ctx,
 	return arcan_shmif_signal(ctx, mask);
 }
 
+/*
+ * Block until the server has released [flag] (vready / aready). If the server
+ * has enabled futex synch, wait on the flag itself, otherwise on the matching
+ * semaphore. The futex wait has a timeout so that a dms change that races
+ * the wait is still picked up.
+ */
+static void wait_flag(struct arcan_shmif_cont* ctx,
+	volatile atomic_uint* flag, sem_handle sem)
+{
+	unsigned val;
+	while ((val = atomic_load(flag)) && check_dms(ctx)){
+		if (ctx->addr->futex)
+			arcan_futex_wait(flag, val, 100);
+		else
+			arcan_sem_wait(sem);
+	}
+}
+
+/*
+ * Block until the server has released video buffer [ind]. With timestamped
+ * buffers queued the server can free some of them without clearing vready,
+ * so the wait is on the pending bit and not on the flag, the futex wake is
+ * issued on both. A buffer the server still samples from (vheld) stays busy
+ * until a newer one is presented, which clears that one's pending bit.
+ */
+static void wait_vbuf(struct arcan_shmif_cont* ctx, size_t ind)
+{
+	unsigned val;
+	while (((((val = atomic_load(&ctx->addr->vpending)) & (1 << ind)) &&
+		atomic_load(&ctx->addr->vready)) ||
+		atomic_load(&ctx->addr->vheld) == ind + 1) && check_dms(ctx)){
+		if (ctx->addr->futex)
+			arcan_futex_wait(&ctx->addr->vpending, val, 100);
+		else
+			arcan_sem_wait(ctx->vsem);
+	}
+}
+
+/* let a multiplexing server know that there is a new buffer to pick up */
+static void notify_synch(struct arcan_shmif_cont* ctx)
+{
+	if (BADFD == ctx->priv->synch_fd)
+		return;
+
+	uint64_t val = 1;
+	if (-1 == write(ctx->priv->synch_fd, &val, sizeof(val)) && errno != EAGAIN){
+		close(ctx->priv->synch_fd);
+		ctx->priv->synch_fd = BADFD;
+	}
+}
+
 static bool step_v(struct arcan_shmif_cont* ctx)
 {
 	struct shmif_hidden* priv = ctx->priv;
 	bool lock = false;
 
+	if (priv->udma.count)
+		udma_step(ctx);
+
 /* store the current hint flags, could do away with this stage by
  * only changing hints at resize_ stage */
 	atomic_store(&ctx->addr->hints, ctx->hints);
 
-/* subregion is part of the shared block and not the video buffer
- * itself. this is a design flaw that should be moved into a
- * VBI- style post-buffer footer */
+/* the bounding region is part of the shared block, the individual regions
+ * go into the footer of the buffer that is about to be released. If the
+ * caller has set the bounding region directly, that becomes the list. */
 	if (ctx->hints & SHMIF_RHINT_SUBREGION){
 		atomic_store(&ctx->addr->dirty, ctx->dirty);
+		struct arcan_shmif_damage* dmg = arcan_shmif_damagebuf(
+			priv->vbuf[priv->vbuf_ind], priv->vbuf_hints, ctx->w, ctx->h);
+
+		if (dmg){
+			if (!priv->n_damage &&
+				ctx->dirty.x2 > ctx->dirty.x1 && ctx->dirty.y2 > ctx->dirty.y1)
+				add_damage(priv, ctx->dirty);
+
+			memcpy(dmg->rects, priv->damage,
+				priv->n_damage * sizeof(struct arcan_shmif_region));
+			dmg->count = priv->n_damage;
+		}
 		reset_dirty(ctx);
 	}
 
+/* the timestamp needs to be in place before the buffer is marked */
+	atomic_store_explicit(&ctx->addr->vbuf_pts[priv->vbuf_ind],
+		ctx->vpts, memory_order_release);
+	ctx->vpts = 0;
+
 /* mark the current buffer as pending, this is used when we have
  * non-subregion + (double, triple, quadruple buffer) rendering */
 	int pending = atomic_fetch_or_explicit(
@@ -1724,8 +2107,10 @@ static bool step_v(struct arcan_shmif_cont* ctx)
 		priv->vbuf_ind = 0;
 
 /* note if we need to wait for an ack before continuing */
-	lock = priv->vbuf_cnt == 1 || (pending & (1 << priv->vbuf_ind));
-	ctx->vidp = priv->vbuf[priv->vbuf_ind];
+	lock = priv->vbuf_cnt == 1 || (pending & (1 << priv->vbuf_ind)) ||
+		atomic_load(&ctx->addr->vheld) == priv->vbuf_ind + 1;
+	ctx->vidp = priv->udma.count ?
+		priv->udma.buf[priv->vbuf_ind] : priv->vbuf[priv->vbuf_ind];
 
 /* protect against reordering, like not needed after atomic- switch */
 	FORCE_SYNCH();
@@ -1798,11 +2183,16 @@ unsigned arcan_shmif_signal(
 
 	if ( mask & SHMIF_SIGAUD ){
 		bool lock = step_a(ctx);
+		notify_synch(ctx);
 
 /* guard-thread will pull the sems for us on dms */
-		if (lock && !(mask & SHMIF_SIGBLK_NONE))
-			arcan_sem_wait(ctx->asem);
-		else
+		if (lock && !(mask & SHMIF_SIGBLK_NONE)){
+			if (ctx->addr->futex)
+				wait_flag(ctx, &ctx->addr->aready, ctx->asem);
+			else
+				arcan_sem_wait(ctx->asem);
+		}
+		else if (!ctx->addr->futex)
 			arcan_sem_trywait(ctx->asem);
 	}
 /* for sub-region multi-buffer synch, we currently need to
@@ -1817,17 +2207,15 @@ unsigned arcan_shmif_signal(
 			);
 		}
 
-		while ((ctx->hints & SHMIF_RHINT_SUBREGION)
-			&& ctx->addr->vready && check_dms(ctx))
-			arcan_sem_wait(ctx->vsem);
+		if (ctx->hints & SHMIF_RHINT_SUBREGION)
+			wait_flag(ctx, &ctx->addr->vready, ctx->vsem);
 
 		bool lock = step_v(ctx);
+		notify_synch(ctx);
 
-		if (lock && !(mask & SHMIF_SIGBLK_NONE)){
-			while (ctx->addr->vready && check_dms(ctx))
-				arcan_sem_wait(ctx->vsem);
-		}
-		else
+		if (lock && !(mask & SHMIF_SIGBLK_NONE))
+			wait_vbuf(ctx, priv->vbuf_ind);
+		else if (!ctx->addr->futex)
 			arcan_sem_trywait(ctx->vsem);
 	}
 
@@ -1901,6 +2289,9 @@ void arcan_shmif_drop(struct arcan_shmif_cont* inctx)
 
 /* guard thread will clean up on its own */
 	free(inctx->priv->alt_conn);
+	if (BADFD != inctx->priv->synch_fd)
+		close(inctx->priv->synch_fd);
+	udma_drop(inctx);
 	if (inctx->privext->cleanup)
 		inctx->privext->cleanup(inctx);
 
@@ -1951,14 +2342,8 @@ static bool shmif_resize(struct arcan_shmif_cont* arg,
 	}
 
 /* wait for any outstanding v/asynch */
-	if (atomic_load(&arg->addr->vready)){
-		while (atomic_load(&arg->addr->vready) && check_dms(arg))
-			arcan_sem_wait(arg->vsem);
-	}
-	if (atomic_load(&arg->addr->aready)){
-		while (atomic_load(&arg->addr->aready) && check_dms(arg))
-			arcan_sem_wait(arg->asem);
-	}
+	wait_flag(arg, &arg->addr->vready, arg->vsem);
+	wait_flag(arg, &arg->addr->aready, arg->asem);
 
 	width = width < 1 ? 1 : width;
 	height = height < 1 ? 1 : height;
@@ -2067,7 +2452,7 @@ static bool shmif_resize(struct arcan_shmif_cont* arg,
 /*
  * make sure we start from the right buffer counts and positions
  */
-	arcan_shmif_setevqs(arg->addr,
+	arcan_shmif_setevqs(arg->addr, priv->inev.eventbuf_sz,
 		arg->esem, &priv->inev, &priv->outev, false);
 	setup_avbuf(arg);
 
@@ -2489,11 +2874,8 @@ enum shmif_migrate_status arcan_shmif_migrate(
 
 /* got a valid connection, first synch source segment so we don't have
  * anything pending */
-	while(atomic_load(&cont->addr->vready) && check_dms(cont))
-		arcan_sem_wait(cont->vsem);
-
-	while(atomic_load(&cont->addr->aready) && check_dms(cont))
-		arcan_sem_wait(cont->asem);
+	wait_flag(cont, &cont->addr->vready, cont->vsem);
+	wait_flag(cont, &cont->addr->aready, cont->asem);
 
 	size_t w = atomic_load(&cont->addr->w);
 	size_t h = atomic_load(&cont->addr->h);
@@ -2585,14 +2967,15 @@ enum shmif_migrate_status arcan_shmif_migrate(
 		ret.priv->guard.dms = &ret.addr->dms;
 
 /* need to recalculate the buffer pointers */
-		arcan_shmif_mapav(ret.addr, ret.priv->vbuf, ret.priv->vbuf_cnt,
-			ret.w * ret.h * sizeof(shmif_pixel), ret.priv->abuf, ret.priv->abuf_cnt,
-			ret.abufsize);
+		arcan_shmif_mapav(ret.addr, ret.priv->inev.eventbuf_sz,
+			ret.priv->vbuf, ret.priv->vbuf_cnt, ret.vbufsize,
+			ret.priv->abuf, ret.priv->abuf_cnt, ret.abufsize);
 
-		arcan_shmif_setevqs(ret.addr, ret.esem,
+		arcan_shmif_setevqs(ret.addr, ret.priv->inev.eventbuf_sz, ret.esem,
 		&ret.priv->inev, &ret.priv->outev, false);
 
-		ret.vidp = ret.priv->vbuf[0];
+		ret.vidp = ret.priv->udma.count ?
+			ret.priv->udma.buf[0] : ret.priv->vbuf[0];
 		ret.audp = ret.priv->abuf[0];
 	}
 	memcpy(cont, &ret, sizeof(struct arcan_shmif_cont));
@@ -3321,6 +3704,18 @@ int arcan_shmif_dirty(struct arcan_shmif_cont* cont,
 	if (y1 >= y2)
 		y1 = 0;
 
+	if (x2 > cont->w)
+		x2 = cont->w;
+
+	if (y2 > cont->h)
+		y2 = cont->h;
+
+/* track the region itself for the buffer footer */
+	if (x2 > x1 && y2 > y1)
+		add_damage(cont->priv, (struct arcan_shmif_region){
+			.x1 = x1, .y1 = y1, .x2 = x2, .y2 = y2
+		});
+
 /* grow to extents */
 	if (x1 < cont->dirty.x1)
 		cont->dirty.x1 = x1;
@@ -3349,6 +3744,7 @@ int arcan_shmif_dirty(struct arcan_shmif_cont* cont,
 		cont->dirty.x2 = cont->w;
 		cont->dirty.y1 = 0;
 		cont->dirty.y2 = cont->h;
+		cont->priv->n_damage = 0;
 	}
 	else if (getenv("ARCAN_SHMIF_DEBUG_DIRTY")){
 		shmif_pixel* buf = malloc(sizeof(shmif_pixel) *
@@ -69,12 +69,15 @@
  */
 
 /*
- * Define the reserved ring-buffer space used for input and output events
- * must be 0 < PP_QUEUE_SZ < 256
+ * Define the default ring-buffer space used for input and output events,
+ * the server picks the actual size when the segment is allocated. Must be
+ * a power of two, 0 < PP_QUEUE_SZ <= PP_QUEUE_MAX. One slot is always kept
+ * free to tell a full ring from an empty one.
  */
 #ifndef PP_QUEUE_SZ
-#define PP_QUEUE_SZ 127
+#define PP_QUEUE_SZ 128
 #endif
+#define PP_QUEUE_MAX 4096
 static const int ARCAN_SHMIF_QUEUE_SZ = PP_QUEUE_SZ;
 
 /*
@@ -109,7 +112,15 @@ static const int ARCAN_SHMIF_ACHANNELS = 2;
  * audiobuffer slot
  */
 #define ARCAN_SHMIF_ABUFC_LIM 12
-#define ARCAN_SHMIF_VBUFC_LIM 3
+#define ARCAN_SHMIF_VBUFC_LIM 8
+
+/*
+ * Number of damaged rectangles that can be forwarded with each video buffer
+ * in SHMIF_RHINT_SUBREGION mode, past this limit arcan_shmif_dirty will start
+ * coalescing. This is part of the buffer footer, so it affects ABI and any
+ * change needs a bump of ASHMIF_VERSION_MINOR.
+ */
+#define ARCAN_SHMIF_DAMAGE_LIM 16
 /*
  * These are technically limited by the combination of graphics and video
  * platforms. Since the buffers are placed at the end of the struct, they
@@ -418,10 +429,12 @@ struct arcan_shmif_cont arcan_shmif_acquire(
 /*
  * Used internally by _control etc. but also in ARCAN for mapping the
  * different buffer positions / pointers, very limited use outside those
- * contexts. Returns size: (end of last buffer) - addr
+ * contexts. [evq_sz] is the number of slots in each event ring, the caller
+ * provides it so that the server never has to read it back from the page.
+ * Returns size: (end of last buffer) - addr
  */
 uintptr_t arcan_shmif_mapav(
-	struct arcan_shmif_page* addr,
+	struct arcan_shmif_page* addr, size_t evq_sz,
 	shmif_pixel* vbuf[], size_t vbufc, size_t vbuf_sz,
 	shmif_asample* abuf[], size_t abufc, size_t abuf_sz
 );
@@ -435,6 +448,32 @@ uintptr_t arcan_shmif_mapav(
 size_t arcan_shmif_vbufsz(
 	int meta, uint8_t hints, size_t w, size_t h, size_t rows, size_t cols);
 
+/*
+ * Get the start of the event ring storage that follows the page, the child
+ * (server to client) queue or, with [parentq] set, the parent (client to
+ * server) one. Each ring has [evq_sz] slots, the server should pass its own
+ * copy of that size rather than [addr->evqueue_sz].
+ */
+struct arcan_event* arcan_shmif_evqueue(
+	struct arcan_shmif_page* addr, size_t evq_sz, bool parentq);
+
+/*
+ * Locate the damage list footer of a video buffer that was mapped with the
+ * specified [hints] and dimensions. Returns NULL if the buffer has no footer,
+ * i.e. SHMIF_RHINT_SUBREGION is not set or the contents is TPACKed. Like
+ * vbufsz this is used INTERNALLY on both sides of SHMIF.
+ */
+struct arcan_shmif_damage* arcan_shmif_damagebuf(
+	shmif_pixel* vbuf, uint8_t hints, size_t w, size_t h);
+
+/*
+ * Allocate a sealed memfd of at least [sz] bytes (rounded up to page size and
+ * written back) and convert it to a dma-buf through /dev/udmabuf, stored in
+ * [dmabuf]. Returns the memfd for mapping, or -1 if the platform or device is
+ * unavailable. Used INTERNALLY for the ARCAN_SHMIF_UDMABUF video path.
+ */
+int arcan_shmif_udmabuf(size_t* sz, int* dmabuf);
+
 /*
  * There can be one "post-flag, pre-semaphore" hook that will occur
  * before triggering a sigmask and can be used to synch audio to video
@@ -447,10 +486,10 @@ shmif_trigger_hook arcan_shmif_signalhook(struct arcan_shmif_cont*,
 
 /*
  * Using the specified shmpage state, synchronization semaphore handle,
- * construct two event-queue contexts. Parent- flag should be set
- * to false for frameservers
+ * construct two event-queue contexts with [evq_sz] slots each. Parent- flag
+ * should be set to false for frameservers
  */
-void arcan_shmif_setevqs(struct arcan_shmif_page*,
+void arcan_shmif_setevqs(struct arcan_shmif_page*, size_t evq_sz,
 	sem_handle, arcan_evctx* inevq, arcan_evctx* outevq, bool parent);
 
 /* resize/synchronization protocol to issue a resize of the output video buffer.
@@ -669,6 +708,17 @@ struct arcan_shmif_region {
 	uint16_t x1, x2, y1, y2;
 };
 
+/*
+ * In SHMIF_RHINT_SUBREGION mode, each video buffer is followed by this footer
+ * (VBI- style, see arcan_shmif_damagebuf) that carries the list of regions
+ * that were updated for the frame in that buffer. The [count] is reset every
+ * signal, and 0 means that only the bounding region in the page is valid.
+ */
+struct arcan_shmif_damage {
+	uint32_t count;
+	struct arcan_shmif_region rects[ARCAN_SHMIF_DAMAGE_LIM];
+};
+
 struct arcan_shmif_cont {
 	struct arcan_shmif_page* addr;
 
@@ -751,7 +801,7 @@ struct arcan_shmif_cont {
  *
  * SHMIF_RHINT_ORIGO_UL (or LL),
  * SHMIF_RHINT_IGNORE_ALPHA
- * SHMIF_RHINT_SUBREGION (only synch dirty region below)
+ * SHMIF_RHINT_SUBREGION (only synch dirty regions, see arcan_shmif_dirty)
  * SHMIF_RHINT_SUBREGION_CHAIN (reserved, not in use)
  * SHMIF_RHINT_CSPACE_SRGB (non-linear color space)
  * SHMIF_RHINT_AUTH_TOK
@@ -772,6 +822,9 @@ struct arcan_shmif_cont {
  * The [dx, dy] hints inside of the region indicates the number of pixels that
  * are scrolled based on the previously synched buffer.
  *
+ * This is the bounding box of the damage, the regions that are added through
+ * arcan_shmif_dirty are also forwarded individually in the buffer footer.
+ *
  * The dirty region is reset on either calls to arcan_shmif_signal (video)
  * or on shmif_resize calls that impose a size change.
  */
@@ -811,6 +864,16 @@ struct arcan_shmif_cont {
  * this field. This represents the size of a single video buffer.
  */
 	size_t vbufsize;
+
+/*
+ * Presentation timestamp (arcan_timemillis) for the contents of vidp, set
+ * before calling signal. The server will keep the buffer queued until the
+ * display synch closest to the timestamp and then drop any older ones that
+ * are still pending. 0 (default) presents as soon as possible. Reset on
+ * every SHMIF_SIGVID. Combine with a vbuf_cnt > 2 in resize_ext to queue
+ * frames ahead of time.
+ */
+	uint64_t vpts;
 };
 
 struct arcan_shmif_initial {
@@ -856,7 +919,8 @@ enum rhint_mask {
  * Indicate that only a smaller portion of the buffer actually needs to
  * be updated. It is still up to the server to decide what will actually
  * be synched however, as it may not have access to a cached backing store
- * in which to blit the subregion.
+ * in which to blit the subregion. Each video buffer is extended with a
+ * footer (struct arcan_shmif_damage) that carries the individual regions.
  */
 	SHMIF_RHINT_SUBREGION = 2,
 
@@ -943,11 +1007,19 @@ struct arcan_shmif_page {
  */
 	volatile uint8_t dms;
 
+/* [ARCAN-SET]
+ * Set at allocation if ARCAN releases [vready] and [aready] with a futex wake
+ * on the flags themselves instead of posting the v/a semaphores. Resize
+ * acknowledgements still go through the semaphores.
+ */
+	volatile uint8_t futex;
+
 /* [FSRV-SET, ARCAN-ACK(fl+sem)]
  * Set whenever a buffer is ready to be synchronized.
  * [vready-1] indicates the buffer index of the last set frame, while
  * vpending are the number of frames with contents that hasn't been
- * synchronzied.
+ * synchronzied. With timestamped buffers (see vbuf_pts) vready stays set
+ * until all the queued ones have been consumed.
  * [aready-1] indicates the starting index for buffers that have not
  * been synchronized, ring-buffer wrapping the bits that are set.
  */
@@ -989,10 +1061,16 @@ struct arcan_shmif_page {
  * Uses the event model provded in shmif/arcan_event and tightly couples
  * structure / event layout which introduces a number of implementation defined
  * constraints, making this interface a poor choice for a protocol.
+ *
+ * The ring storage itself follows the page structure (see
+ * arcan_shmif_evqueue), [evqueue_sz] slots for the child queue and then the
+ * same for the parent queue. [evqueue_sz] is set at allocation, is a power
+ * of two and never exceeds PP_QUEUE_MAX. It is only informative for the
+ * client, the server keeps its own copy.
  */
+	uint16_t evqueue_sz;
 	struct {
-		struct arcan_event evqueue[ PP_QUEUE_SZ ];
-		uint8_t front, back;
+		uint16_t front, back;
 	} childevq, parentevq;
 
 /* [ARCAN-SET (parent), FSRV-CHECK]
@@ -1046,6 +1124,24 @@ struct arcan_shmif_page {
  */
 	volatile _Atomic uint_least64_t vpts;
 
+/*
+ * [FSRV-SET]
+ * Per video buffer presentation timestamp, set before the buffer is marked
+ * as pending. Buffers with a timestamp past the next display synch are kept
+ * pending, while older ones are dropped in favour of the most recent one
+ * that is due. 0 means present as soon as possible.
+ */
+	volatile _Atomic uint_least64_t vbuf_pts[ARCAN_SHMIF_VBUFC_LIM];
+
+/*
+ * [ARCAN-SET]
+ * When video buffers are passed as persistent handles (one per buffer, see
+ * EVENT_EXTERNAL_BUFFERSTREAM) the server samples the one last presented
+ * until it switches to another. This is that buffer index + 1, 0 if none,
+ * and the client must not draw into it even if its pending bit is clear.
+ */
+	volatile _Atomic uint_least8_t vheld;
+
 /*
  * [ARCAN-SET]
  * Set during segment initalization, provides some identifier to determine
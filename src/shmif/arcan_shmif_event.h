@@ -498,6 +498,11 @@ enum ARCAN_TARGET_COMMAND {
  *              5: reply to a request for privileged device access,
  *                 this is special magic used for bridging DRI2 and will
  *                 weaken security.
+ *              6: synchronization bridge, an eventfd that the client
+ *                 signals after publishing a new audio/video buffer so
+ *                 that the server can multiplex on it when the buffer
+ *                 release uses futexes (see [futex] in the shmpage).
+ *                 Consumed by shmif, never forwarded.
  *
  * Note: for the [1].iv == 2, 4 cases, the remote address (keyid:host:port) may
  * be longer than the permitted message length. In such cases, the code field
@@ -1353,10 +1358,14 @@ enum ARCAN_TARGET_SKIPMODE {
  * terminated, check arcan_shmif_sighandle and corresponding platform code
  * (pitch)  - row width in bytes
  * (format) - color format, also platform specific value
+ * (slot)   - 0, the handle accompanies the next signal and replaces the last.
+ *            n, the handle persistently backs video buffer n-1 and is kept
+ *            until the next set arrives, slot 1 starts a new set.
  */
 		struct{
 			uint32_t pitch;
 			uint32_t format;
+			uint8_t slot;
 		} bstream;
 
 /*
@@ -1579,16 +1588,16 @@ struct arcan_evctx {
 	uint32_t state_fl;
 	int exit_code;
 	void (*drain)(arcan_event*, int);
-	uint8_t eventbuf_sz;
+	uint16_t eventbuf_sz;
 
 	arcan_event* eventbuf;
 
-/* offsets into the eventbuf queue, parent will always % ARCAN_SHMPAGE_QUEUE_SZ
+/* offsets into the eventbuf queue, parent will always % eventbuf_sz
  * to prevent nasty surprises. these were set before we had access to _Atomic
  * in the standard fashion, and the codebase should be refactored to take that
  * into account */
-	volatile uint8_t* volatile front;
-	volatile uint8_t* volatile back;
+	volatile uint16_t* volatile front;
+	volatile uint16_t* volatile back;
 
 	int8_t local;
 
@@ -288,7 +288,9 @@ const char* arcan_shmif_eventstr(arcan_event* aev, char* dbuf, size_t dsz)
 			snprintf(work, dsz,"TGT:BUFFER_FAIL()");
 		break;
 		case TARGET_COMMAND_DEVICE_NODE:
-			if (ev.tgt.ioevs[0].iv == 1)
+			if (ev.tgt.ioevs[1].iv == 6)
+				snprintf(work, dsz,"TGT:DEVICE_NODE(synch-bridge)");
+			else if (ev.tgt.ioevs[0].iv == 1)
 				snprintf(work, dsz,"TGT:DEVICE_NODE(render-node)");
 			else if (ev.tgt.ioevs[0].iv == 2)
 				snprintf(work, dsz,"TGT:DEVICE_NODE(connpath: %s)", ev.tgt.message);
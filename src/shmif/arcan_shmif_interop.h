@@ -41,7 +41,7 @@
  * during _integrity_check
  */
 #define ASHMIF_VERSION_MAJOR 0
-#define ASHMIF_VERSION_MINOR 13
+#define ASHMIF_VERSION_MINOR 18
 
 #ifndef LOG
 #define LOG(X, ...) (fprintf(stderr, "[%lld]" X, arcan_timemillis(), ## __VA_ARGS__))
@@ -69,6 +69,8 @@ file_handle arcan_fetchhandle(int insock, bool block);
 bool arcan_pushhandle(int fd, int channel);
 int arcan_sem_wait(sem_handle sem);
 int arcan_sem_trywait(sem_handle sem);
+int arcan_futex_wait(volatile _Atomic unsigned* addr, unsigned val, unsigned timeout);
+int arcan_futex_wake(volatile _Atomic unsigned* addr);
 int arcan_fdscan(int** listout);
 #endif
 
@@ -200,6 +202,15 @@ int arcan_shmif_enqueue(struct arcan_shmif_cont*,
 int arcan_shmif_tryenqueue(struct arcan_shmif_cont*,
 	const struct arcan_event* const);
 
+/*
+ * Enqueue [n] events in order, copying as many as there is room for at a
+ * time rather than one by one. Blocks like arcan_shmif_enqueue while the
+ * queue is full. Returns the number of events enqueued, which is less than
+ * [n] only if the connection died.
+ */
+size_t arcan_shmif_enqueue_batch(struct arcan_shmif_cont*,
+	const struct arcan_event* const, size_t n);
+
 /*
  * Provide a text representation useful for logging, tracing and debugging
  * purposes. If dbuf is NULL, a static buffer will be used (so for
@@ -381,6 +392,9 @@ pid_t arcan_shmif_handover_exec(
  * For SHMIF_RHINT_SUBREGION, the function returns 0 on success or -1 if the
  * context is dead / broken. You are still required to use shmif_signal calls
  * to synchronize the contents. Only the set of damaged regions will grow.
+ * Up to ARCAN_SHMIF_DAMAGE_LIM regions are forwarded individually, past that
+ * new regions are merged with the one that grows the least, and cont->dirty
+ * tracks the bounding box of them all.
  *
  * [ Not yet implemented ]
  * This interface combines a number of latency and performance sensitive
@@ -46,6 +46,7 @@ struct shmifsrv_client {
 	enum connstatus status;
 	size_t errors;
 	uint64_t cookie;
+	int vmask;
 };
 
 static struct shmifsrv_client* alloc_client()
@@ -57,6 +58,7 @@ static struct shmifsrv_client* alloc_client()
 	*res = (struct shmifsrv_client){};
 	res->status = BROKEN;
 	res->cookie = arcan_shmif_cookie();
+	res->vmask = ~0;
 
 	return res;
 }
@@ -186,17 +188,20 @@ size_t shmifsrv_dequeue_events(
 
 	if (shmifsrv_enter(cl)){
 		size_t count = 0;
-		uint8_t front = cl->con->shm.ptr->parentevq.front;
-		uint8_t back = cl->con->shm.ptr->parentevq.back;
-		if (front > PP_QUEUE_SZ || back > PP_QUEUE_SZ){
+/* ring size comes from our side of the connection, not from the page */
+		uint16_t qsz = cl->con->inqueue.eventbuf_sz;
+		uint16_t front = cl->con->shm.ptr->parentevq.front;
+		uint16_t back = cl->con->shm.ptr->parentevq.back;
+		struct arcan_event* evq = cl->con->inqueue.eventbuf;
+		if (front >= qsz || back >= qsz){
 			cl->errors++;
 			shmifsrv_leave();
 			return 0;
 		}
 
 		while (count < limit && front != back){
-			newev[count++] = cl->con->shm.ptr->parentevq.evqueue[front];
-			front = (front + 1) % PP_QUEUE_SZ;
+			newev[count++] = evq[front];
+			front = (front + 1) % qsz;
 		}
 		asm volatile("": : :"memory");
 		__sync_synchronize();
@@ -291,7 +296,8 @@ int shmifsrv_poll(struct shmifsrv_client* cl)
 /* check if resynch, else check if aready or vready */
 		if (shmifsrv_enter(cl)){
 			if (cl->con->shm.ptr->resized){
-				if (-1 == platform_fsrv_resynch(cl->con)){
+				if (-1 == platform_fsrv_resynch(cl->con,
+					atomic_load(&cl->con->shm.ptr->hints))){
 					cl->status = BROKEN;
 					shmifsrv_leave();
 					return CLIENT_DEAD;
@@ -361,9 +367,13 @@ void shmifsrv_client_protomask(struct shmifsrv_client* cl, unsigned mask)
 
 void shmifsrv_video_step(struct shmifsrv_client* cl)
 {
-/* signal that we're done with the buffer */
-	atomic_store_explicit(&cl->con->shm.ptr->vready, 0, memory_order_release);
-	arcan_sem_post(cl->con->vsync);
+/* signal that we're done with the buffer, vready stays set as long as
+ * there are timestamped buffers queued for later */
+	atomic_fetch_and(&cl->con->shm.ptr->vpending, cl->vmask);
+	cl->vmask = ~0;
+	if (!atomic_load(&cl->con->shm.ptr->vpending))
+		atomic_store_explicit(&cl->con->shm.ptr->vready, 0, memory_order_release);
+	platform_fsrv_wake(cl->con, SHMIF_SIGVID);
 
 /* If the frameserver has indicated that it wants a frame callback every time
  * we consume. This is primarily for cases where a client needs to I/O mplex
@@ -405,18 +415,39 @@ struct shmifsrv_vbuffer shmifsrv_video(struct shmifsrv_client* cl)
 	res.stride = res.w * ARCAN_SHMPAGE_VCHANNELS;
 	res.pitch = res.w;
 
-/* vpending contains the latest region that was synched, so extract the ~vready
- * mask to figure out which is the most recent buffer to work with in the case
- * of 'n' buffering */
-	int vready = atomic_load_explicit(
-		&cl->con->shm.ptr->vready, memory_order_consume);
-	vready = (vready <= 0 || vready > cl->con->vbuf_cnt) ? 0 : vready - 1;
+/* there is no display to synch against here, so buffers are due when their
+ * timestamp has passed, the release happens in video_step */
+	uint64_t vpts;
+	bool latest;
+	int vready = platform_fsrv_vbuf_select(
+		cl->con, arcan_timemillis(), &cl->vmask, &vpts, &latest);
+	if (-1 == vready){
+		cl->vmask = ~0;
+		return res;
+	}
 
-	int vmask = ~atomic_load_explicit(
-		&cl->con->shm.ptr->vpending, memory_order_consume);
+	if (vpts)
+		res.vpts = vpts;
 
+	res.state = VBUFFER_OKDATA;
 	res.buffer = cl->con->vbufs[vready];
+
+/* the region and damage describe the last signal, an older pick or dropped
+ * buffers mean that the whole surface has to be treated as changed */
+	if (!latest){
+		res.flags.subregion = false;
+		res.region = (struct arcan_shmif_region){.x2 = res.w, .y2 = res.h};
+		return res;
+	}
+
 	res.region = atomic_load(&cl->con->shm.ptr->dirty);
+	struct arcan_shmif_damage* dmg = arcan_shmif_damagebuf(
+		res.buffer, cl->con->desc.hints, res.w, res.h);
+	if (dmg){
+		res.damage = *dmg;
+		if (res.damage.count > ARCAN_SHMIF_DAMAGE_LIM)
+			res.damage.count = 0;
+	}
 
 	return res;
 }
@@ -481,7 +512,7 @@ bool shmifsrv_audio(struct shmifsrv_client* cl,
 /* not readyy but signaled */
 	if (0 == amask || ((1 << ind) & amask) == 0){
 		atomic_store_explicit(&src->aready, 0, memory_order_release);
-		arcan_sem_post(cl->con->async);
+		platform_fsrv_wake(cl->con, SHMIF_SIGAUD);
 		return true;
 	}
 
@@ -508,7 +539,7 @@ bool shmifsrv_audio(struct shmifsrv_client* cl,
 
 /* and release the client */
 	atomic_store_explicit(&src->aready, 0, memory_order_release);
-	arcan_sem_post(cl->con->async);
+	platform_fsrv_wake(cl->con, SHMIF_SIGAUD);
 	return true;
 }
 
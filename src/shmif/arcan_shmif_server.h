@@ -294,6 +294,10 @@ struct shmifsrv_vbuffer {
 /* only usedated with subregion : true */
 	struct arcan_shmif_region region;
 
+/* only used with subregion : true, the individual regions within [region],
+ * count is 0 if only the bounding region is known */
+	struct arcan_shmif_damage damage;
+
 /* only used with hwhandles : true */
 	size_t formats[4];
 	int planes[4];
@@ -308,7 +312,7 @@ struct shmifsrv_vbuffer {
  *
  * The [state] field of the returned structure will match vbuffer_status:
  * VBUFFER_OUTPUT - segment is configured for output, don't use this function.
- * VBUFFER_NODATA - nothing available.
+ * VBUFFER_NODATA - nothing available, or all buffers are queued for later.
  * VBUFFER_OKDATA - buffer is updated.
  * VBUFFER_HANDLE - accelerated opaque handle, descriptor field set.
  *
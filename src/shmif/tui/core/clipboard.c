@@ -42,6 +42,10 @@ bool tui_push_message(struct arcan_shmif_cont* acon,
 	const char* outs = msg;
 	size_t maxlen = sizeof(base->ext.message.data) - 1;
 
+/* large pastes turn into many multipart messages, forward them in batches */
+	struct arcan_event batch[32];
+	size_t n_batch = 0;
+
 /* utf8- point aligned against block size */
 	while (len > maxlen){
 		size_t i, lastok = 0;
@@ -51,8 +55,11 @@ bool tui_push_message(struct arcan_shmif_cont* acon,
 				lastok = i;
 
 			if (i != lastok){
-				if (0 == i)
+				if (0 == i){
+					if (n_batch)
+						arcan_shmif_enqueue_batch(acon, batch, n_batch);
 					return false;
+				}
 			}
 		}
 
@@ -65,16 +72,23 @@ bool tui_push_message(struct arcan_shmif_cont* acon,
 		else
 			base->ext.message.multipart = 0;
 
-		arcan_shmif_enqueue(acon, base);
+		batch[n_batch++] = *base;
+		if (n_batch == sizeof(batch) / sizeof(batch[0])){
+			arcan_shmif_enqueue_batch(acon, batch, n_batch);
+			n_batch = 0;
+		}
 	}
 
 /* flush remaining */
 	if (len){
 		snprintf((char*)base->ext.message.data, maxlen, "%s", outs);
 		base->ext.message.multipart = 0;
-		arcan_shmif_enqueue(acon, base);
+		batch[n_batch++] = *base;
 	}
 
+	if (n_batch)
+		arcan_shmif_enqueue_batch(acon, batch, n_batch);
+
 	return true;
 }
 
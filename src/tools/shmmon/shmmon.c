@@ -97,7 +97,38 @@ static void decode_apad(void* apad, size_t apad_sz)
 	}
 }
 
-static void dump_snapshot(struct arcan_shmif_page* page, int qlim)
+static void dump_queue(
+	struct arcan_event* evq, int qlim, uint16_t front, uint16_t back)
+{
+	if (front >= qlim || back >= qlim){
+		printf("\t[broken indices: %d, %d]\n", (int) front, (int) back);
+		return;
+	}
+
+	uint16_t cur = front;
+	for (size_t i = 0; i < qlim; i++){
+		char* state = " ";
+		if (cur == front && cur == back)
+			state = "F/B";
+		else if (cur == front)
+			state = "F";
+		else if (cur == back)
+			state = "B";
+
+		if (evq[cur].category == 0)
+			continue;
+
+		printf("%s\t[%d] ", state, (int) cur);
+		dump_event(evq[cur]);
+		if (cur == 0)
+			cur = qlim - 1;
+		else
+			cur--;
+	}
+}
+
+static void dump_snapshot(
+	struct arcan_shmif_page* page, struct arcan_event* evq, int qlim)
 {
 	printf("version: %"PRIu8", %"PRIu8"\ncookie: %s\n",
 		page->major, page->minor, arcan_shmif_cookie() == page->cookie ? "match" : "fail");
@@ -139,49 +170,11 @@ static void dump_snapshot(struct arcan_shmif_page* page, int qlim)
 	if (page->hints & SHMIF_RHINT_AUTH_TOK)
 		printf("auth-token ");
 
-	printf("\nqueue(in):\n");
-	uint8_t cur = page->childevq.front;
-	for (size_t i = 0; i < qlim; i++){
-		char* state = " ";
-		if (cur == page->childevq.front && cur == page->childevq.back)
-			state = "F/B";
-		else if (cur == page->childevq.front)
-			state = "F";
-		else if (cur == page->childevq.back)
-			state = "B";
-
-		if (page->childevq.evqueue[cur].category == 0)
-			continue;
-
-		printf("%s\t[%d] ", state, (int) cur);
-		dump_event(page->childevq.evqueue[cur]);
-		if (cur == 0)
-			cur = PP_QUEUE_SZ - 1;
-		else
-			cur--;
-	}
-
-	cur = page->parentevq.front;
-	printf("queue(out):\n");
-	for (size_t i = 0; i < qlim; i++){
-		char* state = " ";
-		if (cur == page->parentevq.front && cur == page->parentevq.back)
-			state = "F/B";
-		else if (cur == page->parentevq.front)
-			state = "F";
-		else if (cur == page->parentevq.back)
-			state = "B";
+	printf("\nqueue(in, %d):\n", qlim);
+	dump_queue(evq, qlim, page->childevq.front, page->childevq.back);
 
-		if (page->childevq.evqueue[cur].category == 0)
-			continue;
-
-		printf("%s\t[%d] ", state, (int) cur);
-		dump_event(page->parentevq.evqueue[cur]);
-		if (cur == 0)
-			cur = PP_QUEUE_SZ - 1;
-		else
-			cur--;
-	}
+	printf("queue(out, %d):\n", qlim);
+	dump_queue(&evq[qlim], qlim, page->parentevq.front, page->parentevq.back);
 
 	printf("\nlast words: %s\n", page->last_words);
 	printf("aux- protocols (size: %zu):\n\t", (size_t) page->apad);
@@ -259,13 +252,33 @@ int main(int argc, char** argv)
 	}
 	addr_sz = sizeof(struct arcan_shmif_page);
 
-/* first dumb dump, just make a copy of the contents and output */
+/* the event rings follow the page, so remap to cover those as well once we
+ * know how large they are */
 	struct arcan_shmif_page base;
 	memcpy(&base, addr, sizeof(base));
-	dump_snapshot(&base, PP_QUEUE_SZ);
+	munmap(addr, addr_sz);
+
+	size_t qsz = base.evqueue_sz;
+	if (!qsz || qsz > PP_QUEUE_MAX || (qsz & (qsz - 1))){
+		fprintf(stderr, "invalid event queue size (%zu)\n", qsz);
+		qsz = 0;
+	}
+
+	addr_sz = sizeof(struct arcan_shmif_page) + 2 * qsz * sizeof(struct arcan_event);
+	addr = mmap(NULL, addr_sz, PROT_READ, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED){
+		fprintf(stderr, "couldn't map event queues\n");
+		return EXIT_FAILURE;
+	}
+
+/* first dumb dump, just make a copy of the contents and output */
+	static struct arcan_event evq[2 * PP_QUEUE_MAX];
+	memcpy(evq, arcan_shmif_evqueue(addr, qsz, false),
+		2 * qsz * sizeof(struct arcan_event));
+	dump_snapshot(&base, evq, qsz);
 
 /* now we can be more risky, map the entire range */
-	munmap(addr, sizeof(base));
+	munmap(addr, addr_sz);
 	addr = mmap(NULL, base.segment_size, PROT_READ, MAP_SHARED, fd, 0);
 	addr_sz = base.segment_size;
 	if (MAP_FAILED == addr){
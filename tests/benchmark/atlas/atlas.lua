@@ -0,0 +1,34 @@
+--
+-- Small image test,
+-- many separately loaded thumbnails where each object normally gets
+-- its own store and every draw needs a rebind. Run once as is and once
+-- with ARCAN_VIDEO_ATLAS=1 and ARCAN_VIDEO_BATCH=1 set and compare the
+-- draw calls and the frame cost columns. Each step adds 64 objects.
+--
+
+function atlas(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	benchmark = benchmark_create(40, 5, 1, fill_step);
+	benchmark.columns = columns;
+end
+
+function fill_step()
+	for i=1,64 do
+		local img = load_image("images/icons/arcanicon.png", 1, 32, 32);
+		move_image(img, math.random(VRESW - 32), math.random(VRESH - 32));
+		show_image(img);
+	end
+end
+
+function columns()
+	local _, _, _, _, _, cost, draws = benchmark_data();
+	return draws, benchmark_average(cost);
+end
+
+function atlas_clock_pulse()
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
@@ -0,0 +1,41 @@
+--
+-- Culling test,
+-- a growing stack of opaque fullscreen surfaces where only the top one is
+-- visible, and as many small objects placed outside of the screen. Run
+-- once with ARCAN_VIDEO_NOCULL=1, once as is and once with
+-- ARCAN_VIDEO_OCCLUSION=1 set and compare the frame cost and the culled
+-- and occluded columns.
+--
+
+function cull(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	benchmark = benchmark_create(40, 5, 4, fill_step);
+	benchmark.columns = columns;
+end
+
+function fill_step()
+	local a = color_surface(VRESW, VRESH,
+		math.random(255), math.random(255), math.random(255));
+	show_image(a);
+
+	local b = color_surface(32, 32, 255, 255, 255);
+	move_image(b, VRESW + math.random(VRESW), math.random(VRESH));
+	show_image(b);
+	link_image(b, a);
+	image_inherit_order(b, true);
+
+	return a;
+end
+
+function columns()
+	local _, _, _, _, _, cost, _, culled, occluded = benchmark_data();
+	return benchmark_average(cost), culled, occluded;
+end
+
+function cull_clock_pulse()
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
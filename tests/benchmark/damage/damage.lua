@@ -0,0 +1,38 @@
+--
+-- Partial redraw test,
+-- layers of static fullscreen surfaces with one small object that
+-- moves every tick, so only a fraction of the screen changes per frame.
+-- Run once as is and once with ARCAN_VIDEO_DAMAGE=1 set and compare
+-- the frame cost columns.
+--
+
+function damage(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	benchmark = benchmark_create(40, 5, 4, fill_step);
+	benchmark.columns = columns;
+
+	marker = color_surface(32, 32, 255, 255, 255);
+	order_image(marker, 65535);
+	show_image(marker);
+end
+
+function fill_step()
+	local a = color_surface(VRESW, VRESH,
+		math.random(255), math.random(255), math.random(255));
+	blend_image(a, 0.5);
+	return a;
+end
+
+function columns()
+	local _, _, _, _, _, cost = benchmark_data();
+	return benchmark_average(cost);
+end
+
+function damage_clock_pulse()
+	move_image(marker, math.random(VRESW - 32), math.random(VRESH - 32));
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
@@ -0,0 +1,38 @@
+--
+-- Draw submission test,
+-- many small objects that share the same store and blend state, so
+-- the CPU cost is dominated by per-object draw calls. Run once as is
+-- and once with ARCAN_VIDEO_BATCH=1 set and compare the draw calls
+-- and the frame cost columns. Each step adds 64 objects.
+--
+
+function drawbatch(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	tile = fill_surface(32, 32, math.random(255),
+		math.random(255), math.random(255));
+
+	benchmark = benchmark_create(40, 5, 1, fill_step);
+	benchmark.columns = columns;
+end
+
+function fill_step()
+	for i=1,64 do
+		local img = null_surface(16, 16);
+		image_sharestorage(tile, img);
+		move_image(img, math.random(VRESW - 16), math.random(VRESH - 16));
+		show_image(img);
+	end
+end
+
+function columns()
+	local _, _, _, _, _, cost, draws = benchmark_data();
+	return draws, benchmark_average(cost);
+end
+
+function drawbatch_clock_pulse()
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
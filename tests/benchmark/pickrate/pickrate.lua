@@ -0,0 +1,46 @@
+--
+-- Picking test,
+-- a growing number of small static objects and a fixed batch of
+-- pick_items calls at random coordinates every tick. Run once as is
+-- and once with ARCAN_VIDEO_PICKINDEX=1 set and compare the pick cost
+-- column (microseconds per call).
+--
+
+function pickrate(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	benchmark = benchmark_create(40, 5, 500, fill_step);
+	benchmark.columns = columns;
+
+	pick_sum = 0;
+	pick_count = 0;
+end
+
+function fill_step()
+	local a = color_surface(16, 16,
+		math.random(255), math.random(255), math.random(255));
+	move_image(a, math.random(VRESW - 16), math.random(VRESH - 16));
+	show_image(a);
+	return a;
+end
+
+function columns()
+	local res = pick_sum / math.max(pick_count, 1);
+	pick_sum = 0;
+	pick_count = 0;
+	return res;
+end
+
+function pickrate_clock_pulse()
+	local ts = benchmark_timestamp(-1);
+	for i=1,100 do
+		pick_items(math.random(VRESW), math.random(VRESH), 8, i % 2 == 0);
+	end
+	pick_sum = pick_sum + (benchmark_timestamp(-1) - ts);
+	pick_count = pick_count + 100;
+
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
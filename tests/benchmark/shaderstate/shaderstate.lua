@@ -0,0 +1,55 @@
+--
+-- Shader state test,
+-- a growing number of objects that share one store and alternate between
+-- the default shader and a custom one. Compare the program, texture and
+-- uniform columns (state changes sent) with the skipped column (redundant
+-- state changes that were dropped).
+--
+
+function shaderstate(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	benchmark = benchmark_create(40, 5, 4, fill_step);
+	benchmark.columns = columns;
+
+	source = fill_surface(64, 64, 255, 0, 0);
+	tint = build_shader(nil, [[
+uniform sampler2D map_tu0;
+uniform float obj_opacity;
+varying vec2 texco;
+
+void main()
+{
+	vec4 col = texture2D(map_tu0, texco);
+	gl_FragColor = vec4(col.g, col.b, col.r, obj_opacity);
+}
+]], "tint");
+	counter = 0;
+end
+
+function fill_step()
+	local a = null_surface(64, 64);
+	image_sharestorage(source, a);
+	move_image(a, math.random(VRESW - 64), math.random(VRESH - 64));
+	show_image(a);
+
+	counter = counter + 1;
+	if (counter % 2 == 0) then
+		image_shader(a, tint);
+	end
+
+	return a;
+end
+
+function columns()
+	local _, _, _, _, _, cost, _, _, _,
+		programs, textures, uniforms, skipped = benchmark_data();
+	return benchmark_average(cost), programs, textures, uniforms, skipped;
+end
+
+function shaderstate_clock_pulse()
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
@@ -2,6 +2,9 @@
 -- Hierarchical depth test
 -- Should draw a line of random corners going from top diagonal
 -- line and down. Moving around to prevent caching.
+-- Run once as is and once with ARCAN_VIDEO_NOFRAMECACHE=1 set to compare
+-- against resolving the full parent chain for each object. The count is
+-- the depth of the hierarchy and the extra column the average frame cost.
 --
 --
 
@@ -20,6 +23,12 @@ function thierarch(arguments)
 	prev = root;
 
 	benchmark = benchmark_create(200, 5, 1, fill_step, true);
+	benchmark.columns = columns;
+end
+
+function columns()
+	local _, _, _, _, _, cost = benchmark_data();
+	return benchmark_average(cost);
 end
 
 function fill_step()
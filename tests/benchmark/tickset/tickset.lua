@@ -0,0 +1,42 @@
+--
+-- Tick cost test,
+-- a growing number of static objects and a small fixed set of animated
+-- ones, the tick cost should follow the animated set rather than the
+-- scene size. Run once as is and once with ARCAN_VIDEO_TICKALL=1 set
+-- and compare the tick cost column.
+--
+
+function tickset(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	benchmark = benchmark_create(40, 5, 500, fill_step);
+	benchmark.columns = columns;
+
+	for i=1,32 do
+		local a = color_surface(8, 8, 255, 255, 255);
+		show_image(a);
+		move_image(a, math.random(VRESW), math.random(VRESH), 100);
+		move_image(a, 0, 0, 100);
+		image_transform_cycle(a, 1);
+	end
+end
+
+function fill_step()
+	local a = color_surface(4, 4,
+		math.random(255), math.random(255), math.random(255));
+	move_image(a, math.random(VRESW), math.random(VRESH));
+	show_image(a);
+	return a;
+end
+
+function columns()
+	local _, tick = benchmark_data();
+	return benchmark_average(tick);
+end
+
+function tickset_clock_pulse()
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
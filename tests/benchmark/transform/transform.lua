@@ -1,6 +1,8 @@
 --
--- Simple Fillrate test,
--- primarily GPU- related memory writes
+-- Transformation test,
+-- many objects with long chains of ongoing transformations. Run once as is
+-- and once with ARCAN_VIDEO_TRANSFORM_BATCH=1 set and compare the tick cost
+-- column.
 --
 
 function transform(arguments)
@@ -8,6 +10,12 @@ function transform(arguments)
 
 	benchmark_setup( arguments[1] );
 	benchmark = benchmark_create(20, 5, 10, fill_step);
+	benchmark.columns = columns;
+end
+
+function columns()
+	local _, tick = benchmark_data();
+	return benchmark_average(tick);
 end
 
 function fill_step()
@@ -0,0 +1,69 @@
+--
+-- Client upload test,
+-- a growing number of avfeed clients that are all asked for a new frame
+-- every tick, so the cost of polling and transferring client frames grows
+-- with the client count. Run once for each thread count to compare, e.g.
+-- ARCAN_CONDUCTOR_WORKERS=0, 2 and 4, and compare the client count, the
+-- transfer cost (ms per frame) and the worker columns.
+--
+
+function uploadscale(arguments)
+	system_load("scripts/benchmark.lua")();
+
+	benchmark_setup( arguments[1] );
+	clients = {};
+	xpos = 0;
+	ypos = 0;
+
+	benchmark = benchmark_create(40, 5, 1, fill_step);
+	benchmark.columns = columns;
+end
+
+function fill_step()
+	local vid = launch_avfeed("", "avfeed",
+		function(source, status)
+			if (status.kind == "resized") then
+				resize_image(source, 32, 32);
+				show_image(source);
+			elseif (status.kind == "terminated") then
+				delete_image(source);
+			end
+		end
+	);
+
+	if (not valid_vid(vid)) then
+		return;
+	end
+
+	move_image(vid, xpos, ypos);
+	xpos = xpos + 32;
+	if (xpos > VRESW - 32) then
+		xpos = 0;
+		ypos = ypos + 32;
+		if (ypos > VRESH - 32) then
+			ypos = 0;
+		end
+	end
+
+	table.insert(clients, vid);
+	return vid;
+end
+
+function columns()
+	local transfer, workers = select(14, benchmark_data());
+	return #clients, transfer, workers;
+end
+
+function uploadscale_clock_pulse()
+	for i=#clients,1,-1 do
+		if (valid_vid(clients[i], TYPE_FRAMESERVER)) then
+			stepframe_target(clients[i]);
+		else
+			table.remove(clients, i);
+		end
+	end
+
+	if (not benchmark:tick()) then
+		return shutdown();
+	end
+end
@@ -0,0 +1,142 @@
+/*
+ * Microbenchmark for the client-to-server frame handoff. A child process
+ * connects as a normal client and measures the time spent in a blocking
+ * arcan_shmif_signal, i.e. from the buffer being marked as ready until the
+ * server has picked it up and released it again. The server side spins on
+ * shmifsrv_poll so that the number is dominated by the synchronization
+ * primitives rather than by server scheduling.
+ *
+ * Run once as is (futex synch where supported) and once with
+ * ARCAN_SHMIF_SEMAPHORES=1 set to compare against the semaphore path.
+ */
+#include <arcan_shmif.h>
+#include <arcan_shmif_server.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/wait.h>
+
+static long long time_us()
+{
+	struct timespec tp;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &tp);
+	return (tp.tv_sec * 1000000) + (tp.tv_nsec / 1000);
+}
+
+static int cmp_ll(const void* a, const void* b)
+{
+	long long x = *(const long long*) a;
+	long long y = *(const long long*) b;
+	return x < y ? -1 : x > y;
+}
+
+static int run_client(size_t n)
+{
+	setenv("ARCAN_CONNPATH", "synchlat", 1);
+	struct arcan_shmif_cont cont = arcan_shmif_open(
+		SEGID_APPLICATION, SHMIF_ACQUIRE_FATALFAIL, NULL);
+
+	if (!arcan_shmif_resize(&cont, 64, 64)){
+		fprintf(stderr, "couldn't set buffer properties\n");
+		return EXIT_FAILURE;
+	}
+
+	long long* samples = malloc(sizeof(long long) * n);
+	if (!samples)
+		return EXIT_FAILURE;
+
+	for (size_t i = 0; i < n; i++){
+		shmif_pixel col = SHMIF_RGBA(i % 256, 0, 0, 0xff);
+		for (size_t j = 0; j < cont.pitch * cont.h; j++)
+			cont.vidp[j] = col;
+
+		long long start = time_us();
+		arcan_shmif_signal(&cont, SHMIF_SIGVID);
+		samples[i] = time_us() - start;
+
+		arcan_event ev;
+		while (arcan_shmif_poll(&cont, &ev) > 0){}
+	}
+
+	qsort(samples, n, sizeof(long long), cmp_ll);
+	long long sum = 0;
+	for (size_t i = 0; i < n; i++)
+		sum += samples[i];
+
+	printf("synch: %s, frames: %zu, (us) min: %lld, avg: %lld, "
+		"p50: %lld, p95: %lld, p99: %lld, max: %lld\n",
+		cont.addr->futex ? "futex" : "semaphore", n,
+		samples[0], sum / (long long) n, samples[n / 2],
+		samples[(n * 95) / 100], samples[(n * 99) / 100], samples[n - 1]
+	);
+
+	free(samples);
+	arcan_shmif_drop(&cont);
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+	size_t n = 10000;
+	if (argc > 1)
+		n = strtoul(argv[1], NULL, 10);
+
+	if (!n){
+		fprintf(stderr, "usage: \n\tsynchlat [n_frames (10000)]\n");
+		return EXIT_FAILURE;
+	}
+
+	struct shmifsrv_client* cl =
+		shmifsrv_allocate_connpoint("synchlat", NULL, S_IRWXU, -1);
+
+	if (!cl){
+		fprintf(stderr, "couldn't allocate connection point\n");
+		return EXIT_FAILURE;
+	}
+
+	pid_t child = fork();
+	if (child == 0)
+		return run_client(n);
+	else if (child == -1){
+		fprintf(stderr, "couldn't spawn client\n");
+		return EXIT_FAILURE;
+	}
+
+	shmifsrv_monotonic_rebase();
+	int status;
+
+	while (waitpid(child, &status, WNOHANG) != child){
+		int sv;
+		while ((sv = shmifsrv_poll(cl)) != CLIENT_NOT_READY){
+			if (sv == CLIENT_DEAD)
+				goto out;
+			else if (sv == CLIENT_VBUFFER_READY)
+				shmifsrv_video_step(cl);
+			else if (sv == CLIENT_ABUFFER_READY)
+				shmifsrv_audio(cl, NULL, NULL);
+		}
+
+		struct arcan_event ev;
+		while (1 == shmifsrv_dequeue_events(cl, &ev, 1)){
+			if (ev.ext.kind == EVENT_EXTERNAL_REGISTER){
+				shmifsrv_enqueue_event(cl, &(struct arcan_event){
+					.category = EVENT_TARGET,
+					.tgt.kind = TARGET_COMMAND_ACTIVATE
+				}, -1);
+			}
+			else
+				shmifsrv_process_event(cl, &ev);
+		}
+
+		int ticks = shmifsrv_monotonic_tick(NULL);
+		while(ticks--)
+			shmifsrv_tick(cl);
+
+		sched_yield();
+	}
+
+out:
+	shmifsrv_free(cl, SHMIFSRV_FREE_FULL);
+	return EXIT_SUCCESS;
+}